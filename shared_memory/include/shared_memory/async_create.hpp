@@ -0,0 +1,122 @@
+/**************************************************************
+ * @file async_create.hpp
+ * @brief Background creation and population of POSIX shared
+ * memory segments.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#pragma once
+
+#if !defined(__linux__)
+#error "shared_memory is only supported on Linux"
+#endif
+
+#include <chrono>
+#include <cstddef>
+#include <expected>
+#include <future>
+#include <utility>
+
+#include "shared_memory/error.hpp"
+#include "shared_memory/segment_name.hpp"
+#include "shared_memory/shared_memory.hpp"
+
+namespace shared_memory {
+
+/**
+ * @brief Handle to a segment that is being created on a background thread.
+ *
+ * Returned by create_async(). The result can be polled with ready() or
+ * collected with get(), which blocks until creation has finished.
+ * Dropping a handle whose result was never taken never blocks: the
+ * background thread releases the segment once it is created, unlinking it if
+ * create_options::should_unlink is set.
+ * Non-copyable but supports move semantics.
+ */
+class pending_segment {
+public:
+    /** @brief Constructs an empty handle that refers to no creation. */
+    pending_segment() noexcept = default;
+
+    /**
+     * @brief Wraps the future produced by the background creation.
+     * @param result Future that receives the creation outcome.
+     */
+    explicit pending_segment(std::future<std::expected<shared_memory, error>> result) noexcept
+    : _result(std::move(result))
+    {}
+
+    /**
+     * @brief Checks whether this handle refers to a creation whose result was not yet taken.
+     * @return true until get() has been called.
+     */
+    [[nodiscard]] bool
+    valid() const noexcept { return _result.valid(); }
+
+    /**
+     * @brief Checks, without blocking, whether the segment has been created and populated.
+     * @return true if get() would return immediately.
+     */
+    [[nodiscard]] bool
+    ready() const { return _result.valid() && _result.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }
+
+    /** @brief Blocks until the background creation has finished. */
+    void
+    wait() const { _result.wait(); }
+
+    /**
+     * @brief Blocks until creation has finished and takes the result.
+     * @return The shared_memory object, or the error the creation failed with.
+     */
+    [[nodiscard]] std::expected<shared_memory, error>
+    get() { return _result.get(); }
+
+private:
+    std::future<std::expected<shared_memory, error>> _result{};
+};
+
+/**
+ * @brief Creates and populates a segment on a background thread.
+ *
+ * Truncation, mapping and (with create_options::prefault) page population run
+ * off the calling thread. If no thread can be started, the creation runs
+ * inline and the returned handle is already ready.
+ * @param shm_name The name of the segment (leading slash is optional).
+ * @param size The size of the segment in bytes.
+ * @param options Access mode, unlink and population settings.
+ * @return A handle that yields the shared_memory object once ready.
+ */
+[[nodiscard]] pending_segment
+create_async(const segment_name& shm_name, const std::size_t size, const create_options& options = {});
+
+} // namespace shared_memory
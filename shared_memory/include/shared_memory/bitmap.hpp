@@ -0,0 +1,205 @@
+/**************************************************************
+ * @file bitmap.hpp
+ * @brief Segment-resident hierarchical bitmap for slot allocation
+ * and presence sets.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#pragma once
+
+#if !defined(__linux__)
+#error "shared_memory is only supported on Linux"
+#endif
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <span>
+
+#include "shared_memory/cache_line.hpp"
+#include "shared_memory/error.hpp"
+
+namespace shared_memory {
+
+/**
+ * @brief Fixed-size bitmap stored in a region, with two summary levels for fast searches.
+ *
+ * Each 64-bit leaf word is summarized by one bit in a first-level word, and
+ * each first-level word by one bit in a second-level word, once for "has a
+ * set bit" and once for "has a clear bit". Searches walk the summaries with
+ * count-trailing-zeros, so finding a free slot among millions touches only a
+ * few words. All operations are lock-free and safe across processes; summary
+ * bits are hints that are rechecked after every transition, so they never
+ * hide a bit once concurrent updates settle. The object only holds pointers
+ * into the region, which must outlive it.
+ */
+class hierarchical_bitmap {
+public:
+    /** @brief Value of the header magic in a formatted region. */
+    static constexpr std::uint64_t MAGIC{0x4849'4249'544d'4150};  // "HIBITMAP"
+
+    /** @brief Bits per leaf and summary word. */
+    static constexpr std::size_t WORD_BITS{64};
+
+    /** @brief Constructs a bitmap bound to no region. */
+    hierarchical_bitmap() noexcept = default;
+
+    /**
+     * @brief Returns the region size needed for @p bits bits.
+     * @param bits Number of bits.
+     * @return Bytes required.
+     */
+    [[nodiscard]] static std::size_t
+    required_size(const std::size_t bits) noexcept;
+
+    /**
+     * @brief Formats @p region as a bitmap with every bit clear.
+     * @param region Cache-line-aligned memory of at least required_size() bytes.
+     * @param bits Number of bits (at least 1).
+     * @return The bitmap, or layout_mismatch (ENOSPC if the region is too
+     * small, EINVAL for a misaligned region or zero bits).
+     */
+    [[nodiscard]] static std::expected<hierarchical_bitmap, error>
+    create(std::span<std::byte> region, const std::size_t bits) noexcept;
+
+    /**
+     * @brief Binds to a region formatted by create(), possibly in another process.
+     * @param region The formatted memory.
+     * @return The bitmap, or layout_mismatch (EPROTO) if the region holds no bitmap.
+     */
+    [[nodiscard]] static std::expected<hierarchical_bitmap, error>
+    attach(std::span<std::byte> region) noexcept;
+
+    /**
+     * @brief Sets bit @p index.
+     * @param index Bit index, less than size().
+     * @return The previous value of the bit.
+     */
+    bool
+    set(const std::size_t index) noexcept;
+
+    /**
+     * @brief Clears bit @p index.
+     * @param index Bit index, less than size().
+     * @return The previous value of the bit.
+     */
+    bool
+    clear(const std::size_t index) noexcept;
+
+    /**
+     * @brief Reads bit @p index.
+     * @param index Bit index, less than size().
+     * @return The value of the bit.
+     */
+    [[nodiscard]] bool
+    test(const std::size_t index) const noexcept;
+
+    /**
+     * @brief Finds the first set bit at or after @p from.
+     * @param from Index to start searching from.
+     * @return The index, or std::nullopt if no later bit is set.
+     */
+    [[nodiscard]] std::optional<std::size_t>
+    find_first_set(const std::size_t from = 0) const noexcept;
+
+    /**
+     * @brief Finds the first clear bit at or after @p from.
+     * @param from Index to start searching from.
+     * @return The index, or std::nullopt if no later bit is clear.
+     */
+    [[nodiscard]] std::optional<std::size_t>
+    find_first_clear(const std::size_t from = 0) const noexcept;
+
+    /**
+     * @brief Atomically claims the lowest clear bit.
+     *
+     * Searches the summaries only, so under heavy concurrent set() and
+     * release() traffic it may report ENOSPC while a just-released bit is
+     * still being republished.
+     * @return The claimed index, or allocate_failed (ENOSPC) if every bit is set.
+     */
+    [[nodiscard]] std::expected<std::size_t, error>
+    acquire() noexcept;
+
+    /**
+     * @brief Returns a bit claimed by acquire().
+     * @param index The claimed index.
+     * @return true if the bit was set.
+     */
+    bool
+    release(const std::size_t index) noexcept { return clear(index); }
+
+    /**
+     * @brief Returns the number of bits.
+     * @return The bit count.
+     */
+    [[nodiscard]] std::size_t
+    size() const noexcept { return _bits; }
+
+private:
+    struct bitmap_header;
+
+    struct summary {
+        std::atomic<std::uint64_t> *first{nullptr};
+        std::atomic<std::uint64_t> *second{nullptr};
+    };
+
+    hierarchical_bitmap(std::span<std::byte> region, bitmap_header *header) noexcept;
+
+    [[nodiscard]] std::uint64_t
+    _candidates(const std::size_t word, const bool want_set) const noexcept;
+
+    [[nodiscard]] std::optional<std::size_t>
+    _search(const summary& tree, const bool want_set, const std::size_t from) const noexcept;
+
+    [[nodiscard]] std::optional<std::size_t>
+    _descend(const bool want_set, const std::size_t first_index, std::uint64_t mask) const noexcept;
+
+    void
+    _raise(const summary& tree, const std::size_t word) noexcept;
+
+    void
+    _lower(const summary& tree, const std::size_t word, const bool want_set) noexcept;
+
+private:
+    std::atomic<std::uint64_t> *_words{nullptr};
+    summary _has_set{};
+    summary _has_clear{};
+    std::size_t _bits{0};
+    std::size_t _word_count{0};
+    std::size_t _second_count{0};
+};
+
+} // namespace shared_memory
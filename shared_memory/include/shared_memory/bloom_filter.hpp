@@ -0,0 +1,171 @@
+/**************************************************************
+ * @file bloom_filter.hpp
+ * @brief Segment-resident split-block Bloom filter.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#pragma once
+
+#if !defined(__linux__)
+#error "shared_memory is only supported on Linux"
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <string_view>
+
+#include "shared_memory/cache_line.hpp"
+#include "shared_memory/error.hpp"
+#include "shared_memory/hash.hpp"
+
+namespace shared_memory {
+
+/**
+ * @brief Bloom filter stored in a region and shared by every process mapping it.
+ *
+ * Uses the split-block layout: each key selects one 256-bit block and sets
+ * one bit in each of its eight 32-bit words, so a probe reads a single
+ * 32-byte block that never straddles a cache line. The eight bit masks are
+ * computed with independent multiplies that the compiler vectorizes.
+ * Inserts use atomic fetch_or and may run concurrently from any number of
+ * processes; lookups never lock. There are no false negatives for keys whose
+ * insert happened before the lookup. The object only holds pointers into the
+ * region, which must outlive it.
+ */
+class bloom_filter {
+public:
+    /** @brief Value of the header magic in a formatted region. */
+    static constexpr std::uint64_t MAGIC{0x424c'4f4f'4d53'4254};  // "BLOOMSBT"
+
+    /** @brief Number of 32-bit words, and bits set per key, in one block. */
+    static constexpr std::size_t BLOCK_WORDS{8};
+
+    /** @brief Size of one block in bytes. */
+    static constexpr std::size_t BLOCK_SIZE{BLOCK_WORDS * sizeof(std::uint32_t)};
+
+    /** @brief Constructs a filter bound to no region. */
+    bloom_filter() noexcept = default;
+
+    /**
+     * @brief Returns the number of blocks for @p items keys at @p bits_per_item.
+     *
+     * Ten bits per key gives roughly a 1% false-positive rate; sixteen gives
+     * roughly 0.1%.
+     * @param items Expected number of distinct keys.
+     * @param bits_per_item Filter bits budgeted per key.
+     * @return Number of blocks (at least 1).
+     */
+    [[nodiscard]] static constexpr std::size_t
+    blocks_for(const std::size_t items, const std::size_t bits_per_item = 10) noexcept
+    {
+        const auto bits = items * bits_per_item;
+        const auto blocks = (bits + BLOCK_SIZE * 8 - 1) / (BLOCK_SIZE * 8);
+        return blocks == 0 ? 1 : blocks;
+    }
+
+    /**
+     * @brief Returns the region size needed for @p block_count blocks.
+     * @param block_count Number of blocks.
+     * @return Bytes required.
+     */
+    [[nodiscard]] static std::size_t
+    required_size(const std::size_t block_count) noexcept;
+
+    /**
+     * @brief Formats @p region as an empty filter.
+     * @param region Cache-line-aligned memory of at least required_size() bytes.
+     * @param block_count Number of blocks, from 1 to 2^32.
+     * @return The filter, or layout_mismatch (ENOSPC if the region is too
+     * small, EINVAL for a misaligned region or a bad block count).
+     */
+    [[nodiscard]] static std::expected<bloom_filter, error>
+    create(std::span<std::byte> region, const std::size_t block_count) noexcept;
+
+    /**
+     * @brief Binds to a region formatted by create(), possibly in another process.
+     * @param region The formatted memory.
+     * @return The filter, or layout_mismatch (EPROTO) if the region holds no filter.
+     */
+    [[nodiscard]] static std::expected<bloom_filter, error>
+    attach(std::span<std::byte> region) noexcept;
+
+    /**
+     * @brief Adds a key given its 64-bit hash.
+     * @param hash A well-mixed hash of the key.
+     */
+    void
+    insert_hash(const std::uint64_t hash) noexcept;
+
+    /**
+     * @brief Tests a key given its 64-bit hash.
+     * @param hash The hash passed to insert_hash().
+     * @return false if the key was definitely never inserted.
+     */
+    [[nodiscard]] bool
+    contains_hash(const std::uint64_t hash) const noexcept;
+
+    /**
+     * @brief Adds @p key, hashed with fnv1a().
+     * @param key The key.
+     */
+    void
+    insert(std::string_view key) noexcept { insert_hash(fnv1a(key)); }
+
+    /**
+     * @brief Tests @p key, hashed with fnv1a().
+     * @param key The key.
+     * @return false if the key was definitely never inserted.
+     */
+    [[nodiscard]] bool
+    contains(std::string_view key) const noexcept { return contains_hash(fnv1a(key)); }
+
+    /**
+     * @brief Returns the number of blocks.
+     * @return The block count.
+     */
+    [[nodiscard]] std::size_t
+    block_count() const noexcept { return _block_count; }
+
+private:
+    struct filter_header;
+
+    bloom_filter(std::span<std::byte> region, filter_header *header) noexcept;
+
+private:
+    std::uint32_t *_words{nullptr};
+    std::size_t _block_count{0};
+};
+
+} // namespace shared_memory
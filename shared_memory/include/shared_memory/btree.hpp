@@ -0,0 +1,215 @@
+/**************************************************************
+ * @file btree.hpp
+ * @brief Segment-resident B+tree ordered index with optimistic,
+ * version-validated reads.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#pragma once
+
+#if !defined(__linux__)
+#error "shared_memory is only supported on Linux"
+#endif
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "shared_memory/cache_line.hpp"
+#include "shared_memory/error.hpp"
+
+namespace shared_memory {
+
+/**
+ * @brief Ordered map from 64-bit keys to 64-bit values stored in a region.
+ *
+ * Nodes are four cache lines long and refer to each other by index, so the
+ * tree is valid at any mapping address. Writers from any process serialize on
+ * a lock stored in the region. Readers never lock: every node carries a
+ * version word that writers make odd while modifying it, and readers validate
+ * the versions of each node they traversed (optimistic lock coupling),
+ * restarting on conflict. Erased entries free their slot but nodes are not
+ * merged or reclaimed. The object only holds pointers into the region, which
+ * must outlive it.
+ */
+class btree {
+public:
+    using key_type = std::uint64_t;
+    using mapped_type = std::uint64_t;
+    using value_type = std::pair<key_type, mapped_type>;
+
+    /** @brief Value of the header magic in a formatted region. */
+    static constexpr std::uint64_t MAGIC{0x4250'5452'4545'3031};  // "BPTREE01"
+
+    /** @brief Size of one node in bytes. */
+    static constexpr std::size_t NODE_SIZE{4 * CACHE_LINE_SIZE};
+
+    /** @brief Maximum number of keys held by one node. */
+    static constexpr std::size_t MAX_KEYS{14};
+
+    /** @brief Constructs an empty tree bound to no region. */
+    btree() noexcept = default;
+
+    /**
+     * @brief Returns the region size needed for @p node_capacity nodes.
+     * @param node_capacity Maximum number of nodes the tree may allocate.
+     * @return Bytes required.
+     */
+    [[nodiscard]] static std::size_t
+    required_size(const std::size_t node_capacity) noexcept;
+
+    /**
+     * @brief Formats @p region as an empty tree.
+     * @param region Cache-line-aligned memory of at least required_size() bytes.
+     * @param node_capacity Maximum number of nodes (at least 1).
+     * @return The tree, or layout_mismatch (ENOSPC if the region is too small,
+     * EINVAL for a misaligned region or a bad capacity).
+     */
+    [[nodiscard]] static std::expected<btree, error>
+    create(std::span<std::byte> region, const std::size_t node_capacity) noexcept;
+
+    /**
+     * @brief Binds to a region formatted by create(), possibly in another process.
+     * @param region The formatted memory.
+     * @return The tree, or layout_mismatch (EPROTO) if the region holds no tree.
+     */
+    [[nodiscard]] static std::expected<btree, error>
+    attach(std::span<std::byte> region) noexcept;
+
+    /**
+     * @brief Inserts @p key or overwrites its value.
+     * @param key The key.
+     * @param value The value to store.
+     * @return true if the key was new, false if an existing value was replaced,
+     * or allocate_failed (ENOSPC) if the node capacity is exhausted.
+     */
+    [[nodiscard]] std::expected<bool, error>
+    insert(const key_type key, const mapped_type value) noexcept;
+
+    /**
+     * @brief Removes @p key.
+     * @param key The key.
+     * @return true if the key was present.
+     */
+    bool
+    erase(const key_type key) noexcept;
+
+    /**
+     * @brief Looks up @p key without taking any lock.
+     * @param key The key.
+     * @return The value, or std::nullopt if absent.
+     */
+    [[nodiscard]] std::optional<mapped_type>
+    find(const key_type key) const noexcept;
+
+    /**
+     * @brief Copies entries with keys in [first, last) in ascending order, without locking.
+     *
+     * Each leaf is copied from a validated snapshot, so the result is ordered
+     * and free of torn entries; entries changed during the scan may or may not
+     * be included.
+     * @param first Smallest key to include.
+     * @param last Key bound (exclusive).
+     * @param out Destination buffer.
+     * @return The number of entries written; fewer than out.size() means the range is exhausted.
+     */
+    [[nodiscard]] std::size_t
+    scan(const key_type first, const key_type last, std::span<value_type> out) const noexcept;
+
+    /**
+     * @brief Calls @p visit for every entry with a key in [first, last), in ascending order.
+     * @param first Smallest key to include.
+     * @param last Key bound (exclusive).
+     * @param visit Callable taking (key, value); iteration stops early if it returns false.
+     */
+    template <typename Visitor>
+        requires std::invocable<Visitor&, key_type, mapped_type>
+    void
+    for_each(key_type first, const key_type last, Visitor visit) const
+    {
+        std::array<value_type, MAX_KEYS * 4> batch{};
+
+        while (first < last) {
+            const std::size_t count = scan(first, last, batch);
+
+            for (std::size_t i = 0; i < count; ++i) {
+                if constexpr (std::same_as<std::invoke_result_t<Visitor&, key_type, mapped_type>, bool>) {
+                    if (!visit(batch[i].first, batch[i].second)) {
+                        return;
+                    }
+                } else {
+                    visit(batch[i].first, batch[i].second);
+                }
+            }
+
+            if (count < batch.size()) {
+                return;
+            }
+            first = batch[count - 1].first + 1;
+        }
+    }
+
+    /**
+     * @brief Returns the number of entries.
+     * @return The entry count.
+     */
+    [[nodiscard]] std::size_t
+    size() const noexcept;
+
+private:
+    struct tree_header;
+    struct node;
+
+    btree(std::span<std::byte> region, tree_header *header) noexcept;
+
+    [[nodiscard]] node&
+    _node(const std::uint32_t index) const noexcept;
+
+    [[nodiscard]] std::pair<std::uint32_t, std::uint64_t>
+    _find_leaf(const key_type key) const noexcept;
+
+    [[nodiscard]] std::uint32_t
+    _allocate(const bool leaf) noexcept;
+
+private:
+    tree_header *_header{nullptr};
+    node *_nodes{nullptr};
+};
+
+} // namespace shared_memory
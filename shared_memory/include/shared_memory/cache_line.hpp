@@ -0,0 +1,254 @@
+/**************************************************************
+ * @file cache_line.hpp
+ * @brief Cache-line aware layout helpers and false-sharing
+ * inspection for segment-resident structures.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#pragma once
+
+#if !defined(__linux__)
+#error "shared_memory is only supported on Linux"
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <sched.h>
+
+namespace shared_memory {
+
+/**
+ * @brief Cache line size assumed by every segment layout in this library.
+ *
+ * A fixed value rather than std::hardware_destructive_interference_size, which
+ * varies with tuning flags and would make layouts differ between processes
+ * built with different options.
+ */
+inline constexpr std::size_t CACHE_LINE_SIZE{64};
+
+/**
+ * @brief Rounds @p value up to a multiple of @p alignment.
+ * @param value The offset or size to round.
+ * @param alignment A power of two.
+ * @return The smallest multiple of @p alignment not below @p value.
+ */
+[[nodiscard]] constexpr std::size_t
+align_up(const std::size_t value, const std::size_t alignment = CACHE_LINE_SIZE) noexcept
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+/**
+ * @brief Returns the index of the cache line containing byte @p offset.
+ * @param offset Byte offset from a cache-line-aligned base.
+ * @param line_size Cache line size in bytes.
+ * @return The line index.
+ */
+[[nodiscard]] constexpr std::size_t
+cache_line_of(const std::size_t offset, const std::size_t line_size = CACHE_LINE_SIZE) noexcept
+{
+    return offset / line_size;
+}
+
+/**
+ * @brief Checks whether two byte ranges touch a common cache line.
+ * @return true if [a_offset, a_offset+a_size) and [b_offset, b_offset+b_size) share a line.
+ */
+[[nodiscard]] constexpr bool
+shares_cache_line(const std::size_t a_offset, const std::size_t a_size, const std::size_t b_offset, const std::size_t b_size, const std::size_t line_size = CACHE_LINE_SIZE) noexcept
+{
+    if (a_size == 0 || b_size == 0) {
+        return false;
+    }
+
+    const std::size_t a_first = cache_line_of(a_offset, line_size);
+    const std::size_t a_last = cache_line_of(a_offset + a_size - 1, line_size);
+    const std::size_t b_first = cache_line_of(b_offset, line_size);
+    const std::size_t b_last = cache_line_of(b_offset + b_size - 1, line_size);
+
+    return a_first <= b_last && b_first <= a_last;
+}
+
+/**
+ * @brief Wraps a value so that it occupies whole cache lines on its own.
+ *
+ * Use for fields written independently by different processes or threads.
+ */
+template <typename T, std::size_t Alignment = CACHE_LINE_SIZE>
+struct alignas(Alignment) cache_padded {
+    T value{};
+
+    /** @brief Accesses the wrapped value. */
+    [[nodiscard]] constexpr T& operator*() noexcept { return value; }
+
+    /** @brief Accesses the wrapped value as read-only. */
+    [[nodiscard]] constexpr const T& operator*() const noexcept { return value; }
+
+    /** @brief Member access on the wrapped value. */
+    [[nodiscard]] constexpr T *operator->() noexcept { return &value; }
+
+    /** @brief Read-only member access on the wrapped value. */
+    [[nodiscard]] constexpr const T *operator->() const noexcept { return &value; }
+};
+
+/**
+ * @brief Fixed number of cache-padded slots, one per CPU, for contention-free counters.
+ *
+ * Slot count is a template parameter so the array can live in a segment with a
+ * layout that does not depend on the machine; CPUs beyond @p Slots wrap around.
+ */
+template <typename T, std::size_t Slots>
+struct per_core_array {
+    static_assert(Slots > 0, "per_core_array needs at least one slot");
+
+    std::array<cache_padded<T>, Slots> slots{};
+
+    /**
+     * @brief Returns the slot index for the CPU the caller is running on.
+     * @return A slot index in [0, Slots).
+     */
+    [[nodiscard]] static std::size_t
+    current_slot() noexcept
+    {
+        const int cpu = sched_getcpu();
+        return cpu < 0 ? 0 : static_cast<std::size_t>(cpu) % Slots;
+    }
+
+    /** @brief Returns the slot of the current CPU. */
+    [[nodiscard]] T&
+    local() noexcept { return slots[current_slot()].value; }
+
+    /** @brief Returns slot @p index. */
+    [[nodiscard]] T&
+    operator[](const std::size_t index) noexcept { return slots[index].value; }
+
+    /** @brief Returns slot @p index as read-only. */
+    [[nodiscard]] const T&
+    operator[](const std::size_t index) const noexcept { return slots[index].value; }
+
+    /** @brief Returns the number of slots. */
+    [[nodiscard]] static constexpr std::size_t
+    size() noexcept { return Slots; }
+};
+
+/** @brief Writer id for fields that are never written after initialization. */
+inline constexpr std::uint32_t READ_ONLY_FIELD{0xffff'ffff};
+
+/**
+ * @brief Describes one field of a segment layout for false-sharing inspection.
+ *
+ * @c writer identifies who writes the field (a process role, thread or core);
+ * fields written by the same writer may share a line without harm.
+ */
+struct field_info {
+    std::string_view name;
+    std::size_t offset;
+    std::size_t size;
+    std::uint32_t writer;
+};
+
+/** @brief Two fields with different writers that share a cache line. */
+struct false_sharing {
+    std::string_view first;
+    std::string_view second;
+    std::size_t line;
+};
+
+/**
+ * @brief Checks at compile time or run time whether a layout has false sharing.
+ * @param fields The fields of the layout, offsets relative to a line-aligned base.
+ * @param line_size Cache line size in bytes.
+ * @return true if two fields with different writers share a line.
+ */
+[[nodiscard]] constexpr bool
+has_false_sharing(std::span<const field_info> fields, const std::size_t line_size = CACHE_LINE_SIZE) noexcept
+{
+    for (std::size_t i = 0; i < fields.size(); ++i) {
+        for (std::size_t j = i + 1; j < fields.size(); ++j) {
+            const auto& a = fields[i];
+            const auto& b = fields[j];
+
+            if (a.writer != b.writer && shares_cache_line(a.offset, a.size, b.offset, b.size, line_size)) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Lists every pair of fields with different writers that share a cache line.
+ *
+ * A read-only field next to a written one is reported too: every write
+ * invalidates the line in the caches of all readers.
+ * @param fields The fields of the layout, offsets relative to a line-aligned base.
+ * @param line_size Cache line size in bytes.
+ * @return One entry per conflicting pair, tagged with the first shared line.
+ */
+[[nodiscard]] inline std::vector<false_sharing>
+find_false_sharing(std::span<const field_info> fields, const std::size_t line_size = CACHE_LINE_SIZE)
+{
+    std::vector<false_sharing> conflicts{};
+
+    for (std::size_t i = 0; i < fields.size(); ++i) {
+        for (std::size_t j = i + 1; j < fields.size(); ++j) {
+            const auto& a = fields[i];
+            const auto& b = fields[j];
+
+            if (a.writer == b.writer || !shares_cache_line(a.offset, a.size, b.offset, b.size, line_size)) {
+                continue;
+            }
+
+            const std::size_t line = std::max(cache_line_of(a.offset, line_size), cache_line_of(b.offset, line_size));
+            conflicts.push_back({a.name, b.name, line});
+        }
+    }
+
+    return conflicts;
+}
+
+} // namespace shared_memory
+
+/**
+ * @brief Builds a field_info for @p member of @p type written by @p writer.
+ */
+#define SHARED_MEMORY_FIELD(type, member, writer) \
+    ::shared_memory::field_info{#member, offsetof(type, member), sizeof(type::member), (writer)}
@@ -0,0 +1,404 @@
+/**************************************************************
+ * @file column_table.hpp
+ * @brief Append-only columnar (struct-of-arrays) table in shared
+ * memory with vectorizable scan kernels.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#pragma once
+
+#if !defined(__linux__)
+#error "shared_memory is only supported on Linux"
+#endif
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <new>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "shared_memory/cache_line.hpp"
+#include "shared_memory/error.hpp"
+#include "shared_memory/hash.hpp"
+#include "shared_memory/typed_segment.hpp"
+
+namespace shared_memory {
+
+/**
+ * @brief Element types accepted as table columns: fixed-width, copyable by memcpy.
+ */
+template <typename T>
+concept column_value = segment_storable<T> && std::is_trivially_copyable_v<T>;
+
+/**
+ * @brief Fixed-capacity, append-only table stored column by column in a region.
+ *
+ * Each column is a separate cache-line-aligned array, so a scan touches only
+ * the columns it reads. A single writer appends rows and then publishes the
+ * new row count with release semantics; readers in any process load the
+ * count with acquire semantics and scan the published prefix without locks.
+ * The object itself only holds pointers into the region, which must outlive it.
+ */
+template <column_value... Columns>
+class column_table {
+public:
+    static_assert(sizeof...(Columns) > 0, "column_table needs at least one column");
+
+    /** @brief Number of columns. */
+    static constexpr std::size_t COLUMN_COUNT{sizeof...(Columns)};
+
+    /** @brief Alignment of the table header and of every column array. */
+    static constexpr std::size_t ALIGNMENT{CACHE_LINE_SIZE};
+
+    /** @brief Value of the header magic in a formatted region. */
+    static constexpr std::uint64_t MAGIC{0x434f'4c54'4142'4c31};  // "COLTABL1"
+
+    /** @brief Layout id derived from the column types. */
+    static constexpr std::uint64_t LAYOUT{[] {
+        std::uint64_t hash = fnv1a(std::string_view("column_table"));
+        ((hash = fnv1a(layout_hash<Columns>(), hash)), ...);
+        return hash;
+    }()};
+
+    /** @brief Type of the column at index @p I. */
+    template <std::size_t I>
+    using column_type = std::tuple_element_t<I, std::tuple<Columns...>>;
+
+    /** @brief Constructs an empty table bound to no region. */
+    column_table() noexcept = default;
+
+    /**
+     * @brief Returns the region size needed for @p capacity rows.
+     * @param capacity Maximum number of rows.
+     * @return Bytes required, header included, or SIZE_MAX if that does not fit in a size_t.
+     */
+    [[nodiscard]] static constexpr std::size_t
+    required_size(const std::size_t capacity) noexcept
+    {
+        const auto offsets = _column_offsets(capacity);
+        return offsets ? offsets->back() : SIZE_MAX;
+    }
+
+    /**
+     * @brief Formats @p region as an empty table.
+     * @param region Cache-line-aligned memory of at least required_size(capacity) bytes.
+     * @param capacity Maximum number of rows.
+     * @return The table, or layout_mismatch (ENOSPC if the region is too small,
+     * EINVAL if it is misaligned or the capacity overflows the layout).
+     */
+    [[nodiscard]] static std::expected<column_table, error>
+    create(std::span<std::byte> region, const std::size_t capacity) noexcept
+    {
+        const auto offsets = _column_offsets(capacity);
+        if (!offsets || reinterpret_cast<std::uintptr_t>(region.data()) % ALIGNMENT != 0) {
+            return std::unexpected(error(errc::layout_mismatch, {EINVAL, std::generic_category()}));
+        }
+
+        if (region.size() < offsets->back()) {
+            return std::unexpected(error(errc::layout_mismatch, {ENOSPC, std::generic_category()}));
+        }
+
+        auto *header = ::new (static_cast<void *>(region.data())) table_header{};
+        header->magic = MAGIC;
+        header->layout = LAYOUT;
+        header->capacity = capacity;
+
+        return column_table(region, header, *offsets);
+    }
+
+    /**
+     * @brief Binds to a region formatted by create(), possibly in another process.
+     * @param region The formatted memory.
+     * @return The table, or layout_mismatch (EPROTO) if the region holds another layout.
+     */
+    [[nodiscard]] static std::expected<column_table, error>
+    attach(std::span<std::byte> region) noexcept
+    {
+        if (region.size() < sizeof(table_header) || reinterpret_cast<std::uintptr_t>(region.data()) % ALIGNMENT != 0) {
+            return std::unexpected(error(errc::layout_mismatch, {EPROTO, std::generic_category()}));
+        }
+
+        /* The capacity comes from shared memory, so an overflowing one is treated as corruption. */
+        auto *header = std::launder(reinterpret_cast<table_header *>(region.data()));
+        const auto offsets = _column_offsets(header->capacity);
+        if (header->magic != MAGIC || header->layout != LAYOUT || !offsets || region.size() < offsets->back()) {
+            return std::unexpected(error(errc::layout_mismatch, {EPROTO, std::generic_category()}));
+        }
+
+        return column_table(region, header, *offsets);
+    }
+
+    /**
+     * @brief Appends one row and publishes it. Only one process may append.
+     * @param values One value per column.
+     * @return true on success, false if the table is full.
+     */
+    [[nodiscard]] bool
+    append(const Columns&... values) noexcept
+    {
+        const auto row = _header->rows.load(std::memory_order_relaxed);
+        if (row >= _header->capacity) [[unlikely]] {
+            return false;
+        }
+
+        _store(row, std::index_sequence_for<Columns...>{}, values...);
+        _header->rows.store(row + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+     * @brief Returns the number of published rows.
+     * @return Rows visible to readers.
+     */
+    [[nodiscard]] std::size_t
+    size() const noexcept { return _header->rows.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Returns the maximum number of rows.
+     * @return The capacity fixed at create().
+     */
+    [[nodiscard]] std::size_t
+    capacity() const noexcept { return _header->capacity; }
+
+    /**
+     * @brief Returns the published prefix of column @p I.
+     * @return A read-only span over the first size() values of the column.
+     */
+    template <std::size_t I>
+    [[nodiscard]] std::span<const column_type<I>>
+    column() const noexcept
+    {
+        return {_column_data<I>(), size()};
+    }
+
+private:
+    struct alignas(ALIGNMENT) table_header {
+        std::uint64_t magic{0};
+        std::uint64_t layout{0};
+        std::uint64_t capacity{0};
+        std::atomic<std::uint64_t> rows{0};
+    };
+
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "row count must be lock-free to be shared across processes");
+
+    /* Element I is the offset of column I; the last element is the total size. std::nullopt if it overflows. */
+    [[nodiscard]] static constexpr std::optional<std::array<std::size_t, COLUMN_COUNT + 1>>
+    _column_offsets(const std::size_t capacity) noexcept
+    {
+        constexpr std::array<std::size_t, COLUMN_COUNT> sizes{sizeof(Columns)...};
+
+        std::array<std::size_t, COLUMN_COUNT + 1> offsets{};
+        std::size_t cursor = align_up(sizeof(table_header), ALIGNMENT);
+        for (std::size_t i = 0; i < COLUMN_COUNT; ++i) {
+            offsets[i] = cursor;
+            std::size_t bytes = 0;
+            if (__builtin_mul_overflow(sizes[i], capacity, &bytes) || __builtin_add_overflow(cursor, bytes, &cursor) || cursor > SIZE_MAX - (ALIGNMENT - 1)) {
+                return std::nullopt;
+            }
+            cursor = align_up(cursor, ALIGNMENT);
+        }
+        offsets[COLUMN_COUNT] = cursor;
+
+        return offsets;
+    }
+
+    column_table(std::span<std::byte> region, table_header *header, const std::array<std::size_t, COLUMN_COUNT + 1>& offsets) noexcept
+    : _base(region.data()),
+      _header(header),
+      _offsets(offsets)
+    {}
+
+    template <std::size_t I>
+    [[nodiscard]] column_type<I> *
+    _column_data() const noexcept
+    {
+        return std::launder(reinterpret_cast<column_type<I> *>(_base + _offsets[I]));
+    }
+
+    template <std::size_t... I>
+    void
+    _store(const std::size_t row, std::index_sequence<I...>, const Columns&... values) noexcept
+    {
+        ((_column_data<I>()[row] = values), ...);
+    }
+
+private:
+    std::byte *_base{nullptr};
+    table_header *_header{nullptr};
+    std::array<std::size_t, COLUMN_COUNT + 1> _offsets{};
+};
+
+/*
+ * Scan kernels. They are written as straight loops over contiguous spans with
+ * several independent accumulators so the compiler can vectorize them for the
+ * target selected at build time (e.g. -march=native) without intrinsics.
+ */
+
+/** @brief Number of independent accumulator lanes used by the reduction kernels. */
+inline constexpr std::size_t SCAN_LANES{8};
+
+/** @brief Accumulator type for sum(): 64-bit for integers, double for floating point. */
+template <typename T>
+using sum_type = std::conditional_t<std::is_floating_point_v<T>, double,
+                 std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>>;
+
+/**
+ * @brief Sums a column.
+ * @param values The values to add up.
+ * @return The sum, widened to sum_type<T>.
+ */
+template <typename T>
+    requires std::is_arithmetic_v<T>
+[[nodiscard]] sum_type<T>
+sum(std::span<const T> values) noexcept
+{
+    std::array<sum_type<T>, SCAN_LANES> lanes{};
+
+    const std::size_t bulk = values.size() - values.size() % SCAN_LANES;
+    for (std::size_t i = 0; i < bulk; i += SCAN_LANES) {
+        for (std::size_t lane = 0; lane < SCAN_LANES; ++lane) {
+            lanes[lane] += static_cast<sum_type<T>>(values[i + lane]);
+        }
+    }
+
+    sum_type<T> total{};
+    for (const auto lane : lanes) {
+        total += lane;
+    }
+    for (std::size_t i = bulk; i < values.size(); ++i) {
+        total += static_cast<sum_type<T>>(values[i]);
+    }
+
+    return total;
+}
+
+/** @brief Result of min_max(). */
+template <typename T>
+struct min_max_result {
+    T min;
+    T max;
+};
+
+/**
+ * @brief Finds the smallest and largest value of a column.
+ * @param values The values to scan.
+ * @return Both extremes, or std::nullopt for an empty span.
+ */
+template <typename T>
+    requires std::is_arithmetic_v<T>
+[[nodiscard]] std::optional<min_max_result<T>>
+min_max(std::span<const T> values) noexcept
+{
+    if (values.empty()) {
+        return std::nullopt;
+    }
+
+    std::array<T, SCAN_LANES> lows{};
+    std::array<T, SCAN_LANES> highs{};
+    lows.fill(values.front());
+    highs.fill(values.front());
+
+    const std::size_t bulk = values.size() - values.size() % SCAN_LANES;
+    for (std::size_t i = 0; i < bulk; i += SCAN_LANES) {
+        for (std::size_t lane = 0; lane < SCAN_LANES; ++lane) {
+            lows[lane] = std::min(lows[lane], values[i + lane]);
+            highs[lane] = std::max(highs[lane], values[i + lane]);
+        }
+    }
+
+    min_max_result<T> result{values.front(), values.front()};
+    for (std::size_t lane = 0; lane < SCAN_LANES; ++lane) {
+        result.min = std::min(result.min, lows[lane]);
+        result.max = std::max(result.max, highs[lane]);
+    }
+    for (std::size_t i = bulk; i < values.size(); ++i) {
+        result.min = std::min(result.min, values[i]);
+        result.max = std::max(result.max, values[i]);
+    }
+
+    return result;
+}
+
+/**
+ * @brief Counts the values for which @p predicate holds, without branching per row.
+ * @param values The values to test.
+ * @param predicate Callable returning bool for a value.
+ * @return The number of matching values.
+ */
+template <typename T, std::predicate<const T&> Predicate>
+[[nodiscard]] std::size_t
+count_if(std::span<const T> values, Predicate predicate) noexcept(std::is_nothrow_invocable_v<Predicate, const T&>)
+{
+    std::size_t count{0};
+    for (const T& value : values) {
+        count += static_cast<std::size_t>(predicate(value));
+    }
+
+    return count;
+}
+
+/**
+ * @brief Writes the row indices for which @p predicate holds, without branching per row.
+ *
+ * Stops early once @p out is full; combine the indices with other columns to
+ * evaluate multi-column filters.
+ * @param values The values to test.
+ * @param predicate Callable returning bool for a value.
+ * @param out Destination for matching row indices.
+ * @return The number of indices written.
+ */
+template <typename T, std::predicate<const T&> Predicate>
+[[nodiscard]] std::size_t
+filter(std::span<const T> values, Predicate predicate, std::span<std::size_t> out) noexcept(std::is_nothrow_invocable_v<Predicate, const T&>)
+{
+    std::size_t written{0};
+    for (std::size_t i = 0; i < values.size() && written < out.size(); ++i) {
+        out[written] = i;
+        written += static_cast<std::size_t>(predicate(values[i]));
+    }
+
+    return written;
+}
+
+} // namespace shared_memory
@@ -56,7 +56,13 @@ enum class errc {
     open_failed,
     truncate_failed,
     map_failed,
-    stat_failed
+    stat_failed,
+    populate_failed,
+    allocate_failed,
+    wait_failed,
+    layout_mismatch,
+    write_failed,
+    read_failed
 };
 
 /**
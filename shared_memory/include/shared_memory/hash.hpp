@@ -0,0 +1,89 @@
+/**************************************************************
+ * @file hash.hpp
+ * @brief Small constexpr hash functions used for layout ids and
+ * segment-resident hash structures.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace shared_memory {
+
+/** @brief FNV-1a 64-bit offset basis. */
+inline constexpr std::uint64_t FNV_OFFSET_BASIS{0xcbf2'9ce4'8422'2325};
+
+/** @brief FNV-1a 64-bit prime. */
+inline constexpr std::uint64_t FNV_PRIME{0x0000'0100'0000'01b3};
+
+/**
+ * @brief Hashes bytes with 64-bit FNV-1a.
+ *
+ * Stable across processes and builds, so it is suitable for values stored in
+ * shared memory. Not intended for adversarial input.
+ * @param bytes The bytes to hash.
+ * @param seed Starting state; chain calls by passing the previous result.
+ * @return The 64-bit hash.
+ */
+[[nodiscard]] constexpr std::uint64_t
+fnv1a(std::string_view bytes, std::uint64_t seed = FNV_OFFSET_BASIS) noexcept
+{
+    for (const char c : bytes) {
+        seed ^= static_cast<std::uint8_t>(c);
+        seed *= FNV_PRIME;
+    }
+
+    return seed;
+}
+
+/**
+ * @brief Hashes an integer with 64-bit FNV-1a over its little-endian bytes.
+ * @param value The value to hash.
+ * @param seed Starting state; chain calls by passing the previous result.
+ * @return The 64-bit hash.
+ */
+[[nodiscard]] constexpr std::uint64_t
+fnv1a(std::uint64_t value, std::uint64_t seed = FNV_OFFSET_BASIS) noexcept
+{
+    for (std::size_t i = 0; i < sizeof(value); ++i) {
+        seed ^= (value >> (i * 8)) & 0xff;
+        seed *= FNV_PRIME;
+    }
+
+    return seed;
+}
+
+} // namespace shared_memory
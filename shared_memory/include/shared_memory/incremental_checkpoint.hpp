@@ -0,0 +1,183 @@
+/**************************************************************
+ * @file incremental_checkpoint.hpp
+ * @brief Incremental checkpoints that write only pages changed
+ * since the previous one.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#pragma once
+
+#if !defined(__linux__)
+#error "shared_memory is only supported on Linux"
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <span>
+
+#include "shared_memory/error.hpp"
+#include "shared_memory/shared_memory.hpp"
+
+namespace shared_memory {
+
+/**
+ * @brief How incremental_checkpoint finds pages changed since the last delta.
+ */
+enum class dirty_tracking {
+    /** @brief PAGE_HASH; SOFT_DIRTY clears process-wide state, so it is only used when asked for. */
+    AUTO,
+
+    /**
+     * @brief Kernel soft-dirty bits from /proc/self/pagemap, reset through /proc/self/clear_refs.
+     *
+     * Costs nothing between deltas and reads only the page table at delta
+     * time. Soft-dirty bits live in this process's page tables, so only writes
+     * made by this process are seen, and clearing them resets tracking for
+     * every mapping in the process. Only one such tracker may be live at a
+     * time.
+     */
+    SOFT_DIRTY,
+
+    /**
+     * @brief Compares a 64-bit hash of every page against the previous delta.
+     *
+     * Reads the whole segment at delta time but sees writes from every
+     * process, and works on kernels built without CONFIG_MEM_SOFT_DIRTY.
+     */
+    PAGE_HASH
+};
+
+/**
+ * @brief Writes a full checkpoint once, then delta files holding only changed pages.
+ *
+ * A delta file starts with a small manifest (segment size, page size,
+ * sequence number and the indices of the pages it carries) followed by the
+ * page contents. Restoring means restore() of the base checkpoint followed by
+ * apply_delta() of each delta in sequence order. As with checkpoint(), writes
+ * racing with write_delta() may leave a delta mixing old and new bytes. Pages
+ * written after they were copied show up again in the next delta, but in
+ * SOFT_DIRTY mode a write landing between the page-table scan and the reset
+ * is missed, so quiesce writers for exact deltas. The segment must outlive
+ * this object and must not be resized.
+ */
+class incremental_checkpoint {
+public:
+    /** @brief Value of the magic at the start of every delta file. */
+    static constexpr std::uint64_t MAGIC{0x5348'4d44'454c'5441};  // "SHMDELTA"
+
+    /** @brief Stops tracking, letting another SOFT_DIRTY tracker begin. */
+    ~incremental_checkpoint();
+
+    incremental_checkpoint(incremental_checkpoint&& other) noexcept;
+    incremental_checkpoint& operator=(incremental_checkpoint&& other) noexcept;
+
+    /**
+     * @brief Writes the base checkpoint of @p segment and starts tracking changes.
+     * @param segment The segment to track.
+     * @param base_path Destination of the full checkpoint.
+     * @param tracking How to detect changed pages.
+     * @param options I/O settings for the base checkpoint.
+     * @return The tracker, or a checkpoint() error, open_failed / write_failed
+     * if soft-dirty tracking cannot be armed (ENOTSUP if the kernel lacks it,
+     * EBUSY if another SOFT_DIRTY tracker is live), or allocate_failed (ENOMEM).
+     */
+    [[nodiscard]] static std::expected<incremental_checkpoint, error>
+    begin(shared_memory& segment, const std::filesystem::path& base_path, const dirty_tracking tracking = dirty_tracking::AUTO, const checkpoint_options& options = {}) noexcept;
+
+    /**
+     * @brief Writes every page changed since begin() or the previous delta.
+     *
+     * Tracking only advances once the delta is durable: after a failure, the
+     * pages it would have carried are written by the next call.
+     * @param path Destination of the delta file.
+     * @return The number of pages written, or open_failed / read_failed / write_failed / allocate_failed.
+     */
+    [[nodiscard]] std::expected<std::size_t, error>
+    write_delta(const std::filesystem::path& path) noexcept;
+
+    /**
+     * @brief Copies the pages of a delta file into @p segment.
+     * @param segment A segment restored from the base checkpoint and earlier deltas.
+     * @param path The delta file.
+     * @return The delta's sequence number (1 for the first delta), or
+     * open_failed / read_failed, or layout_mismatch (EPROTO) if the file is
+     * not a delta for a segment of this size.
+     */
+    [[nodiscard]] static std::expected<std::uint64_t, error>
+    apply_delta(shared_memory& segment, const std::filesystem::path& path) noexcept;
+
+    /**
+     * @brief Checks whether the kernel maintains soft-dirty bits.
+     * @return true if a freshly written page reports its soft-dirty bit.
+     */
+    [[nodiscard]] static bool
+    soft_dirty_supported() noexcept;
+
+    /**
+     * @brief Returns the tracking method in use.
+     * @return SOFT_DIRTY or PAGE_HASH, never AUTO.
+     */
+    [[nodiscard]] dirty_tracking
+    tracking() const noexcept { return _tracking; }
+
+    /**
+     * @brief Returns the sequence number of the last delta written.
+     * @return 0 until the first write_delta().
+     */
+    [[nodiscard]] std::uint64_t
+    sequence() const noexcept { return _sequence; }
+
+private:
+    incremental_checkpoint(std::span<std::byte> memory, const dirty_tracking tracking, std::unique_ptr<std::uint64_t[]> hashes, std::unique_ptr<std::uint64_t[]> unwritten) noexcept;
+
+    [[nodiscard]] std::expected<std::size_t, error>
+    _collect_soft_dirty(std::uint64_t *pages) noexcept;
+
+    [[nodiscard]] std::size_t
+    _collect_changed_hashes(std::uint64_t *pages, std::uint64_t *hashes) const noexcept;
+
+    [[nodiscard]] std::expected<void, error>
+    _write_delta_file(const std::filesystem::path& path, const std::uint64_t *pages, const std::size_t count) const noexcept;
+
+private:
+    std::span<std::byte> _memory{};
+    dirty_tracking _tracking{dirty_tracking::PAGE_HASH};
+    std::uint64_t _sequence{0};
+    std::unique_ptr<std::uint64_t[]> _hashes{};  // One per page in PAGE_HASH mode
+    std::unique_ptr<std::uint64_t[]> _unwritten{};  // SOFT_DIRTY mode: bitmap of pages cleared by a delta that failed
+};
+
+} // namespace shared_memory
@@ -0,0 +1,165 @@
+/**************************************************************
+ * @file intern_table.hpp
+ * @brief Shared string interning table mapping strings to stable
+ * 32-bit ids with lock-free lookup.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#pragma once
+
+#if !defined(__linux__)
+#error "shared_memory is only supported on Linux"
+#endif
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <span>
+#include <string_view>
+
+#include "shared_memory/cache_line.hpp"
+#include "shared_memory/error.hpp"
+
+namespace shared_memory {
+
+/**
+ * @brief Append-only table that assigns each distinct string a stable 32-bit id.
+ *
+ * The table lives entirely in a caller-provided region: a header, an
+ * open-addressing slot array, an id-indexed entry array and a string arena.
+ * Lookups and inserts from any process are lock-free: inserters reserve an id
+ * and arena space with fetch_add, copy the string, then publish the id into a
+ * slot with a CAS. Two processes racing to intern the same string both end up
+ * with the id that won the slot; the loser's reserved id is simply never used,
+ * so ids are unique and stable but may have gaps. Strings are never removed.
+ * The object only holds pointers into the region, which must outlive it.
+ */
+class intern_table {
+public:
+    /** @brief Value of the header magic in a formatted region. */
+    static constexpr std::uint64_t MAGIC{0x494e'5445'524e'5431};  // "INTERNT1"
+
+    /** @brief Maximum length of an interned string. */
+    static constexpr std::size_t MAX_LENGTH{UINT32_MAX};
+
+    /** @brief Constructs an empty table bound to no region. */
+    intern_table() noexcept = default;
+
+    /**
+     * @brief Returns the region size needed for the given limits.
+     * @param max_strings Maximum number of distinct strings.
+     * @param arena_bytes Total bytes available for string contents.
+     * @return Bytes required.
+     */
+    [[nodiscard]] static std::size_t
+    required_size(const std::size_t max_strings, const std::size_t arena_bytes) noexcept;
+
+    /**
+     * @brief Formats @p region as an empty table.
+     * @param region Cache-line-aligned memory of at least required_size() bytes.
+     * @param max_strings Maximum number of distinct strings (at most 2^31).
+     * @param arena_bytes Total bytes available for string contents.
+     * @return The table, or layout_mismatch (ENOSPC if the region is too small,
+     * EINVAL for a misaligned region or bad limits).
+     */
+    [[nodiscard]] static std::expected<intern_table, error>
+    create(std::span<std::byte> region, const std::size_t max_strings, const std::size_t arena_bytes) noexcept;
+
+    /**
+     * @brief Binds to a region formatted by create(), possibly in another process.
+     * @param region The formatted memory.
+     * @return The table, or layout_mismatch (EPROTO) if the region holds no table.
+     */
+    [[nodiscard]] static std::expected<intern_table, error>
+    attach(std::span<std::byte> region) noexcept;
+
+    /**
+     * @brief Returns the id of @p value, interning it first if needed.
+     * @param value The string to intern.
+     * @return The id, or allocate_failed (ENOSPC) when ids or arena space run out.
+     */
+    [[nodiscard]] std::expected<std::uint32_t, error>
+    intern(std::string_view value) noexcept;
+
+    /**
+     * @brief Looks up the id of @p value without interning it.
+     * @param value The string to look up.
+     * @return The id, or std::nullopt if the string was never interned.
+     */
+    [[nodiscard]] std::optional<std::uint32_t>
+    find(std::string_view value) const noexcept;
+
+    /**
+     * @brief Returns the string for an id obtained from intern() or find().
+     * @param id A published id.
+     * @return A view into the arena, or an empty view for an out-of-range id.
+     */
+    [[nodiscard]] std::string_view
+    resolve(const std::uint32_t id) const noexcept;
+
+    /**
+     * @brief Returns the number of ids handed out so far, including unused ones lost to races.
+     * @return The id high-water mark.
+     */
+    [[nodiscard]] std::size_t
+    size() const noexcept;
+
+private:
+    struct table_header;
+
+    struct entry {
+        std::uint64_t hash;
+        std::uint64_t offset;
+        std::uint32_t length;
+        std::uint32_t reserved;
+    };
+
+    intern_table(std::span<std::byte> region, table_header *header) noexcept;
+
+    [[nodiscard]] bool
+    _matches(const std::uint32_t id, const std::uint64_t hash, std::string_view value) const noexcept;
+
+    [[nodiscard]] std::optional<std::uint32_t>
+    _find(std::string_view value, const std::uint64_t hash) const noexcept;
+
+private:
+    table_header *_header{nullptr};
+    std::atomic<std::uint32_t> *_slots{nullptr};
+    entry *_entries{nullptr};
+    char *_arena{nullptr};
+    std::size_t _slot_mask{0};
+};
+
+} // namespace shared_memory
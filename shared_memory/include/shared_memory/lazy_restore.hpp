@@ -0,0 +1,139 @@
+/**************************************************************
+ * @file lazy_restore.hpp
+ * @brief Lazy restore of checkpoints through userfaultfd.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#pragma once
+
+#if !defined(__linux__)
+#error "shared_memory is only supported on Linux"
+#endif
+
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+
+#include "shared_memory/error.hpp"
+#include "shared_memory/segment_name.hpp"
+#include "shared_memory/shared_memory.hpp"
+
+namespace shared_memory {
+
+/**
+ * @brief A segment restored from a checkpoint() file on demand.
+ *
+ * start() creates the segment and returns as soon as it is mapped. Pages
+ * missing from this process's mapping are registered with userfaultfd: a
+ * handler thread fills each faulting page from the file, while a streaming
+ * thread copies the whole file in order behind it. When userfaultfd is not
+ * available (vm.unprivileged_userfaultfd=0 without CAP_SYS_PTRACE, kernels
+ * without shmem support) the file is restored eagerly instead.
+ *
+ * Only this process's accesses are intercepted. Another process touching a
+ * page first would see zeros and the streamed data for that page would be
+ * skipped, so other processes must not attach until complete() is true.
+ * When only user-mode faults can be handled, system calls that read a page
+ * not yet restored (write(2) from the segment, checkpoint()) fail with
+ * EFAULT until then. Destruction waits for the streaming to finish.
+ */
+class lazy_restore {
+public:
+    /** @brief Constructs an object that restores nothing. */
+    lazy_restore() noexcept;
+
+    /** @brief Waits for streaming to finish, then releases the segment handle. */
+    ~lazy_restore();
+
+    lazy_restore(lazy_restore&&) noexcept;
+    lazy_restore& operator=(lazy_restore&&) noexcept;
+
+    /**
+     * @brief Creates @p shm_name sized to the checkpoint at @p path and starts restoring it.
+     * @param path The checkpoint file.
+     * @param shm_name The name of the segment to create.
+     * @param options Segment settings; the I/O settings apply to the eager fallback.
+     * @return The restore, or open_failed (EINVAL for a read-only segment),
+     * stat_failed, map_failed, or a create() / restore() error.
+     */
+    [[nodiscard]] static std::expected<lazy_restore, error>
+    start(const std::filesystem::path& path, const segment_name& shm_name, const restore_options& options = {}) noexcept;
+
+    /**
+     * @brief Starts a lazy restore with a runtime segment name.
+     *
+     * Validates @p shm_name with segment_name::make() and forwards to the overload above.
+     */
+    [[nodiscard]] static std::expected<lazy_restore, error>
+    start(const std::filesystem::path& path, std::string_view shm_name, const restore_options& options = {}) noexcept;
+
+    /**
+     * @brief Returns the segment; every page reads as restored, faulting in on first touch.
+     * @return The segment handle. Requires an object returned by start().
+     */
+    [[nodiscard]] shared_memory&
+    segment() noexcept;
+
+    /**
+     * @brief Checks whether pages are being filled on demand.
+     * @return false if start() fell back to an eager restore.
+     */
+    [[nodiscard]] bool
+    is_lazy() const noexcept;
+
+    /**
+     * @brief Checks whether every page has been restored.
+     * @return true once streaming finished or for an eager restore.
+     */
+    [[nodiscard]] bool
+    complete() const noexcept;
+
+    /**
+     * @brief Blocks until every page has been restored.
+     * @return Nothing on success, or read_failed if the file could not be read;
+     * pages that could not be read are left zeroed.
+     */
+    [[nodiscard]] std::expected<void, error>
+    wait() noexcept;
+
+private:
+    struct state;
+
+    explicit lazy_restore(std::unique_ptr<state> restore_state) noexcept;
+
+private:
+    std::unique_ptr<state> _state;
+};
+
+} // namespace shared_memory
@@ -0,0 +1,150 @@
+/**************************************************************
+ * @file persistent_segment.hpp
+ * @brief File-backed segment with batched, dirty-range msync.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#pragma once
+
+#if !defined(__linux__)
+#error "shared_memory is only supported on Linux"
+#endif
+
+#include <chrono>
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <span>
+
+#include "shared_memory/error.hpp"
+#include "shared_memory/shared_memory.hpp"
+
+namespace shared_memory {
+
+/**
+ * @brief When persistent_segment writes dirty ranges back to its file.
+ *
+ * barrier() always flushes; the two triggers below add background flushes.
+ */
+struct sync_policy {
+    /** @brief Period of background flushes; zero disables them. */
+    std::chrono::milliseconds interval{1000};
+
+    /** @brief Newly dirtied bytes that trigger a background flush early; zero disables the trigger. */
+    std::size_t dirty_threshold{std::size_t{64} << 20};
+};
+
+/**
+ * @brief A map_file() segment whose modified pages are flushed with msync under a policy.
+ *
+ * Writers report the ranges they modify with mark_dirty() (or use write()).
+ * Dirty pages are tracked in a bitmap, and each flush msyncs only the runs of
+ * dirty pages with MS_SYNC, so the cost tracks what changed rather than the
+ * size of the file. A flush covers every range marked before it started;
+ * ranges marked while it runs go into the next one.
+ *
+ * Tracking is per object: other processes mapping the same file must flush
+ * their own writes. Unmarked writes still reach the file through normal
+ * writeback, but nothing bounds when. Destruction performs a final flush.
+ */
+class persistent_segment {
+public:
+    /** @brief Constructs an object with no segment. */
+    persistent_segment() noexcept;
+
+    /** @brief Stops background flushing, flushes dirty ranges and unmaps the file. */
+    ~persistent_segment();
+
+    persistent_segment(persistent_segment&&) noexcept;
+    persistent_segment& operator=(persistent_segment&&) noexcept;
+
+    /**
+     * @brief Maps @p path with map_file() and starts the flushing policy.
+     * @param path The file to map.
+     * @param size Bytes to map; the file is extended if shorter. 0 maps the whole existing file.
+     * @param options map_file() settings; the mode must be READ_WRITE.
+     * @param policy When to flush in the background.
+     * @return The segment, or a map_file() error; open_failed (EINVAL) for a
+     * read-only or write-only mode, allocate_failed if the flusher cannot start.
+     */
+    [[nodiscard]] static std::expected<persistent_segment, error>
+    open(const std::filesystem::path& path, const std::size_t size = 0, const file_options& options = {}, const sync_policy& policy = {}) noexcept;
+
+    /**
+     * @brief Returns the mapped file.
+     * @return The segment handle. Requires an object returned by open().
+     */
+    [[nodiscard]] shared_memory&
+    segment() noexcept;
+
+    /**
+     * @brief Records that [offset, offset+length) was modified; clamped to the mapping.
+     *
+     * Lock-free and safe from any thread. Call it after the write.
+     */
+    void
+    mark_dirty(const std::size_t offset, const std::size_t length) noexcept;
+
+    /**
+     * @brief Copies @p data into the mapping at @p offset and marks the range dirty.
+     * @return false if the range does not fit.
+     */
+    [[nodiscard]] bool
+    write(const std::size_t offset, std::span<const std::byte> data) noexcept;
+
+    /**
+     * @brief Flushes every range marked so far and waits until it is on stable storage.
+     * @return Nothing on success, or write_failed with the msync error, including
+     * one left by a background flush since the last barrier.
+     */
+    [[nodiscard]] std::expected<void, error>
+    barrier() noexcept;
+
+    /**
+     * @brief Returns the bytes marked dirty and not yet flushed, in whole pages.
+     * @return The pending byte count.
+     */
+    [[nodiscard]] std::size_t
+    dirty_bytes() const noexcept;
+
+private:
+    struct state;
+
+    explicit persistent_segment(std::unique_ptr<state> segment_state) noexcept;
+
+private:
+    std::unique_ptr<state> _state;
+};
+
+} // namespace shared_memory
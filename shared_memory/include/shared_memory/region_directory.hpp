@@ -0,0 +1,233 @@
+/**************************************************************
+ * @file region_directory.hpp
+ * @brief Named, aligned sub-regions packed into a single shared
+ * memory segment.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#pragma once
+
+#if !defined(__linux__)
+#error "shared_memory is only supported on Linux"
+#endif
+
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "shared_memory/cache_line.hpp"
+#include "shared_memory/error.hpp"
+#include "shared_memory/segment_header.hpp"
+#include "shared_memory/segment_name.hpp"
+#include "shared_memory/shared_memory.hpp"
+
+namespace shared_memory {
+
+/**
+ * @brief Table-of-contents entry describing one sub-region, as stored in the segment.
+ */
+struct region_entry {
+    /** @brief Maximum length of a region name, excluding the terminator. */
+    static constexpr std::size_t NAME_CAPACITY{47};
+
+    char name[NAME_CAPACITY + 1]{};
+    std::uint64_t offset{0};  // From the start of the mapping
+    std::uint64_t size{0};
+};
+
+static_assert(sizeof(region_entry) == CACHE_LINE_SIZE, "region_entry must stay one cache line");
+
+/**
+ * @brief Builder that assigns aligned offsets to named sub-regions.
+ *
+ * Regions are placed in insertion order after the segment header and the
+ * table of contents. Alignment is relative to the start of the mapping,
+ * which is page-aligned, so any power of two up to the page size is honored.
+ */
+class region_layout {
+public:
+    /**
+     * @brief Appends a region to the layout.
+     * @param name Unique region name of at most region_entry::NAME_CAPACITY characters.
+     * @param size Size of the region in bytes.
+     * @param alignment Power-of-two alignment, at most the page size (default: one cache line).
+     * @return Nothing on success, or layout_mismatch carrying EEXIST for a duplicate
+     * name, ENAMETOOLONG for a long name, or EINVAL for an empty name, a name
+     * containing '\0', or a bad alignment.
+     */
+    [[nodiscard]] std::expected<void, error>
+    add(std::string_view name, const std::size_t size, const std::size_t alignment = CACHE_LINE_SIZE);
+
+    /**
+     * @brief Returns the number of regions in the layout.
+     * @return The region count.
+     */
+    [[nodiscard]] std::size_t
+    count() const noexcept { return _entries.size(); }
+
+    /**
+     * @brief Returns the size a segment needs to host the layout.
+     * @return Total bytes including the header and the table of contents.
+     */
+    [[nodiscard]] std::size_t
+    segment_size() const noexcept;
+
+    /**
+     * @brief Returns the entries with their final offsets.
+     * @return The table of contents as it will be written to the segment.
+     */
+    [[nodiscard]] std::vector<region_entry>
+    entries() const;
+
+private:
+    std::vector<region_entry> _entries{};    // Offsets are assigned by entries()
+    std::vector<std::size_t> _alignments{};
+};
+
+/**
+ * @brief A published segment hosting many named sub-regions.
+ *
+ * The creator writes the table of contents behind a segment_header; readers
+ * attach with open(), which waits for publication and builds a process-local
+ * index so find() is O(1). Non-copyable but supports move semantics.
+ */
+class region_directory {
+public:
+    /** @brief Layout id stored in the segment header of every directory segment. */
+    static constexpr std::uint64_t LAYOUT{0x5245'4749'4f4e'5331};  // "REGIONS1"
+
+    /** @brief Constructs an empty directory with no segment attached. */
+    region_directory() noexcept = default;
+
+    /**
+     * @brief Creates a segment for @p layout, lets @p init fill regions, then publishes it.
+     * @param shm_name The name of the segment (leading slash is optional).
+     * @param layout The regions to host.
+     * @param init Callable invoked with the directory before readers can attach.
+     * @param options Access mode, unlink and population settings.
+     * @return The directory, or an error on failure.
+     */
+    template <std::invocable<region_directory&> Init>
+    [[nodiscard]] static std::expected<region_directory, error>
+    create(const segment_name& shm_name, const region_layout& layout, Init&& init, const create_options& options = {})
+    {
+        auto directory = _create_unpublished(shm_name, layout, options);
+        if (!directory) {
+            return directory;
+        }
+
+        std::forward<Init>(init)(*directory);
+        publish(directory->_shm);
+
+        return directory;
+    }
+
+    /**
+     * @brief Creates and publishes a segment for @p layout with zero-filled regions.
+     * @param shm_name The name of the segment (leading slash is optional).
+     * @param layout The regions to host.
+     * @param options Access mode, unlink and population settings.
+     * @return The directory, or an error on failure.
+     */
+    [[nodiscard]] static std::expected<region_directory, error>
+    create(const segment_name& shm_name, const region_layout& layout, const create_options& options = {}) noexcept
+    {
+        return create(shm_name, layout, [](region_directory&) noexcept {}, options);
+    }
+
+    /**
+     * @brief Attaches to a published directory segment and indexes its regions.
+     * @param shm_name The name of the segment to attach to.
+     * @param timeout Maximum time to wait for the creator to publish the segment.
+     * @return The directory, or an error on failure (layout_mismatch if the
+     * table of contents is malformed).
+     */
+    [[nodiscard]] static std::expected<region_directory, error>
+    open(const segment_name& shm_name, const std::chrono::milliseconds timeout) noexcept;
+
+    /**
+     * @brief Looks up a region by name.
+     * @param name The region name.
+     * @return A span over the region, or an empty span if there is no such region.
+     */
+    [[nodiscard]] std::span<std::byte>
+    find(std::string_view name) const noexcept
+    {
+        const auto it = _index.find(name);
+        return it == _index.end() ? std::span<std::byte>{} : it->second;
+    }
+
+    /**
+     * @brief Returns the number of regions in the directory.
+     * @return The region count.
+     */
+    [[nodiscard]] std::size_t
+    count() const noexcept { return _index.size(); }
+
+    /**
+     * @brief Returns the underlying segment.
+     * @return A reference to the mapping hosting every region.
+     */
+    [[nodiscard]] shared_memory&
+    segment() noexcept { return _shm; }
+
+private:
+    [[nodiscard]] static std::expected<region_directory, error>
+    _create_unpublished(const segment_name& shm_name, const region_layout& layout, const create_options& options) noexcept;
+
+    [[nodiscard]] std::expected<void, error>
+    _build_index() noexcept;
+
+    /* Lets find() look up a string_view without building a std::string. */
+    struct name_hash {
+        using is_transparent = void;
+
+        [[nodiscard]] std::size_t
+        operator()(std::string_view name) const noexcept { return std::hash<std::string_view>{}(name); }
+    };
+
+private:
+    shared_memory _shm{};
+    std::unordered_map<std::string, std::span<std::byte>, name_hash, std::equal_to<>> _index{};  // Keys are copies: the table is writable by every process
+};
+
+} // namespace shared_memory
@@ -0,0 +1,128 @@
+/**************************************************************
+ * @file registry.hpp
+ * @brief Process-wide registry that deduplicates shared memory
+ * mappings opened by name.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#pragma once
+
+#if !defined(__linux__)
+#error "shared_memory is only supported on Linux"
+#endif
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <expected>
+#include <functional>
+#include <unordered_map>
+
+#include "shared_memory/error.hpp"
+#include "shared_memory/shared_memory.hpp"
+
+namespace shared_memory {
+
+/**
+ * @brief Process-wide cache of attached shared memory segments.
+ *
+ * Repeated opens of the same name return reference-counted handles to a
+ * single mapping instead of performing shm_open + fstat + mmap each time.
+ * The registry only keeps weak references: the mapping is unmapped when the
+ * last handle is released, exactly as with a plain shared_memory object.
+ *
+ * Entries are keyed by name, with or without its leading slash. If a segment is unlinked and recreated under the
+ * same name while handles to the old mapping are still alive, those handles
+ * keep referring to the old segment; call evict() to force a fresh attach.
+ */
+class registry {
+public:
+    /** @brief Reference-counted handle to a registry-managed mapping. */
+    using handle = std::shared_ptr<shared_memory>;
+
+    /**
+     * @brief Returns the process-wide registry instance.
+     * @return A reference to the singleton registry.
+     */
+    [[nodiscard]] static registry&
+    instance() noexcept;
+
+    /* Non-copyable, non-movable */
+    registry(const registry&) = delete;
+    registry& operator=(const registry&) = delete;
+
+    /**
+     * @brief Attaches to a segment, reusing an existing mapping when one is alive.
+     * @param shm_name The name of the segment to attach to.
+     * @return A shared handle to the mapping, or an error on failure.
+     */
+    [[nodiscard]] std::expected<handle, error>
+    open(std::string_view shm_name) noexcept;
+
+    /**
+     * @brief Drops the cached entry for @p shm_name.
+     *
+     * Existing handles stay valid; the next open() attaches to the segment anew.
+     * @param shm_name The name of the segment to forget.
+     */
+    void
+    evict(std::string_view shm_name) noexcept;
+
+    /**
+     * @brief Returns the number of mappings that currently have live handles.
+     * @return The count of live cached mappings.
+     */
+    [[nodiscard]] std::size_t
+    size() const noexcept;
+
+private:
+    registry() = default;
+
+    struct name_hash {
+        using is_transparent = void;
+
+        [[nodiscard]] std::size_t
+        operator()(std::string_view name) const noexcept { return std::hash<std::string_view>{}(name); }
+    };
+
+    void
+    _sweep_expired() noexcept;
+
+private:
+    mutable std::mutex _mutex{};
+    std::unordered_map<std::string, std::weak_ptr<shared_memory>, name_hash, std::equal_to<>> _entries{};
+};
+
+} // namespace shared_memory
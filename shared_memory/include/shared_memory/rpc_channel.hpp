@@ -0,0 +1,274 @@
+/**************************************************************
+ * @file rpc_channel.hpp
+ * @brief Request/response channel between processes over a region.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#pragma once
+
+#if !defined(__linux__)
+#error "shared_memory is only supported on Linux"
+#endif
+
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <span>
+
+#include "shared_memory/cache_line.hpp"
+#include "shared_memory/error.hpp"
+
+namespace shared_memory {
+
+class rpc_client;
+
+/**
+ * @brief Request/response channel stored in a region.
+ *
+ * The region holds one slot per client, each with a request and a response
+ * buffer of slot_capacity bytes and a state word. A client writes its
+ * request in place and flips the state; the server picks requests up with
+ * serve(), writes the response into the same slot and flips the state back,
+ * so a call costs no copies beyond the payloads and no system calls while
+ * both sides are spinning. Sleeping is opt-in on each side: the server
+ * blocks in wait_for_requests() on a doorbell futex that clients only ring
+ * while a server sleeps, and a client that stops spinning blocks on its
+ * slot's state word, which the server only wakes when flagged.
+ *
+ * Several server threads may call serve() concurrently; each request is
+ * handled once. A client that dies keeps its slot. The object only holds
+ * pointers into the region, which must outlive it and every rpc_client.
+ */
+class rpc_channel {
+public:
+    /** @brief Value of the header magic in a formatted region. */
+    static constexpr std::uint64_t MAGIC{0x5348'4d52'5043'4348};  // "SHMRPCCH"
+
+    /** @brief Constructs a channel bound to no region. */
+    rpc_channel() noexcept = default;
+
+    /**
+     * @brief Returns the region size needed for @p clients slots of @p slot_capacity bytes.
+     * @param clients Maximum number of connected clients.
+     * @param slot_capacity Largest request and largest response in bytes.
+     * @return Bytes required, or SIZE_MAX if that does not fit in a size_t.
+     */
+    [[nodiscard]] static std::size_t
+    required_size(const std::size_t clients, const std::size_t slot_capacity) noexcept;
+
+    /**
+     * @brief Formats @p region as a channel with every slot free.
+     * @param region Cache-line-aligned memory of at least required_size() bytes.
+     * @param clients Maximum number of connected clients (at least 1).
+     * @param slot_capacity Largest request and largest response (at least 1).
+     * @return The channel, or layout_mismatch (ENOSPC if the region is too
+     * small, EINVAL for a misaligned region, bad parameters or a size that
+     * overflows).
+     */
+    [[nodiscard]] static std::expected<rpc_channel, error>
+    create(std::span<std::byte> region, const std::size_t clients, const std::size_t slot_capacity) noexcept;
+
+    /**
+     * @brief Binds to a region formatted by create(), possibly in another process.
+     * @param region The formatted memory.
+     * @return The channel, or layout_mismatch (EPROTO) if the region holds no channel.
+     */
+    [[nodiscard]] static std::expected<rpc_channel, error>
+    attach(std::span<std::byte> region) noexcept;
+
+    /**
+     * @brief Claims a free slot for the calling client.
+     * @return The client, or allocate_failed (ENOSPC) if every slot is taken.
+     */
+    [[nodiscard]] std::expected<rpc_client, error>
+    connect() noexcept;
+
+    /**
+     * @brief Handles every pending request once.
+     *
+     * @p handle receives the request and the slot's response buffer and returns
+     * the response length, which is clamped to the buffer. Requests that
+     * arrive during the scan may wait for the next call. If @p handle throws,
+     * the call fails on the client side and the exception propagates; requests
+     * not yet picked up stay pending.
+     * @param handle Callable taking (std::span<const std::byte>, std::span<std::byte>) and returning std::size_t.
+     * @return The number of requests handled.
+     */
+    template <typename Handler>
+        requires std::invocable<Handler&, std::span<const std::byte>, std::span<std::byte>>
+    std::size_t
+    serve(Handler handle)
+    {
+        std::size_t served = 0;
+        for (auto index = _claim(0); index != NONE; index = _claim(index + 1)) {
+            std::size_t length = 0;
+            try {
+                length = handle(_request(index), _response(index));
+            } catch (...) {
+                /* Nobody else will complete a PROCESSING slot; without this the client waits forever. */
+                _fail(index);
+                throw;
+            }
+            _complete(index, length);
+            ++served;
+        }
+        return served;
+    }
+
+    /**
+     * @brief Blocks until a request is pending.
+     * @param timeout Maximum time to wait; negative values wait indefinitely.
+     * @return true if a request is pending.
+     */
+    [[nodiscard]] bool
+    wait_for_requests(const std::chrono::nanoseconds timeout = std::chrono::nanoseconds(-1)) noexcept;
+
+    /**
+     * @brief Returns the number of slots.
+     * @return The client limit.
+     */
+    [[nodiscard]] std::size_t
+    clients() const noexcept;
+
+    /**
+     * @brief Returns the largest request or response.
+     * @return The slot capacity in bytes.
+     */
+    [[nodiscard]] std::size_t
+    slot_capacity() const noexcept;
+
+private:
+    friend class rpc_client;
+
+    struct channel_header;
+    struct slot_header;
+
+    static constexpr std::size_t NONE{SIZE_MAX};
+
+    rpc_channel(std::span<std::byte> region, channel_header *header) noexcept;
+
+    [[nodiscard]] slot_header *
+    _slot(const std::size_t index) const noexcept;
+
+    [[nodiscard]] std::size_t
+    _claim(const std::size_t from) noexcept;
+
+    [[nodiscard]] std::span<const std::byte>
+    _request(const std::size_t index) const noexcept;
+
+    [[nodiscard]] std::span<std::byte>
+    _response(const std::size_t index) const noexcept;
+
+    void
+    _complete(const std::size_t index, const std::size_t length) noexcept;
+
+    void
+    _fail(const std::size_t index) noexcept;
+
+    void
+    _finish(const std::size_t index, const std::uint32_t response_length) noexcept;
+
+    [[nodiscard]] bool
+    _has_request() const noexcept;
+
+private:
+    channel_header *_header{nullptr};
+    std::byte *_slots{nullptr};
+};
+
+/**
+ * @brief One client's slot in an rpc_channel; releases the slot on destruction.
+ *
+ * Not thread-safe: one call at a time per client. Use one client per thread.
+ */
+class rpc_client {
+public:
+    /** @brief Spin iterations before a call blocks on its slot. */
+    static constexpr unsigned SPINS_BEFORE_WAIT{4096};
+
+    /** @brief Constructs a client bound to no channel. */
+    rpc_client() noexcept = default;
+
+    /** @brief Releases the slot, abandoning a call still in flight. */
+    ~rpc_client() { _release(); }
+
+    rpc_client(const rpc_client&) = delete;
+    rpc_client& operator=(const rpc_client&) = delete;
+
+    rpc_client(rpc_client&& other) noexcept;
+    rpc_client& operator=(rpc_client&& other) noexcept;
+
+    /**
+     * @brief Sends @p request and waits for the server's response.
+     *
+     * Spins for SPINS_BEFORE_WAIT iterations, then sleeps on the slot until
+     * the server completes the call. After a timeout the call stays in
+     * flight; the next call first waits for and discards its response.
+     * @param request The request payload.
+     * @param response Receives the response payload.
+     * @param timeout Maximum time to wait; negative values wait indefinitely.
+     * @return The response length, allocate_failed (EMSGSIZE) if the request
+     * exceeds the slot, read_failed (EMSGSIZE) if the response does not fit in
+     * @p response, read_failed (EREMOTEIO) if the server's handler threw, or
+     * wait_failed (ETIMEDOUT).
+     */
+    [[nodiscard]] std::expected<std::size_t, error>
+    call(std::span<const std::byte> request, std::span<std::byte> response, const std::chrono::nanoseconds timeout = std::chrono::nanoseconds(-1)) noexcept;
+
+    /**
+     * @brief Returns this client's slot index.
+     * @return The index, unique among connected clients.
+     */
+    [[nodiscard]] std::size_t
+    slot() const noexcept { return _index; }
+
+private:
+    friend class rpc_channel;
+
+    rpc_client(const rpc_channel& channel, const std::size_t index) noexcept;
+
+    [[nodiscard]] std::expected<void, error>
+    _await_response(const std::chrono::steady_clock::time_point deadline) noexcept;
+
+    void
+    _release() noexcept;
+
+private:
+    rpc_channel _channel{};
+    std::size_t _index{rpc_channel::NONE};
+    bool _in_flight{false};
+};
+
+} // namespace shared_memory
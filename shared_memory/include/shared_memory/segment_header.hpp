@@ -0,0 +1,183 @@
+/**************************************************************
+ * @file segment_header.hpp
+ * @brief Standard segment header with a ready handshake so readers
+ * never attach to half-initialized segments.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#pragma once
+
+#if !defined(__linux__)
+#error "shared_memory is only supported on Linux"
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <new>
+#include <span>
+#include <utility>
+
+#include "shared_memory/cache_line.hpp"
+#include "shared_memory/error.hpp"
+#include "shared_memory/segment_name.hpp"
+#include "shared_memory/shared_memory.hpp"
+
+namespace shared_memory {
+
+/**
+ * @brief Publication state of a segment, stored in segment_header::state.
+ *
+ * A freshly truncated segment reads as EMPTY because tmpfs pages are zero-filled.
+ */
+enum class segment_state : std::uint32_t {
+    EMPTY = 0,
+    INITIALIZING = 1,
+    READY = 2
+};
+
+/**
+ * @brief Fixed header placed at offset 0 of a published segment.
+ *
+ * The creator fills the descriptive fields, initializes the payload and then
+ * flips @c state to READY with release semantics. Readers wait on @c state
+ * (a futex word) and validate the remaining fields before touching the payload.
+ */
+struct alignas(CACHE_LINE_SIZE) segment_header {
+    /** @brief Value of @c magic in a segment created by create_published(). */
+    static constexpr std::uint64_t MAGIC{0x5348'4d5f'4844'5231};  // "SHM_HDR1"
+
+    /** @brief Version of this header format. */
+    static constexpr std::uint32_t FORMAT{1};
+
+    std::uint64_t magic{0};
+    std::uint64_t layout{0};       // Caller-defined layout version or hash
+    std::uint64_t size{0};         // Total segment size in bytes, header included
+    std::int32_t creator_pid{0};
+    std::uint32_t format{0};
+    std::atomic<std::uint32_t> state{std::to_underlying(segment_state::EMPTY)};
+};
+
+/** @brief Offset of the payload that follows the header. */
+inline constexpr std::size_t HEADER_SIZE{sizeof(segment_header)};
+
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "segment_header::state must be lock-free to be shared across processes");
+
+/**
+ * @brief Returns the header of a published segment.
+ * @param shm A mapping at least HEADER_SIZE bytes long.
+ * @return A reference to the header at offset 0.
+ */
+[[nodiscard]] inline segment_header&
+header_of(shared_memory& shm) noexcept
+{
+    return *std::launder(reinterpret_cast<segment_header *>(shm.get_memory().data()));
+}
+
+/**
+ * @brief Returns the payload that follows the header.
+ * @param shm A published segment.
+ * @return A span over everything after the header, or an empty span if the mapping is too small.
+ */
+[[nodiscard]] inline std::span<std::byte>
+payload(shared_memory& shm) noexcept
+{
+    if (shm.size() <= HEADER_SIZE) {
+        return {};
+    }
+
+    return shm.view(HEADER_SIZE, shm.size() - HEADER_SIZE);
+}
+
+/**
+ * @brief Creates a segment and writes its header with state INITIALIZING.
+ *
+ * Building block of create_published(); call publish() once the payload is initialized.
+ * @param shm_name The name of the segment (leading slash is optional).
+ * @param payload_size Number of payload bytes after the header.
+ * @param layout Caller-defined layout version or hash that readers must match.
+ * @param options Access mode, unlink and population settings.
+ * @return The shared_memory object, or an error on failure.
+ */
+[[nodiscard]] std::expected<shared_memory, error>
+create_unpublished(const segment_name& shm_name, const std::size_t payload_size, const std::uint64_t layout, const create_options& options = {}) noexcept;
+
+/**
+ * @brief Marks a segment READY and wakes every process waiting in open_published().
+ * @param shm A segment returned by create_unpublished().
+ */
+void
+publish(shared_memory& shm) noexcept;
+
+/**
+ * @brief Creates a segment, initializes its payload and publishes it.
+ * @param shm_name The name of the segment (leading slash is optional).
+ * @param payload_size Number of payload bytes after the header.
+ * @param layout Caller-defined layout version or hash that readers must match.
+ * @param init Callable invoked with the payload span before publication.
+ * @param options Access mode, unlink and population settings.
+ * @return The published shared_memory object, or an error on failure.
+ */
+template <typename Init>
+[[nodiscard]] std::expected<shared_memory, error>
+create_published(const segment_name& shm_name, const std::size_t payload_size, const std::uint64_t layout, Init&& init, const create_options& options = {})
+{
+    auto shm = create_unpublished(shm_name, payload_size, layout, options);
+    if (!shm) {
+        return shm;
+    }
+
+    std::forward<Init>(init)(payload(*shm));
+    publish(*shm);
+
+    return shm;
+}
+
+/**
+ * @brief Attaches to a published segment, waiting until its creator has published it.
+ *
+ * Retries while the segment does not exist yet or is still being truncated,
+ * then blocks on the header's futex word until the state becomes READY, and
+ * finally validates magic, header format, @p layout and size in one step.
+ * @param shm_name The name of the segment to attach to.
+ * @param layout Layout version or hash the creator must have used.
+ * @param timeout Maximum time to wait for the segment to appear and become ready.
+ * @return The shared_memory object, wait_failed (ETIMEDOUT) if it did not become
+ * ready in time, or layout_mismatch (EPROTO) if validation failed.
+ */
+[[nodiscard]] std::expected<shared_memory, error>
+open_published(const segment_name& shm_name, const std::uint64_t layout, const std::chrono::milliseconds timeout) noexcept;
+
+} // namespace shared_memory
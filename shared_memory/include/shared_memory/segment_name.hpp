@@ -0,0 +1,161 @@
+/**************************************************************
+ * @file segment_name.hpp
+ * @brief Fixed-capacity, allocation-free name of a POSIX shared
+ * memory segment.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#pragma once
+
+#if !defined(__linux__)
+#error "shared_memory is only supported on Linux"
+#endif
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <string_view>
+
+#include <climits>
+
+#include "shared_memory/error.hpp"
+
+namespace shared_memory {
+
+/**
+ * @brief Inline, NAME_MAX-bounded name of a shared memory segment.
+ *
+ * Holds the name in a fixed buffer so that creating or attaching segments
+ * never touches the allocator. String literals are validated at compile time;
+ * runtime strings go through make(). A valid name is non-empty, at most
+ * CAPACITY bytes long and contains no '/' other than an optional leading one.
+ */
+class segment_name {
+public:
+    /** @brief Maximum number of characters in a name, excluding the terminator. */
+    static constexpr std::size_t CAPACITY{NAME_MAX};
+
+    /** @brief Constructs an empty name. */
+    constexpr segment_name() noexcept = default;
+
+    /**
+     * @brief Constructs a name from a string literal, validated at compile time.
+     * @param literal The segment name (leading slash is optional).
+     */
+    template <std::size_t N>
+    explicit consteval segment_name(const char (&literal)[N])
+    {
+        const std::string_view name(literal, N - 1);
+        if (!is_valid(name)) {
+            throw "segment_name: literal is empty, too long or contains '/' or NUL";
+        }
+        _assign(name);
+    }
+
+    /**
+     * @brief Builds a name from a runtime string.
+     * @param name The segment name (leading slash is optional).
+     * @return The name, or an open_failed error carrying ENAMETOOLONG or EINVAL.
+     */
+    [[nodiscard]] static std::expected<segment_name, error>
+    make(std::string_view name) noexcept;
+
+    /**
+     * @brief Checks whether @p name is acceptable as a segment name.
+     * @param name The candidate name.
+     * @return true if the name is non-empty, fits and has no interior '/' or NUL.
+     */
+    [[nodiscard]] static constexpr bool
+    is_valid(std::string_view name) noexcept
+    {
+        if (name.empty() || name.size() > CAPACITY) {
+            return false;
+        }
+
+        const std::string_view body = name.front() == '/' ? name.substr(1) : name;
+
+        return !body.empty() && body.find('/') == std::string_view::npos && body.find('\0') == std::string_view::npos;
+    }
+
+    /**
+     * @brief Returns the name as a NUL-terminated string.
+     * @return A pointer to the inline buffer.
+     */
+    [[nodiscard]] constexpr const char *
+    c_str() const noexcept { return _data.data(); }
+
+    /**
+     * @brief Returns the name as a string view.
+     * @return A view over the name, excluding the terminator.
+     */
+    [[nodiscard]] constexpr std::string_view
+    view() const noexcept { return {_data.data(), _size}; }
+
+    /**
+     * @brief Returns the length of the name.
+     * @return The number of characters, excluding the terminator.
+     */
+    [[nodiscard]] constexpr std::size_t
+    size() const noexcept { return _size; }
+
+    /**
+     * @brief Checks whether the name is empty.
+     * @return true for a default-constructed name.
+     */
+    [[nodiscard]] constexpr bool
+    empty() const noexcept { return _size == 0; }
+
+    /** @brief Equality comparison. */
+    [[nodiscard]] constexpr bool
+    operator==(const segment_name& other) const noexcept { return view() == other.view(); }
+
+private:
+    constexpr void
+    _assign(std::string_view name) noexcept
+    {
+        for (std::size_t i = 0; i < name.size(); ++i) {
+            _data[i] = name[i];
+        }
+        _data[name.size()] = '\0';
+        _size = static_cast<std::uint8_t>(name.size());
+    }
+
+private:
+    std::array<char, CAPACITY + 1> _data{};
+    std::uint8_t _size{0};
+};
+
+static_assert(segment_name::CAPACITY <= UINT8_MAX, "segment_name length must fit in its size field");
+
+} // namespace shared_memory
@@ -42,10 +42,11 @@
 
 #include <span>
 #include <cstddef>
-#include <string>
+#include <string_view>
 #include <expected>
 #include <utility>
 #include <algorithm>
+#include <filesystem>
 
 #include <fcntl.h>
 #include <sys/mman.h>
@@ -54,6 +55,8 @@
 #include <unistd.h>
 
 #include "shared_memory/error.hpp"
+#include "shared_memory/owned_fd.hpp"
+#include "shared_memory/segment_name.hpp"
 
 namespace shared_memory {
 
@@ -68,6 +71,158 @@ enum class access_mode : mode_t {
     READ_WRITE = S_IRUSR | S_IWUSR
 };
 
+/**
+ * @brief Tunables for creating a shared memory segment.
+ *
+ * The defaults match create(name, size): read-write, unlinked on destruction,
+ * pages populated lazily on first touch.
+ */
+struct create_options {
+    /** @brief Access mode for the segment. */
+    access_mode mode{access_mode::READ_WRITE};
+
+    /**
+     * @brief If true, unlinks the segment on destruction.
+     *
+     * The handle keeps the segment's descriptor rather than its name and reads
+     * the name back through /proc/self/fd, so a segment someone else already
+     * unlinked (and perhaps recreated) is left alone.
+     */
+    bool should_unlink{true};
+
+    /** @brief If true, faults in every page at creation so first touches do not stall. */
+    bool prefault{false};
+
+    /**
+     * @brief If true, reserves every page with fallocate right after truncation.
+     *
+     * A full /dev/shm then fails create() with allocate_failed (ENOSPC) instead
+     * of raising SIGBUS on a later first write, and first writes no longer enter
+     * the page allocator.
+     */
+    bool preallocate{false};
+
+    /** @brief If true, the mapping is released on the reaper thread (see set_deferred_unmap()). */
+    bool deferred_unmap{false};
+
+    /** @brief If true, keeps the segment file descriptor open for fd-based operations. */
+    bool retain_fd{false};
+};
+
+/**
+ * @brief Tunables for attaching to an existing shared memory segment.
+ *
+ * The defaults match open(name).
+ */
+struct open_options {
+    /** @brief If true, keeps the segment file descriptor open for fd-based operations. */
+    bool retain_fd{false};
+};
+
+/**
+ * @brief Tunables for mapping a regular file with map_file().
+ */
+struct file_options {
+    /** @brief Access mode for the mapping, and the file permissions if it is created. */
+    access_mode mode{access_mode::READ_WRITE};
+
+    /** @brief If true, creates the file when it does not exist. */
+    bool create{true};
+
+    /** @brief If true, faults in every page after mapping so first touches do not stall. */
+    bool prefault{false};
+
+    /**
+     * @brief If true, allocates file blocks for the whole mapping with fallocate.
+     *
+     * A full file system then fails map_file() with allocate_failed (ENOSPC)
+     * instead of raising SIGBUS on a later first write.
+     */
+    bool preallocate{false};
+
+    /** @brief If true, the mapping is released on the reaper thread (see set_deferred_unmap()). */
+    bool deferred_unmap{false};
+
+    /** @brief If true, keeps the file descriptor open for fd-based operations. */
+    bool retain_fd{false};
+};
+
+/**
+ * @brief Tunables for writing a segment to a file with checkpoint().
+ *
+ * The defaults suit large segments on local NVMe.
+ */
+struct checkpoint_options {
+    /** @brief Bytes per write request; rounded up to the page size and capped at 1 GiB. */
+    std::size_t chunk_size{std::size_t{4} << 20};
+
+    /** @brief Maximum number of write requests in flight. */
+    unsigned queue_depth{16};
+
+    /** @brief If true, bypasses the page cache with O_DIRECT when the file system supports it. */
+    bool direct_io{true};
+
+    /** @brief If true, submits writes through io_uring when the kernel allows it. */
+    bool use_io_uring{true};
+
+    /** @brief If true, flushes the file with fdatasync before returning. */
+    bool sync{true};
+
+    /**
+     * @brief If true, writes only pages that were ever written and leaves the rest as file holes.
+     *
+     * The segment is queried with SEEK_DATA / SEEK_HOLE through its descriptor,
+     * reopening it by name when none was retained; a reopened object is only
+     * trusted if /proc/self/map_files shows it is the mapped one. Where that is impossible,
+     * mincore() residency is used for shm segments on systems without swap;
+     * otherwise everything is written.
+     */
+    bool skip_holes{true};
+};
+
+/**
+ * @brief How restore() turns a checkpoint file back into shared memory.
+ */
+enum class restore_mode {
+    /** @brief Create a named segment and read the file into it. */
+    COPY,
+
+    /**
+     * @brief Map the file itself with MAP_SHARED.
+     *
+     * Startup costs no reads, but the mapping is file-backed: pages fault in
+     * from storage, writes go back to the file, and the result has no
+     * segment name for other processes to open.
+     */
+    MAPPED_FILE
+};
+
+/**
+ * @brief Tunables for restore().
+ */
+struct restore_options {
+    /** @brief Whether to copy into a new segment or map the file directly. */
+    restore_mode mode{restore_mode::COPY};
+
+    /** @brief Settings for the segment; access mode, prefault, deferred unmap and retain_fd also apply to MAPPED_FILE. */
+    create_options segment{};
+
+    /** @brief Bytes per read request; rounded up to the page size and capped at 1 GiB. */
+    std::size_t chunk_size{std::size_t{4} << 20};
+
+    /** @brief Maximum number of read requests in flight. */
+    unsigned queue_depth{16};
+
+    /** @brief If true, bypasses the page cache with O_DIRECT when the file system supports it. */
+    bool direct_io{true};
+
+    /** @brief If true, submits reads through io_uring when the kernel allows it. */
+    bool use_io_uring{true};
+
+    /** @brief If true, COPY skips holes in the file (SEEK_DATA / SEEK_HOLE) so those pages are never populated. */
+    bool skip_holes{true};
+};
+
 /**
  * @brief RAII wrapper for POSIX shared memory.
  *
@@ -79,9 +234,13 @@ class shared_memory {
 public:
     /** @brief Constructs an empty shared_memory object with no mapping. */
     shared_memory() noexcept
-    : _name(""),
-      _mem_view({}),
-      _should_unlink(false)
+    : _mem_view({}),
+      _map_offset(0),
+      _should_unlink(false),
+      _deferred_unmap(false),
+      _named(false),
+      _fd(),
+      _unlink_fd()
     {}
 
     /** @brief Destructor. Unmaps memory and optionally unlinks the segment if owning. */
@@ -93,9 +252,13 @@ public:
 
     /** @brief Move constructor. Transfers ownership of the mapping from the source. */
     shared_memory(shared_memory&& other) noexcept
-    : _name(std::move(other._name)),
-      _mem_view(std::exchange(other._mem_view, {})),
-      _should_unlink(std::exchange(other._should_unlink, false))
+    : _mem_view(std::exchange(other._mem_view, {})),
+      _map_offset(std::exchange(other._map_offset, 0)),
+      _should_unlink(std::exchange(other._should_unlink, false)),
+      _deferred_unmap(std::exchange(other._deferred_unmap, false)),
+      _named(std::exchange(other._named, false)),
+      _fd(std::move(other._fd)),
+      _unlink_fd(std::move(other._unlink_fd))
     {}
 
     /** @brief Move assignment. Unmaps current mapping and takes ownership from @p other. */
@@ -107,9 +270,13 @@ public:
 
         _close_shm();
 
-        _name = std::move(other._name);
         _mem_view = std::exchange(other._mem_view, {});
+        _map_offset = std::exchange(other._map_offset, 0);
         _should_unlink = std::exchange(other._should_unlink, false);
+        _deferred_unmap = std::exchange(other._deferred_unmap, false);
+        _named = std::exchange(other._named, false);
+        _fd = std::move(other._fd);
+        _unlink_fd = std::move(other._unlink_fd);
 
         return *this;
     }
@@ -123,7 +290,25 @@ public:
      * @return The shared_memory object, or an error on failure.
      */
     [[nodiscard]] static std::expected<shared_memory, error>
-    create(std::string shm_name, const std::size_t size, access_mode mode = access_mode::READ_WRITE, const bool should_unlink = true) noexcept;
+    create(const segment_name& shm_name, const std::size_t size, access_mode mode = access_mode::READ_WRITE, const bool should_unlink = true) noexcept;
+
+    /**
+     * @brief Creates a new shared memory segment from a runtime name.
+     *
+     * Validates @p shm_name with segment_name::make() and forwards to the overload above.
+     */
+    [[nodiscard]] static std::expected<shared_memory, error>
+    create(std::string_view shm_name, const std::size_t size, access_mode mode = access_mode::READ_WRITE, const bool should_unlink = true) noexcept;
+
+    /**
+     * @brief Creates a new shared memory segment with explicit options and takes ownership.
+     * @param shm_name The name of the segment (leading slash is optional).
+     * @param size The size of the segment in bytes.
+     * @param options Access mode, unlink and population settings.
+     * @return The shared_memory object, or an error on failure.
+     */
+    [[nodiscard]] static std::expected<shared_memory, error>
+    create(const segment_name& shm_name, const std::size_t size, const create_options& options) noexcept;
 
     /**
      * @brief Opens an existing shared memory segment (non-owning).
@@ -131,7 +316,171 @@ public:
      * @return The shared_memory object, or an error on failure.
      */
     [[nodiscard]] static std::expected<shared_memory, error>
-    open(std::string shm_name) noexcept;
+    open(const segment_name& shm_name) noexcept;
+
+    /**
+     * @brief Opens an existing shared memory segment from a runtime name (non-owning).
+     *
+     * Validates @p shm_name with segment_name::make() and forwards to the overload above.
+     */
+    [[nodiscard]] static std::expected<shared_memory, error>
+    open(std::string_view shm_name) noexcept;
+
+    /**
+     * @brief Opens an existing shared memory segment with explicit options (non-owning).
+     * @param shm_name The name of the segment to attach to.
+     * @param options Descriptor retention settings.
+     * @return The shared_memory object, or an error on failure.
+     */
+    [[nodiscard]] static std::expected<shared_memory, error>
+    open(const segment_name& shm_name, const open_options& options) noexcept;
+
+    /**
+     * @brief Maps a segment from a file descriptor received from another process (non-owning).
+     *
+     * The descriptor is retained, so every fd-based operation is available on the result.
+     * @param shm_fd Descriptor of a shared memory segment, e.g. received over SCM_RIGHTS.
+     * @return The shared_memory object, or an error on failure.
+     */
+    [[nodiscard]] static std::expected<shared_memory, error>
+    adopt(owned_fd shm_fd) noexcept;
+
+    /**
+     * @brief Maps a regular file with MAP_SHARED instead of a shm object.
+     *
+     * Contents survive reboots once written back; see persistent_segment for
+     * controlled flushing. The result has no segment name: other processes
+     * share it by mapping the same path.
+     * @param path The file to map.
+     * @param size Bytes to map; the file is extended if shorter. 0 maps the
+     * whole existing file.
+     * @param options Access mode, creation and population settings.
+     * @return The shared_memory object, or open_failed / stat_failed /
+     * truncate_failed / allocate_failed / map_failed / populate_failed.
+     */
+    [[nodiscard]] static std::expected<shared_memory, error>
+    map_file(const std::filesystem::path& path, const std::size_t size = 0, const file_options& options = {}) noexcept;
+
+    /**
+     * @brief Opens a byte range of an existing shared memory segment (non-owning).
+     *
+     * Only the pages covering [offset, offset+length) are mapped. The offset does
+     * not need to be page-aligned; the returned view starts exactly at @p offset.
+     * @param shm_name The name of the segment to attach to.
+     * @param offset Byte offset of the range within the segment.
+     * @param length Number of bytes to map (must be non-zero).
+     * @return The shared_memory object, or an error on failure (EINVAL if the
+     * range is empty or extends past the end of the segment).
+     */
+    [[nodiscard]] static std::expected<shared_memory, error>
+    open_range(const segment_name& shm_name, const std::size_t offset, const std::size_t length) noexcept;
+
+    /**
+     * @brief Opens a byte range of an existing segment from a runtime name (non-owning).
+     *
+     * Validates @p shm_name with segment_name::make() and forwards to the overload above.
+     */
+    [[nodiscard]] static std::expected<shared_memory, error>
+    open_range(std::string_view shm_name, const std::size_t offset, const std::size_t length) noexcept;
+
+    /**
+     * @brief Creates a segment from a checkpoint() file.
+     *
+     * In COPY mode the segment is sized to the file and filled with up to
+     * queue_depth reads in flight through io_uring, straight into buffers
+     * registered over the new mapping, or with a pread loop when io_uring is
+     * unavailable. A segment that cannot be filled is unlinked. In MAPPED_FILE
+     * mode the file is mapped instead and @p shm_name is not used.
+     * @param path The checkpoint file.
+     * @param shm_name The name of the segment to create.
+     * @param options Restore mode and I/O settings.
+     * @return The shared_memory object, or open_failed (EINVAL for a read-only
+     * COPY), stat_failed, a create() error, map_failed or read_failed.
+     */
+    [[nodiscard]] static std::expected<shared_memory, error>
+    restore(const std::filesystem::path& path, const segment_name& shm_name, const restore_options& options = {}) noexcept;
+
+    /**
+     * @brief Creates a segment from a checkpoint file with a runtime name.
+     *
+     * Validates @p shm_name with segment_name::make() and forwards to the overload above.
+     */
+    [[nodiscard]] static std::expected<shared_memory, error>
+    restore(const std::filesystem::path& path, std::string_view shm_name, const restore_options& options = {}) noexcept;
+
+    /**
+     * @brief Returns the retained segment file descriptor without transferring ownership.
+     * @return The descriptor, or owned_fd::INVALID_FD if none was retained.
+     */
+    [[nodiscard]] int
+    fd() const noexcept { return _fd.get(); }
+
+    /**
+     * @brief Queries the segment through the retained descriptor.
+     * @return The fstat result, or stat_failed (EBADF if no descriptor was retained).
+     */
+    [[nodiscard]] std::expected<struct stat, error>
+    stat() const noexcept;
+
+    /**
+     * @brief Duplicates the retained descriptor, e.g. to pass it to another process.
+     * @return A new close-on-exec descriptor, or open_failed (EBADF if none was retained).
+     */
+    [[nodiscard]] std::expected<owned_fd, error>
+    duplicate_fd() const noexcept;
+
+    /**
+     * @brief Changes the segment size and remaps this handle to match.
+     *
+     * Other processes keep their existing mapping length until they remap.
+     * The mapping may move, so previously obtained spans are invalidated.
+     * @param new_size The new size of the segment in bytes (must be non-zero).
+     * @return Nothing on success, or truncate_failed / map_failed (EBADF if no
+     * descriptor was retained, EINVAL for a range mapping or a zero size).
+     */
+    [[nodiscard]] std::expected<void, error>
+    resize(const std::size_t new_size) noexcept;
+
+    /**
+     * @brief Reserves backing pages for a byte range through the retained descriptor.
+     *
+     * Typically used after resize() to preallocate the newly added tail.
+     * @param offset Byte offset of the range within the segment.
+     * @param length Number of bytes to reserve (must be non-zero).
+     * @return Nothing on success, or allocate_failed (EBADF if no descriptor was
+     * retained, EINVAL for a zero length, a range reaching past size() or a
+     * range mapping).
+     */
+    [[nodiscard]] std::expected<void, error>
+    allocate(const std::size_t offset, const std::size_t length) noexcept;
+
+    /**
+     * @brief Creates a private copy-on-write mapping of the whole segment.
+     *
+     * Writes through the returned handle never reach the segment. Pages that
+     * have not been written yet still reflect the shared contents.
+     * @return The private shared_memory object, or an error on failure.
+     */
+    [[nodiscard]] std::expected<shared_memory, error>
+    map_private() const noexcept;
+
+    /**
+     * @brief Writes the mapped contents to a regular file.
+     *
+     * The file is created or truncated to size(). Chunks go through io_uring
+     * with up to queue_depth writes in flight, using buffers registered over
+     * the mapping itself when RLIMIT_MEMLOCK allows, and fall back to a pwrite
+     * loop when io_uring is unavailable. Writers that keep modifying the
+     * segment meanwhile produce a file mixing old and new bytes; quiesce them
+     * for a consistent image. Pages never written are skipped and left as holes
+     * in a sparse file (see checkpoint_options::skip_holes), without faulting
+     * them into memory.
+     * @param path Destination file.
+     * @param options Chunking, O_DIRECT, io_uring and sync settings.
+     * @return Nothing on success, or open_failed / truncate_failed / write_failed.
+     */
+    [[nodiscard]] std::expected<void, error>
+    checkpoint(const std::filesystem::path& path, const checkpoint_options& options = {}) const noexcept;
 
     /**
      * @brief Returns the size of the mapped memory region in bytes.
@@ -160,6 +509,32 @@ public:
     [[nodiscard]] std::span<const std::byte> 
     get_memory() const noexcept { return _mem_view; }
 
+    /**
+     * @brief Chooses whether destruction unmaps inline or on the background reaper thread.
+     *
+     * Unmapping a large, heavily-touched segment triggers TLB shootdowns on every
+     * core and can take milliseconds. With deferral enabled the munmap runs on a
+     * process-wide reaper thread instead of the thread dropping the handle. The
+     * shm_unlink of an owning handle still happens inline so the name can be
+     * reused immediately. If the reaper cannot accept work the unmap runs inline.
+     * @param enabled true to defer the unmap, false to unmap inline (the default).
+     */
+    void
+    set_deferred_unmap(const bool enabled) noexcept { _deferred_unmap = enabled; }
+
+    /**
+     * @brief Checks whether destruction defers the unmap to the reaper thread.
+     * @return true if set_deferred_unmap(true) was called or requested at creation.
+     */
+    [[nodiscard]] bool
+    deferred_unmap() const noexcept { return _deferred_unmap; }
+
+    /**
+     * @brief Blocks until every deferred unmap queued so far has completed.
+     */
+    static void
+    drain_deferred_unmaps() noexcept;
+
     /**
      * @brief Writes data into the shared memory at the given offset.
      * @param offset Byte offset at which to write.
@@ -212,10 +587,10 @@ public:
 
 private:
 
-    explicit shared_memory(std::string name, std::span<std::byte> mem_view, bool should_unlink) noexcept
-    : _name(std::move(name)),
-      _mem_view(mem_view),
-      _should_unlink(should_unlink)
+    explicit shared_memory(std::span<std::byte> mem_view, bool named, std::size_t map_offset = 0) noexcept
+    : _mem_view(mem_view),
+      _map_offset(map_offset),
+      _named(named)
     {}
 
     [[nodiscard]] bool 
@@ -224,22 +599,39 @@ private:
         return count <= _mem_view.size() && offset <= (_mem_view.size() - count);
     }
 
+    [[nodiscard]] static bool
+    _defer_unmap(void *addr, const std::size_t length) noexcept;
+
+    void
+    _unlink() const noexcept;
+
     void 
     _close_shm() noexcept 
     {
         if (!_mem_view.empty()) {
-            munmap(_mem_view.data(), _mem_view.size());
+            void *addr = _mem_view.data() - _map_offset;
+            const std::size_t length = _mem_view.size() + _map_offset;
+
+            if (!_deferred_unmap || !_defer_unmap(addr, length)) {
+                munmap(addr, length);
+            }
         }
 
         if (_should_unlink) {
-            shm_unlink(_name.c_str());
+            _unlink();
         }
     }
 
 private:
-    std::string _name{};
     std::span<std::byte> _mem_view{};
+    std::size_t _map_offset{0};  // Distance from the page-aligned mapping start to _mem_view
     bool _should_unlink{false};
+    bool _deferred_unmap{false};
+    bool _named{false};  // Backed by a POSIX shm object, so residency equals population without swap
+    owned_fd _fd{};  // Retained only on request (create_options / open_options / adopt)
+    owned_fd _unlink_fd{};  // Kept by owners without a retained _fd to find the name to unlink
 };
 
+static_assert(sizeof(shared_memory) <= 40, "shared_memory handles must stay small; keep the name out of the handle");
+
 } // namespace shared_memory
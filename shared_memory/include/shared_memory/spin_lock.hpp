@@ -0,0 +1,114 @@
+/**************************************************************
+ * @file spin_lock.hpp
+ * @brief Process-shared spin lock that can live inside a segment.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#pragma once
+
+#if !defined(__linux__)
+#error "shared_memory is only supported on Linux"
+#endif
+
+#include <atomic>
+#include <cstdint>
+
+#include <sched.h>
+
+namespace shared_memory {
+
+/**
+ * @brief Test-and-test-and-set lock stored directly in shared memory.
+ *
+ * Zero-initialized memory is an unlocked lock, so it can be placed in a
+ * freshly truncated segment without construction. Meets the Lockable
+ * requirements, so it works with std::scoped_lock. A process that dies
+ * while holding the lock leaves it held; keep critical sections short and
+ * free of anything that can fail.
+ */
+class spin_lock {
+public:
+    /** @brief Spins before each sched_yield while the lock stays contended. */
+    static constexpr unsigned SPINS_BEFORE_YIELD{128};
+
+    /** @brief Acquires the lock, spinning and then yielding while it is held elsewhere. */
+    void
+    lock() noexcept
+    {
+        while (_locked.exchange(1, std::memory_order_acquire) != 0) {
+            unsigned spins{0};
+            while (_locked.load(std::memory_order_relaxed) != 0) {
+                if (++spins < SPINS_BEFORE_YIELD) {
+                    cpu_relax();
+                } else {
+                    sched_yield();
+                    spins = 0;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Acquires the lock if it is free.
+     * @return true if the lock was acquired.
+     */
+    [[nodiscard]] bool
+    try_lock() noexcept
+    {
+        return _locked.load(std::memory_order_relaxed) == 0 && _locked.exchange(1, std::memory_order_acquire) == 0;
+    }
+
+    /** @brief Releases the lock. */
+    void
+    unlock() noexcept { _locked.store(0, std::memory_order_release); }
+
+    /**
+     * @brief Tells the CPU the caller is in a spin-wait loop.
+     */
+    static void
+    cpu_relax() noexcept
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield" ::: "memory");
+#endif
+    }
+
+private:
+    std::atomic<std::uint32_t> _locked{0};
+};
+
+static_assert(sizeof(spin_lock) == sizeof(std::uint32_t), "spin_lock must stay a single futex-sized word");
+
+} // namespace shared_memory
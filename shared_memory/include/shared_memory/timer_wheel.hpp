@@ -0,0 +1,239 @@
+/**************************************************************
+ * @file timer_wheel.hpp
+ * @brief Hierarchical timer wheel shared across processes.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#pragma once
+
+#if !defined(__linux__)
+#error "shared_memory is only supported on Linux"
+#endif
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <span>
+
+#include "shared_memory/cache_line.hpp"
+#include "shared_memory/error.hpp"
+
+namespace shared_memory {
+
+/**
+ * @brief Identifies a scheduled timer; stale once the timer fires or is cancelled.
+ */
+struct timer_handle {
+    std::uint32_t index;
+    std::uint32_t generation;
+
+    friend bool operator==(const timer_handle&, const timer_handle&) = default;
+};
+
+/**
+ * @brief A timer delivered by timer_wheel::advance().
+ */
+struct expired_timer {
+    timer_handle handle;
+    std::uint64_t deadline;
+    std::uint64_t payload;
+};
+
+/**
+ * @brief Hierarchical timing wheel stored in a region.
+ *
+ * Time is measured in caller-defined ticks, for example milliseconds of
+ * CLOCK_MONOTONIC, which is the same in every process. Any process may
+ * schedule or cancel timers in O(1); one driver process calls advance() to
+ * move time forward and collect expired timers. Timers live in a fixed pool
+ * of entries linked by index into per-slot lists, and every operation runs
+ * under a spin lock stored in the region. Deadlines beyond the wheel range
+ * are parked in the last level and re-placed as time approaches them. The
+ * object only holds pointers into the region, which must outlive it.
+ */
+class timer_wheel {
+public:
+    /** @brief Value of the header magic in a formatted region. */
+    static constexpr std::uint64_t MAGIC{0x5449'4d45'5257'484c};  // "TIMERWHL"
+
+    /** @brief Number of wheel levels. */
+    static constexpr std::size_t LEVELS{4};
+
+    /** @brief log2 of the number of slots per level. */
+    static constexpr std::size_t SLOT_BITS{6};
+
+    /** @brief Number of slots per level. */
+    static constexpr std::size_t SLOTS_PER_LEVEL{std::size_t{1} << SLOT_BITS};
+
+    /** @brief Ticks covered by the wheel before deadlines are parked. */
+    static constexpr std::uint64_t RANGE{std::uint64_t{1} << (SLOT_BITS * LEVELS)};
+
+    /** @brief Constructs a wheel bound to no region. */
+    timer_wheel() noexcept = default;
+
+    /**
+     * @brief Returns the region size needed for @p capacity concurrent timers.
+     * @param capacity Maximum number of pending timers.
+     * @return Bytes required.
+     */
+    [[nodiscard]] static std::size_t
+    required_size(const std::size_t capacity) noexcept;
+
+    /**
+     * @brief Formats @p region as an empty wheel.
+     * @param region Cache-line-aligned memory of at least required_size() bytes.
+     * @param capacity Maximum number of pending timers (at least 1).
+     * @param now Current tick.
+     * @return The wheel, or layout_mismatch (ENOSPC if the region is too
+     * small, EINVAL for a misaligned region or a bad capacity).
+     */
+    [[nodiscard]] static std::expected<timer_wheel, error>
+    create(std::span<std::byte> region, const std::size_t capacity, const std::uint64_t now) noexcept;
+
+    /**
+     * @brief Binds to a region formatted by create(), possibly in another process.
+     * @param region The formatted memory.
+     * @return The wheel, or layout_mismatch (EPROTO) if the region holds no wheel.
+     */
+    [[nodiscard]] static std::expected<timer_wheel, error>
+    attach(std::span<std::byte> region) noexcept;
+
+    /**
+     * @brief Schedules a timer.
+     * @param deadline Tick at which the timer expires; past deadlines expire on the next advance().
+     * @param payload Value returned with the expired timer.
+     * @return The handle, or allocate_failed (ENOSPC) if every entry is in use.
+     */
+    [[nodiscard]] std::expected<timer_handle, error>
+    schedule(const std::uint64_t deadline, const std::uint64_t payload) noexcept;
+
+    /**
+     * @brief Cancels a pending timer.
+     * @param handle Handle returned by schedule().
+     * @return true if the timer was pending; false if it already fired or was cancelled.
+     */
+    bool
+    cancel(const timer_handle handle) noexcept;
+
+    /**
+     * @brief Moves time forward to @p now and collects expired timers.
+     *
+     * Timers that do not fit in @p out stay expired and are returned by the
+     * next call, oldest first. Runs of ticks with nothing to expire or cascade
+     * are skipped in one step, so the cost depends on the timers crossed, not
+     * on how far time moves.
+     * @param now The new current tick; earlier values only drain expired timers.
+     * @param out Destination for expired timers.
+     * @return The number of timers written to @p out.
+     */
+    std::size_t
+    advance(const std::uint64_t now, std::span<expired_timer> out) noexcept;
+
+    /**
+     * @brief Moves time forward to @p now and calls @p visit for every expired timer.
+     *
+     * @p visit runs without the wheel lock held, so it may schedule new timers.
+     * @param now The new current tick.
+     * @param visit Callable taking a const expired_timer&.
+     * @return The number of timers delivered.
+     */
+    template <typename Visitor>
+        requires std::invocable<Visitor&, const expired_timer&>
+    std::size_t
+    advance(const std::uint64_t now, Visitor visit)
+    {
+        std::array<expired_timer, 64> batch{};
+        std::size_t total = 0;
+
+        for (;;) {
+            const auto count = advance(now, std::span(batch));
+            for (std::size_t i = 0; i < count; ++i) {
+                visit(static_cast<const expired_timer&>(batch[i]));
+            }
+
+            total += count;
+            if (count < batch.size()) {
+                return total;
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the current tick.
+     * @return The tick reached by the last advance().
+     */
+    [[nodiscard]] std::uint64_t
+    now() const noexcept;
+
+    /**
+     * @brief Returns the number of pending timers, including expired ones not yet collected.
+     * @return The timer count.
+     */
+    [[nodiscard]] std::size_t
+    size() const noexcept;
+
+private:
+    struct wheel_header;
+    struct timer_entry;
+
+    timer_wheel(std::span<std::byte> region, wheel_header *header) noexcept;
+
+    void
+    _link(const std::uint32_t index, const std::uint32_t bucket) noexcept;
+
+    void
+    _unlink(const std::uint32_t index) noexcept;
+
+    void
+    _place(const std::uint32_t index) noexcept;
+
+    void
+    _release(const std::uint32_t index) noexcept;
+
+    void
+    _tick() noexcept;
+
+    [[nodiscard]] bool
+    _moves_entries_at(const std::uint64_t tick) const noexcept;
+
+    [[nodiscard]] std::uint64_t
+    _next_event(const std::uint64_t limit) const noexcept;
+
+private:
+    wheel_header *_header{nullptr};
+    timer_entry *_entries{nullptr};
+};
+
+} // namespace shared_memory
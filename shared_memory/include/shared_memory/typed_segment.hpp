@@ -0,0 +1,352 @@
+/**************************************************************
+ * @file typed_segment.hpp
+ * @brief Typed view over a published segment with in-place
+ * construction and layout checks.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#pragma once
+
+#if !defined(__linux__)
+#error "shared_memory is only supported on Linux"
+#endif
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <new>
+#include <source_location>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "shared_memory/error.hpp"
+#include "shared_memory/hash.hpp"
+#include "shared_memory/segment_header.hpp"
+#include "shared_memory/segment_name.hpp"
+#include "shared_memory/shared_memory.hpp"
+
+namespace shared_memory {
+
+/**
+ * @brief Reports whether an atomic specialization is lock-free on every platform run.
+ *
+ * Non-atomic types are trivially acceptable. std::atomic<U> must be always
+ * lock-free, otherwise it may hide a process-local mutex. Only @p T itself is
+ * inspected, never its members; see atomic_members_lock_free().
+ */
+template <typename T>
+struct is_lock_free_if_atomic : std::true_type {};
+
+template <typename U>
+struct is_lock_free_if_atomic<std::atomic<U>> : std::bool_constant<std::atomic<U>::is_always_lock_free> {};
+
+/** @brief Yields the member type @p M of a pointer to data member `M C::*`. */
+template <typename P>
+struct member_pointee;
+
+template <typename C, typename M>
+struct member_pointee<M C::*> {
+    using type = M;
+};
+
+/**
+ * @brief Checks the atomic members @p T lists for lock-freedom.
+ *
+ * Member atomics cannot be found without reflection, so they are checked
+ * only if @p T opts in by declaring a tuple of member pointers, e.g.
+ * `static constexpr std::tuple ATOMIC_MEMBERS{&T::head, &T::tail};`.
+ * Unlisted members are not checked.
+ * @return false if a listed member is an atomic that is not always lock-free.
+ */
+template <typename T>
+[[nodiscard]] consteval bool
+atomic_members_lock_free() noexcept
+{
+    if constexpr (requires { T::ATOMIC_MEMBERS; }) {
+        return std::apply([](const auto... members) {
+            return (is_lock_free_if_atomic<std::remove_all_extents_t<typename member_pointee<std::remove_cv_t<decltype(members)>>::type>>::value && ...);
+        }, T::ATOMIC_MEMBERS);
+    } else {
+        return true;
+    }
+}
+
+/**
+ * @brief Properties a type needs to live in memory shared between processes.
+ *
+ * Standard layout fixes member offsets across translation units; trivial
+ * destruction means no process has to run teardown code; polymorphic types
+ * carry vtable pointers that are only valid in one process. A top-level
+ * std::atomic must be always lock-free; atomic members are only checked when
+ * listed in ATOMIC_MEMBERS (see atomic_members_lock_free()). Pointer members
+ * cannot be detected without reflection, so store offsets instead of pointers.
+ */
+template <typename T>
+concept segment_storable = std::is_object_v<T>
+    && std::is_standard_layout_v<T>
+    && std::is_trivially_destructible_v<T>
+    && !std::is_polymorphic_v<T>
+    && !std::is_pointer_v<T>
+    && !std::is_member_pointer_v<T>
+    && is_lock_free_if_atomic<std::remove_all_extents_t<T>>::value
+    && atomic_members_lock_free<std::remove_all_extents_t<T>>();
+
+/** @brief Reports whether @p T is a std::atomic specialization. */
+template <typename T>
+struct is_atomic : std::false_type {};
+
+template <typename U>
+struct is_atomic<std::atomic<U>> : std::true_type {};
+
+/**
+ * @brief Checks that layout_hash() can see every layout change of @p T.
+ *
+ * Scalars are described by their name and size, arrays and std::atomic by
+ * their element type. Class types must either list their members in
+ * declaration order, e.g.
+ * `static constexpr std::tuple LAYOUT_MEMBERS{&T::head, &T::tail};`,
+ * or declare `static constexpr std::uint64_t LAYOUT_VERSION` and bump it on
+ * every layout change. Listed members must be described in turn.
+ * @return false if a class type along the way declares neither.
+ */
+template <typename T>
+[[nodiscard]] consteval bool
+layout_described() noexcept
+{
+    if constexpr (std::is_array_v<T>) {
+        return layout_described<std::remove_cv_t<std::remove_extent_t<T>>>();
+    } else if constexpr (is_atomic<T>::value) {
+        return layout_described<typename T::value_type>();
+    } else if constexpr (requires { T::LAYOUT_VERSION; }) {
+        return true;
+    } else if constexpr (requires { T::LAYOUT_MEMBERS; }) {
+        return std::apply([](const auto... members) {
+            return (layout_described<std::remove_cv_t<typename member_pointee<std::remove_cv_t<decltype(members)>>::type>>() && ...);
+        }, T::LAYOUT_MEMBERS);
+    } else {
+        return !std::is_class_v<T> && !std::is_union_v<T>;
+    }
+}
+
+/**
+ * @brief Computes a layout id for @p T from its name, size, alignment and members.
+ *
+ * Arrays and std::atomic fold in the id of their element type. Members listed
+ * in LAYOUT_MEMBERS fold in their own id in declaration order, so a changed,
+ * reordered or resized member changes the id; their offsets follow from that
+ * under the ABI. If @p T declares `static constexpr std::uint64_t
+ * LAYOUT_VERSION`, it is mixed in as well. Class types that declare neither
+ * are rejected at compile time (see layout_described()). The type name comes
+ * from the compiler, so all processes must be built with the same toolchain.
+ * @return The 64-bit layout id stored in the segment header.
+ */
+template <typename T>
+[[nodiscard]] consteval std::uint64_t
+layout_hash() noexcept
+{
+    static_assert(layout_described<T>(), "class types need LAYOUT_MEMBERS or LAYOUT_VERSION to be hashed");
+
+    std::uint64_t hash = fnv1a(std::string_view(std::source_location::current().function_name()));
+    hash = fnv1a(static_cast<std::uint64_t>(sizeof(T)), hash);
+    hash = fnv1a(static_cast<std::uint64_t>(alignof(T)), hash);
+
+    if constexpr (std::is_array_v<T>) {
+        hash = fnv1a(layout_hash<std::remove_cv_t<std::remove_extent_t<T>>>(), hash);
+    } else if constexpr (is_atomic<T>::value) {
+        hash = fnv1a(layout_hash<typename T::value_type>(), hash);
+    } else if constexpr (requires { T::LAYOUT_MEMBERS; }) {
+        std::apply([&hash](const auto... members) {
+            ((hash = fnv1a(layout_hash<std::remove_cv_t<typename member_pointee<std::remove_cv_t<decltype(members)>>::type>>(), hash)), ...);
+        }, T::LAYOUT_MEMBERS);
+    }
+
+    if constexpr (requires { { T::LAYOUT_VERSION } -> std::convertible_to<std::uint64_t>; }) {
+        hash = fnv1a(static_cast<std::uint64_t>(T::LAYOUT_VERSION), hash);
+    }
+
+    return hash;
+}
+
+/**
+ * @brief A published segment whose payload is a single object of type @p T.
+ *
+ * create() constructs T in place before publishing the segment; open() waits
+ * for publication and checks the layout hash, then exposes the object as a
+ * plain T& so member accesses compile to fixed offsets.
+ * Non-copyable but supports move semantics.
+ */
+template <segment_storable T>
+class typed_segment {
+public:
+    static_assert(alignof(T) <= HEADER_SIZE, "typed_segment payload is only aligned to the header size");
+
+    /** @brief Layout id recorded in the segment header. */
+    static constexpr std::uint64_t LAYOUT{layout_hash<T>()};
+
+    /** @brief Constructs an empty typed_segment with no segment attached. */
+    typed_segment() noexcept = default;
+
+    /**
+     * @brief Creates a segment, constructs T from @p args in place and publishes it.
+     * @param shm_name The name of the segment (leading slash is optional).
+     * @param options Access mode, unlink and population settings.
+     * @param args Constructor arguments for T.
+     * @return The typed segment, or an error on failure.
+     */
+    template <typename... Args>
+    [[nodiscard]] static std::expected<typed_segment, error>
+    create(const segment_name& shm_name, const create_options& options, Args&&... args)
+    {
+        T *object{nullptr};
+        auto shm = create_published(shm_name, sizeof(T), LAYOUT, [&](std::span<std::byte> memory) {
+            object = ::new (static_cast<void *>(memory.data())) T(std::forward<Args>(args)...);
+        }, options);
+        if (!shm) {
+            return std::unexpected(shm.error());
+        }
+
+        return typed_segment(std::move(*shm), object);
+    }
+
+    /**
+     * @brief Creates a segment holding a value-initialized T with default options.
+     * @param shm_name The name of the segment (leading slash is optional).
+     * @return The typed segment, or an error on failure.
+     */
+    [[nodiscard]] static std::expected<typed_segment, error>
+    create(const segment_name& shm_name)
+    {
+        return create(shm_name, create_options{});
+    }
+
+    /**
+     * @brief Attaches to a segment created by create() for the same T.
+     * @param shm_name The name of the segment to attach to.
+     * @param timeout Maximum time to wait for the creator to publish the segment.
+     * @return The typed segment, or layout_mismatch if the layout hash differs.
+     */
+    [[nodiscard]] static std::expected<typed_segment, error>
+    open(const segment_name& shm_name, const std::chrono::milliseconds timeout) noexcept
+    {
+        auto shm = open_published(shm_name, LAYOUT, timeout);
+        if (!shm) {
+            return std::unexpected(shm.error());
+        }
+
+        auto memory = payload(*shm);
+        if (memory.size() < sizeof(T)) {
+            return std::unexpected(error(errc::layout_mismatch, {EPROTO, std::generic_category()}));
+        }
+
+        auto *object = std::launder(reinterpret_cast<T *>(memory.data()));
+        return typed_segment(std::move(*shm), object);
+    }
+
+    /** @brief Returns the shared object. */
+    [[nodiscard]] T&
+    get() noexcept { return *_object; }
+
+    /** @brief Returns the shared object as read-only. */
+    [[nodiscard]] const T&
+    get() const noexcept { return *_object; }
+
+    /** @brief Dereferences to the shared object. */
+    [[nodiscard]] T&
+    operator*() noexcept { return *_object; }
+
+    /** @brief Dereferences to the shared object as read-only. */
+    [[nodiscard]] const T&
+    operator*() const noexcept { return *_object; }
+
+    /** @brief Member access on the shared object. */
+    [[nodiscard]] T *
+    operator->() noexcept { return _object; }
+
+    /** @brief Read-only member access on the shared object. */
+    [[nodiscard]] const T *
+    operator->() const noexcept { return _object; }
+
+    /**
+     * @brief Checks whether a segment is attached.
+     * @return true for a default-constructed or moved-from object.
+     */
+    [[nodiscard]] bool
+    empty() const noexcept { return _object == nullptr; }
+
+    /**
+     * @brief Returns the underlying segment.
+     * @return A reference to the mapping that holds the object.
+     */
+    [[nodiscard]] shared_memory&
+    segment() noexcept { return _shm; }
+
+    /* Non-copyable */
+    typed_segment(const typed_segment&) = delete;
+    typed_segment& operator=(const typed_segment&) = delete;
+
+    /** @brief Move constructor. The mapping does not move, so the object address is preserved. */
+    typed_segment(typed_segment&& other) noexcept
+    : _shm(std::move(other._shm)),
+      _object(std::exchange(other._object, nullptr))
+    {}
+
+    /** @brief Move assignment. Releases the current segment and takes over @p other. */
+    typed_segment& operator=(typed_segment&& other) noexcept
+    {
+        if (this != &other) {
+            _shm = std::move(other._shm);
+            _object = std::exchange(other._object, nullptr);
+        }
+        return *this;
+    }
+
+    ~typed_segment() = default;
+
+private:
+    typed_segment(shared_memory shm, T *object) noexcept
+    : _shm(std::move(shm)),
+      _object(object)
+    {}
+
+private:
+    shared_memory _shm{};
+    T *_object{nullptr};
+};
+
+} // namespace shared_memory
@@ -0,0 +1,333 @@
+/**************************************************************
+ * @file wal.hpp
+ * @brief Shared-memory write-ahead log with an asynchronous flusher.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#pragma once
+
+#if !defined(__linux__)
+#error "shared_memory is only supported on Linux"
+#endif
+
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <system_error>
+#include <utility>
+
+#include "shared_memory/cache_line.hpp"
+#include "shared_memory/error.hpp"
+#include "shared_memory/shared_memory.hpp"
+
+namespace shared_memory {
+
+/**
+ * @brief Header preceding every record, in the region and in the log file.
+ *
+ * Records start at 8-byte-aligned log offsets (LSNs) and occupy
+ * record_size(length) bytes. @c kind is written last, with release
+ * semantics, and is 0 until the record is committed.
+ */
+struct wal_record_header {
+    /** @brief kind of a committed record. */
+    static constexpr std::uint32_t RECORD{1};
+
+    /** @brief kind of the filler that keeps records from wrapping around the ring. */
+    static constexpr std::uint32_t PADDING{2};
+
+    std::uint32_t length;
+    std::uint32_t kind;
+};
+
+/**
+ * @brief Space for one record, returned by write_ahead_log::reserve().
+ */
+struct wal_reservation {
+    /** @brief Log sequence number: the record's byte offset in the log. */
+    std::uint64_t lsn;
+
+    /** @brief Where the caller writes the payload before commit(). */
+    std::span<std::byte> payload;
+};
+
+/**
+ * @brief Append-only log in a region, persisted by a single flusher process.
+ *
+ * Appenders in any process reserve space with one CAS on the reservation
+ * counter, copy their payload and publish it by setting the record's kind, so
+ * appending costs only shared-memory latency. The region holds a ring of the
+ * most recent bytes; the flusher writes the committed prefix to a file at file
+ * offset == LSN, syncs it and advances the durable LSN, waking processes
+ * blocked in wait_durable(), then zeroes the ring bytes it wrote and hands
+ * them back to appenders. Appenders that
+ * outrun the flusher by a whole ring get ENOSPC instead of blocking.
+ *
+ * Payloads carry no checksum; callers that need torn-write detection after a
+ * crash should include their own. The object only holds pointers into the
+ * region, which must outlive it.
+ */
+class write_ahead_log {
+public:
+    /** @brief Value of the header magic in a formatted region. */
+    static constexpr std::uint64_t MAGIC{0x5348'4d57'414c'4c47};  // "SHMWALLG"
+
+    /** @brief Alignment of records, and so of LSNs. */
+    static constexpr std::size_t RECORD_ALIGNMENT{8};
+
+    /** @brief Constructs a log bound to no region. */
+    write_ahead_log() noexcept = default;
+
+    /**
+     * @brief Returns the bytes a record with @p length payload bytes occupies.
+     * @param length Payload size.
+     * @return Header plus payload, rounded up to RECORD_ALIGNMENT.
+     */
+    [[nodiscard]] static constexpr std::size_t
+    record_size(const std::size_t length) noexcept
+    {
+        return (sizeof(wal_record_header) + length + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1);
+    }
+
+    /**
+     * @brief Returns the region size needed for a ring of @p capacity bytes.
+     * @param capacity Ring size; a power of two of at least 4096.
+     * @return Bytes required.
+     */
+    [[nodiscard]] static std::size_t
+    required_size(const std::size_t capacity) noexcept;
+
+    /**
+     * @brief Formats @p region as an empty log whose next record gets @p start_lsn.
+     *
+     * To continue an existing log file, pass the LSN replay() returned for it.
+     * @param region Cache-line-aligned memory of at least required_size() bytes.
+     * @param capacity Ring size; a power of two of at least 4096.
+     * @param start_lsn First LSN; a multiple of RECORD_ALIGNMENT.
+     * @return The log, or layout_mismatch (ENOSPC if the region is too small,
+     * EINVAL for a misaligned region, a bad capacity or an unaligned start_lsn).
+     */
+    [[nodiscard]] static std::expected<write_ahead_log, error>
+    create(std::span<std::byte> region, const std::size_t capacity, const std::uint64_t start_lsn = 0) noexcept;
+
+    /**
+     * @brief Binds to a region formatted by create(), possibly in another process.
+     * @param region The formatted memory.
+     * @return The log, or layout_mismatch (EPROTO) if the region holds no log.
+     */
+    [[nodiscard]] static std::expected<write_ahead_log, error>
+    attach(std::span<std::byte> region) noexcept;
+
+    /**
+     * @brief Reserves space for a record of @p length bytes.
+     *
+     * Lock-free. The record blocks the flusher until it is committed, so
+     * commit promptly and never abandon a reservation.
+     * @param length Payload size; record_size(length) may be at most half the capacity.
+     * @return The reservation, or allocate_failed (ENOSPC while the ring is
+     * full of bytes not yet durable, EMSGSIZE for an oversized record).
+     */
+    [[nodiscard]] std::expected<wal_reservation, error>
+    reserve(const std::size_t length) noexcept;
+
+    /**
+     * @brief Publishes a reserved record to the flusher.
+     * @param reservation Value returned by reserve(), with its payload written.
+     */
+    void
+    commit(const wal_reservation& reservation) noexcept;
+
+    /**
+     * @brief Reserves, copies @p payload and commits in one call.
+     * @param payload The record contents.
+     * @return The record's LSN, or a reserve() error.
+     */
+    [[nodiscard]] std::expected<std::uint64_t, error>
+    append(std::span<const std::byte> payload) noexcept;
+
+    /**
+     * @brief Returns the LSN below which every record is on stable storage.
+     * @return The durable LSN; the record at lsn is durable once this exceeds lsn.
+     */
+    [[nodiscard]] std::uint64_t
+    durable_lsn() const noexcept;
+
+    /**
+     * @brief Blocks until the record at @p lsn is durable.
+     * @param lsn LSN returned by append() or reserve().
+     * @param timeout Maximum time to wait; negative values wait indefinitely.
+     * @return Nothing once durable_lsn() > lsn, or wait_failed (ETIMEDOUT).
+     */
+    [[nodiscard]] std::expected<void, error>
+    wait_durable(const std::uint64_t lsn, const std::chrono::nanoseconds timeout = std::chrono::nanoseconds(-1)) const noexcept;
+
+    /**
+     * @brief Returns the ring size.
+     * @return Capacity in bytes.
+     */
+    [[nodiscard]] std::size_t
+    capacity() const noexcept;
+
+    /**
+     * @brief Calls @p visit for every record in a log file written by wal_flusher.
+     *
+     * Stops at the first uncommitted or truncated record.
+     * @param path The log file.
+     * @param visit Callable taking (std::uint64_t lsn, std::span<const std::byte> payload).
+     * @return The LSN just past the last complete record, or a map_file() error.
+     */
+    template <typename Visitor>
+        requires std::invocable<Visitor&, std::uint64_t, std::span<const std::byte>>
+    [[nodiscard]] static std::expected<std::uint64_t, error>
+    replay(const std::filesystem::path& path, Visitor visit)
+    {
+        std::error_code ec;
+        if (std::filesystem::file_size(path, ec) == 0 && !ec) {
+            return 0;
+        }
+
+        file_options options;
+        options.mode = access_mode::READ;
+        options.create = false;
+        auto file = shared_memory::map_file(path, 0, options);
+        if (!file) {
+            return std::unexpected(file.error());
+        }
+
+        const auto memory = std::as_const(*file).get_memory();
+        std::uint64_t lsn = 0;
+        while (lsn + sizeof(wal_record_header) <= memory.size()) {
+            wal_record_header header{};
+            std::memcpy(&header, memory.data() + lsn, sizeof(header));
+            const auto size = record_size(header.length);
+            if ((header.kind != wal_record_header::RECORD && header.kind != wal_record_header::PADDING) || size > memory.size() - lsn) {
+                break;
+            }
+            if (header.kind == wal_record_header::RECORD) {
+                visit(lsn, memory.subspan(lsn + sizeof(wal_record_header), header.length));
+            }
+            lsn += size;
+        }
+        return lsn;
+    }
+
+private:
+    friend class wal_flusher;
+
+    struct log_header;
+
+    write_ahead_log(std::span<std::byte> region, log_header *header) noexcept;
+
+private:
+    log_header *_header{nullptr};
+    std::byte *_ring{nullptr};
+};
+
+/**
+ * @brief Tunables for wal_flusher.
+ */
+struct wal_flusher_options {
+    /** @brief If true, writes and syncs through io_uring when the kernel allows it. */
+    bool use_io_uring{true};
+
+    /** @brief Largest number of bytes persisted per flush. */
+    std::size_t max_batch{std::size_t{4} << 20};
+};
+
+/**
+ * @brief Persists a write_ahead_log to a file; run exactly one per log.
+ *
+ * Each flush() writes the longest committed prefix past the durable LSN with
+ * a linked write + fdatasync chain on io_uring (pwrite and fdatasync without
+ * it), then publishes the new durable LSN. A ring error drains the ring and
+ * falls back to pwrite for the rest of the flusher's life. The file must end at the durable
+ * LSN, so a log continuing an existing file is created with the start LSN
+ * replay() reports. The one exception is a flusher restarted after dying
+ * between its write and the durable LSN update: bytes past the durable LSN
+ * that still match the ring are unacknowledged and are truncated away. A
+ * flusher that died after publishing but before zeroing its bytes leaves
+ * them for the next open() to zero.
+ */
+class wal_flusher {
+public:
+    /** @brief Constructs a flusher bound to nothing. */
+    wal_flusher() noexcept;
+
+    ~wal_flusher();
+
+    wal_flusher(wal_flusher&&) noexcept;
+    wal_flusher& operator=(wal_flusher&&) noexcept;
+
+    /**
+     * @brief Opens or creates the log file for @p log.
+     * @param log The log to persist.
+     * @param path The log file.
+     * @param options io_uring and batching settings.
+     * @return The flusher, open_failed / truncate_failed / stat_failed, or
+     * layout_mismatch if the file holds data past the durable LSN that is not
+     * this log's (EEXIST) or ends before it (EPROTO).
+     */
+    [[nodiscard]] static std::expected<wal_flusher, error>
+    open(const write_ahead_log& log, const std::filesystem::path& path, const wal_flusher_options& options = {}) noexcept;
+
+    /**
+     * @brief Persists the committed prefix, if any, and advances the durable LSN.
+     * @return The new durable LSN, or write_failed; the durable LSN does not move on failure.
+     */
+    [[nodiscard]] std::expected<std::uint64_t, error>
+    flush() noexcept;
+
+    /**
+     * @brief Blocks until a record is committed past the durable LSN.
+     * @param timeout Maximum time to wait; negative values wait indefinitely.
+     * @return true if there is something to flush.
+     */
+    [[nodiscard]] bool
+    wait_for_commits(const std::chrono::nanoseconds timeout = std::chrono::nanoseconds(-1)) noexcept;
+
+private:
+    struct state;
+
+    explicit wal_flusher(std::unique_ptr<state> flusher_state) noexcept;
+
+private:
+    std::unique_ptr<state> _state;
+};
+
+} // namespace shared_memory
@@ -0,0 +1,196 @@
+/**************************************************************
+ * @file window.hpp
+ * @brief Sliding window over a large POSIX shared memory segment.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#pragma once
+
+#if !defined(__linux__)
+#error "shared_memory is only supported on Linux"
+#endif
+
+#include <span>
+#include <cstddef>
+#include <string_view>
+#include <expected>
+#include <utility>
+#include <algorithm>
+
+#include "shared_memory/error.hpp"
+#include "shared_memory/owned_fd.hpp"
+#include "shared_memory/segment_name.hpp"
+
+namespace shared_memory {
+
+/**
+ * @brief Maps a bounded, page-aligned window of an existing segment.
+ *
+ * Keeps the segment file descriptor open and remaps only when the cursor moves
+ * outside the currently mapped pages, so processes can walk segments far larger
+ * than they are willing to map in full. Non-copyable but supports move semantics.
+ */
+class window {
+public:
+    /** @brief Constructs an empty window with no segment attached. */
+    window() noexcept = default;
+
+    /** @brief Destructor. Unmaps the current window; the descriptor closes itself. */
+    ~window() { _unmap(); }
+
+    /* Non-copyable */
+    window(const window&) = delete;
+    window& operator=(const window&) = delete;
+
+    /** @brief Move constructor. Transfers the descriptor and mapping from the source. */
+    window(window&& other) noexcept
+    : _fd(std::move(other._fd)),
+      _segment_size(std::exchange(other._segment_size, 0)),
+      _window_size(std::exchange(other._window_size, 0)),
+      _map(std::exchange(other._map, {})),
+      _map_start(std::exchange(other._map_start, 0)),
+      _cursor(std::exchange(other._cursor, 0))
+    {}
+
+    /** @brief Move assignment. Unmaps the current window and takes over @p other. */
+    window& operator=(window&& other) noexcept
+    {
+        if (this == &other) {
+            return *this;
+        }
+
+        _unmap();
+
+        _fd = std::move(other._fd);
+        _segment_size = std::exchange(other._segment_size, 0);
+        _window_size = std::exchange(other._window_size, 0);
+        _map = std::exchange(other._map, {});
+        _map_start = std::exchange(other._map_start, 0);
+        _cursor = std::exchange(other._cursor, 0);
+
+        return *this;
+    }
+
+    /**
+     * @brief Attaches to an existing segment and maps the window at offset 0.
+     * @param shm_name The name of the segment to attach to.
+     * @param window_size Number of bytes visible through the window (must be non-zero).
+     * @return The window object, or an error on failure.
+     */
+    [[nodiscard]] static std::expected<window, error>
+    open(const segment_name& shm_name, const std::size_t window_size) noexcept;
+
+    /**
+     * @brief Attaches to an existing segment from a runtime name.
+     *
+     * Validates @p shm_name with segment_name::make() and forwards to the overload above.
+     */
+    [[nodiscard]] static std::expected<window, error>
+    open(std::string_view shm_name, const std::size_t window_size) noexcept;
+
+    /**
+     * @brief Moves the cursor, remapping only if the new window is not already mapped.
+     * @param offset New cursor position in bytes from the start of the segment.
+     * @return A span over [offset, offset+window_size) clipped to the segment end,
+     * or an error (EINVAL if @p offset is past the end of the segment).
+     */
+    [[nodiscard]] std::expected<std::span<std::byte>, error>
+    seek(const std::size_t offset) noexcept;
+
+    /**
+     * @brief Returns the bytes visible at the current cursor.
+     * @return A span over [offset(), offset()+window_size()) clipped to the segment end.
+     */
+    [[nodiscard]] std::span<std::byte>
+    get_memory() noexcept { return _visible(); }
+
+    /**
+     * @brief Returns the bytes visible at the current cursor as a read-only span.
+     * @return A const span over the visible bytes.
+     */
+    [[nodiscard]] std::span<const std::byte>
+    get_memory() const noexcept { return const_cast<window&>(*this)._visible(); }
+
+    /**
+     * @brief Returns the current cursor position.
+     * @return Byte offset of the cursor within the segment.
+     */
+    [[nodiscard]] std::size_t
+    offset() const noexcept { return _cursor; }
+
+    /**
+     * @brief Returns the size of the underlying segment.
+     * @return The segment size in bytes, as seen when the window was opened.
+     */
+    [[nodiscard]] std::size_t
+    segment_size() const noexcept { return _segment_size; }
+
+    /**
+     * @brief Returns the configured window size.
+     * @return The number of bytes visible through the window.
+     */
+    [[nodiscard]] std::size_t
+    window_size() const noexcept { return _window_size; }
+
+    /**
+     * @brief Checks whether this window is attached to a segment.
+     * @return true if no segment is attached (e.g., default-constructed).
+     */
+    [[nodiscard]] bool
+    empty() const noexcept { return !_fd.is_valid(); }
+
+private:
+    [[nodiscard]] std::span<std::byte>
+    _visible() noexcept
+    {
+        const std::size_t count = std::min(_window_size, _segment_size - _cursor);
+        if (_map.empty() || count == 0) {
+            return {};
+        }
+
+        return _map.subspan(_cursor - _map_start, count);
+    }
+
+    void
+    _unmap() noexcept;
+
+private:
+    owned_fd _fd{};
+    std::size_t _segment_size{0};
+    std::size_t _window_size{0};
+    std::span<std::byte> _map{};   // Page-aligned mapping backing the window
+    std::size_t _map_start{0};     // Segment offset at which _map begins
+    std::size_t _cursor{0};
+};
+
+} // namespace shared_memory
@@ -0,0 +1,62 @@
+/**************************************************************
+ * @file async_create.cpp
+ * @brief Implementation of create_async.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#include "shared_memory/async_create.hpp"
+
+#include <system_error>
+#include <thread>
+
+namespace shared_memory {
+
+[[nodiscard]] pending_segment
+create_async(const segment_name& shm_name, const std::size_t size, const create_options& options)
+{
+    try {
+        /* A detached thread owns the promise, so a dropped handle leaves the segment for it to release. */
+        std::promise<std::expected<shared_memory, error>> promise;
+        auto result = promise.get_future();
+        std::thread([promise = std::move(promise), shm_name, size, options]() mutable {
+            promise.set_value(shared_memory::create(shm_name, size, options));
+        }).detach();
+        return pending_segment(std::move(result));
+    } catch (const std::system_error&) {
+        std::promise<std::expected<shared_memory, error>> inline_result;
+        inline_result.set_value(shared_memory::create(shm_name, size, options));
+        return pending_segment(inline_result.get_future());
+    }
+}
+
+} // namespace shared_memory
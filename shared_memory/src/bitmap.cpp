@@ -0,0 +1,333 @@
+/**************************************************************
+ * @file bitmap.cpp
+ * @brief Implementation of the hierarchical bitmap.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#include "shared_memory/bitmap.hpp"
+
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+namespace shared_memory {
+
+struct alignas(CACHE_LINE_SIZE) hierarchical_bitmap::bitmap_header {
+    std::uint64_t magic;
+    std::uint64_t bits;
+};
+
+namespace {
+
+constexpr std::uint64_t ALL_ONES{~std::uint64_t{0}};
+
+struct region_offsets {
+    std::size_t words;
+    std::size_t has_set_first;
+    std::size_t has_set_second;
+    std::size_t has_clear_first;
+    std::size_t has_clear_second;
+    std::size_t end;
+};
+
+[[nodiscard]] constexpr std::size_t
+words_for(const std::size_t bits) noexcept
+{
+    return (bits + hierarchical_bitmap::WORD_BITS - 1) / hierarchical_bitmap::WORD_BITS;
+}
+
+[[nodiscard]] static region_offsets
+offsets_for(const std::size_t bits, const std::size_t header_size) noexcept
+{
+    const auto word_count = words_for(bits);
+    const auto first_count = words_for(word_count);
+    const auto second_count = words_for(first_count);
+    constexpr auto word_size = sizeof(std::atomic<std::uint64_t>);
+
+    region_offsets offsets{};
+    offsets.words = align_up(header_size);
+    offsets.has_set_first = align_up(offsets.words + word_count * word_size);
+    offsets.has_set_second = align_up(offsets.has_set_first + first_count * word_size);
+    offsets.has_clear_first = align_up(offsets.has_set_second + second_count * word_size);
+    offsets.has_clear_second = align_up(offsets.has_clear_first + first_count * word_size);
+    offsets.end = offsets.has_clear_second + second_count * word_size;
+    return offsets;
+}
+
+/* Bits strictly above position, so a search can resume after a summary bit it already visited. */
+[[nodiscard]] constexpr std::uint64_t
+above(const std::size_t position) noexcept
+{
+    return position + 1 >= hierarchical_bitmap::WORD_BITS ? 0 : ALL_ONES << (position + 1);
+}
+
+[[nodiscard]] constexpr std::uint64_t
+bit_of(const std::size_t index) noexcept
+{
+    return std::uint64_t{1} << (index % hierarchical_bitmap::WORD_BITS);
+}
+
+}
+
+[[nodiscard]] std::size_t
+hierarchical_bitmap::required_size(const std::size_t bits) noexcept
+{
+    return offsets_for(bits, sizeof(bitmap_header)).end;
+}
+
+hierarchical_bitmap::hierarchical_bitmap(std::span<std::byte> region, bitmap_header *header) noexcept
+: _bits(header->bits)
+, _word_count(words_for(header->bits))
+, _second_count(words_for(words_for(words_for(header->bits))))
+{
+    const auto offsets = offsets_for(_bits, sizeof(bitmap_header));
+    const auto at = [&](const std::size_t offset) { return reinterpret_cast<std::atomic<std::uint64_t> *>(region.data() + offset); };
+    _words = at(offsets.words);
+    _has_set = {at(offsets.has_set_first), at(offsets.has_set_second)};
+    _has_clear = {at(offsets.has_clear_first), at(offsets.has_clear_second)};
+}
+
+[[nodiscard]] std::expected<hierarchical_bitmap, error>
+hierarchical_bitmap::create(std::span<std::byte> region, const std::size_t bits) noexcept
+{
+    if (reinterpret_cast<std::uintptr_t>(region.data()) % CACHE_LINE_SIZE != 0 || bits == 0) {
+        return std::unexpected(error(errc::layout_mismatch, {EINVAL, std::generic_category()}));
+    }
+
+    const auto size = required_size(bits);
+    if (region.size() < size) {
+        return std::unexpected(error(errc::layout_mismatch, {ENOSPC, std::generic_category()}));
+    }
+
+    std::memset(region.data(), 0, size);
+
+    auto *header = ::new (static_cast<void *>(region.data())) bitmap_header{};
+    header->bits = bits;
+
+    hierarchical_bitmap bitmap(region, header);
+
+    /* Every leaf word starts with clear bits, so the "has clear" summary starts full. */
+    for (std::size_t word = 0; word < bitmap._word_count; ++word) {
+        bitmap._has_clear.first[word / WORD_BITS].fetch_or(bit_of(word), std::memory_order_relaxed);
+    }
+    for (std::size_t first = 0; first < words_for(bitmap._word_count); ++first) {
+        bitmap._has_clear.second[first / WORD_BITS].fetch_or(bit_of(first), std::memory_order_relaxed);
+    }
+
+    std::atomic_ref(header->magic).store(MAGIC, std::memory_order_release);
+    return bitmap;
+}
+
+[[nodiscard]] std::expected<hierarchical_bitmap, error>
+hierarchical_bitmap::attach(std::span<std::byte> region) noexcept
+{
+    if (region.size() < sizeof(bitmap_header) || reinterpret_cast<std::uintptr_t>(region.data()) % CACHE_LINE_SIZE != 0) {
+        return std::unexpected(error(errc::layout_mismatch, {EPROTO, std::generic_category()}));
+    }
+
+    auto *header = std::launder(reinterpret_cast<bitmap_header *>(region.data()));
+    if (std::atomic_ref(header->magic).load(std::memory_order_acquire) != MAGIC
+        || header->bits == 0
+        || region.size() < required_size(header->bits)) {
+        return std::unexpected(error(errc::layout_mismatch, {EPROTO, std::generic_category()}));
+    }
+
+    return hierarchical_bitmap(region, header);
+}
+
+[[nodiscard]] std::uint64_t
+hierarchical_bitmap::_candidates(const std::size_t word, const bool want_set) const noexcept
+{
+    const auto value = _words[word].load(std::memory_order_acquire);
+    const auto tail = _bits % WORD_BITS;
+    const auto valid = word + 1 == _word_count && tail != 0 ? (std::uint64_t{1} << tail) - 1 : ALL_ONES;
+    return (want_set ? value : ~value) & valid;
+}
+
+/*
+ * Summary bits are raised after the leaf transition that makes them true and
+ * lowered with a recheck of the leaf afterwards. With sequentially consistent
+ * operations on both sides, a lowering that races a raise always observes the
+ * raise and restores the bit, so a summary never stays clear over a candidate.
+ */
+void
+hierarchical_bitmap::_raise(const summary& tree, const std::size_t word) noexcept
+{
+    const auto first = word / WORD_BITS;
+    if ((tree.first[first].load() & bit_of(word)) == 0) {
+        tree.first[first].fetch_or(bit_of(word));
+    }
+    if ((tree.second[first / WORD_BITS].load() & bit_of(first)) == 0) {
+        tree.second[first / WORD_BITS].fetch_or(bit_of(first));
+    }
+}
+
+void
+hierarchical_bitmap::_lower(const summary& tree, const std::size_t word, const bool want_set) noexcept
+{
+    const auto first = word / WORD_BITS;
+    const auto remaining = tree.first[first].fetch_and(~bit_of(word)) & ~bit_of(word);
+    if (_candidates(word, want_set) != 0) {
+        _raise(tree, word);
+        return;
+    }
+
+    if (remaining == 0) {
+        tree.second[first / WORD_BITS].fetch_and(~bit_of(first));
+        if (tree.first[first].load() != 0) {
+            tree.second[first / WORD_BITS].fetch_or(bit_of(first));
+        }
+    }
+}
+
+bool
+hierarchical_bitmap::set(const std::size_t index) noexcept
+{
+    const auto word = index / WORD_BITS;
+    const auto previous = _words[word].fetch_or(bit_of(index));
+    if ((previous & bit_of(index)) != 0) {
+        return true;
+    }
+
+    if (previous == 0) {
+        _raise(_has_set, word);
+    }
+    if (_candidates(word, false) == 0) {
+        _lower(_has_clear, word, false);
+    }
+    return false;
+}
+
+bool
+hierarchical_bitmap::clear(const std::size_t index) noexcept
+{
+    const auto word = index / WORD_BITS;
+    const auto previous = _words[word].fetch_and(~bit_of(index));
+    if ((previous & bit_of(index)) == 0) {
+        return false;
+    }
+
+    _raise(_has_clear, word);
+    if ((previous & ~bit_of(index)) == 0) {
+        _lower(_has_set, word, true);
+    }
+    return true;
+}
+
+[[nodiscard]] bool
+hierarchical_bitmap::test(const std::size_t index) const noexcept
+{
+    return (_words[index / WORD_BITS].load(std::memory_order_acquire) & bit_of(index)) != 0;
+}
+
+[[nodiscard]] std::optional<std::size_t>
+hierarchical_bitmap::_descend(const bool want_set, const std::size_t first_index, std::uint64_t mask) const noexcept
+{
+    while (mask != 0) {
+        const auto word = first_index * WORD_BITS + std::countr_zero(mask);
+        if (const auto candidates = _candidates(word, want_set); candidates != 0) {
+            return word * WORD_BITS + std::countr_zero(candidates);
+        }
+        mask &= mask - 1;
+    }
+    return std::nullopt;
+}
+
+[[nodiscard]] std::optional<std::size_t>
+hierarchical_bitmap::_search(const summary& tree, const bool want_set, const std::size_t from) const noexcept
+{
+    if (from >= _bits) {
+        return std::nullopt;
+    }
+
+    const auto word = from / WORD_BITS;
+    if (const auto candidates = _candidates(word, want_set) & (ALL_ONES << (from % WORD_BITS)); candidates != 0) {
+        return word * WORD_BITS + std::countr_zero(candidates);
+    }
+
+    const auto first = word / WORD_BITS;
+    if (auto found = _descend(want_set, first, tree.first[first].load() & above(word % WORD_BITS))) {
+        return found;
+    }
+
+    auto second = first / WORD_BITS;
+    auto mask = tree.second[second].load() & above(first % WORD_BITS);
+    for (;;) {
+        while (mask != 0) {
+            const auto next_first = second * WORD_BITS + std::countr_zero(mask);
+            if (auto found = _descend(want_set, next_first, tree.first[next_first].load())) {
+                return found;
+            }
+            mask &= mask - 1;
+        }
+
+        if (++second >= _second_count) {
+            return std::nullopt;
+        }
+        mask = tree.second[second].load();
+    }
+}
+
+[[nodiscard]] std::optional<std::size_t>
+hierarchical_bitmap::find_first_set(const std::size_t from) const noexcept
+{
+    return _search(_has_set, true, from);
+}
+
+[[nodiscard]] std::optional<std::size_t>
+hierarchical_bitmap::find_first_clear(const std::size_t from) const noexcept
+{
+    return _search(_has_clear, false, from);
+}
+
+[[nodiscard]] std::expected<std::size_t, error>
+hierarchical_bitmap::acquire() noexcept
+{
+    /*
+     * A summary bit can read clear for a moment while a racing set() lowers
+     * it and then finds the leaf still has room. One more search after the
+     * first miss covers that window without sweeping every leaf.
+     */
+    for (int pass = 0; pass < 2; ++pass) {
+        while (auto candidate = find_first_clear()) {
+            if (!set(*candidate)) {
+                return *candidate;
+            }
+        }
+    }
+
+    return std::unexpected(error(errc::allocate_failed, {ENOSPC, std::generic_category()}));
+}
+
+} // namespace shared_memory
@@ -0,0 +1,164 @@
+/**************************************************************
+ * @file bloom_filter.cpp
+ * @brief Implementation of the split-block Bloom filter.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#include "shared_memory/bloom_filter.hpp"
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+namespace shared_memory {
+
+struct alignas(CACHE_LINE_SIZE) bloom_filter::filter_header {
+    std::uint64_t magic;
+    std::uint64_t block_count;
+};
+
+namespace {
+
+/* Odd multipliers from the split-block filter used by Impala and Parquet. */
+constexpr std::array<std::uint32_t, bloom_filter::BLOCK_WORDS> SALTS{
+    0x47b6'137bU, 0x4497'4d91U, 0x8824'ad5bU, 0xa2b7'289dU,
+    0x7054'95c7U, 0x2df1'424bU, 0x9efc'4947U, 0x5c6b'fb31U,
+};
+
+/* FNV-1a leaves the low bits poorly mixed, so fold the hash before splitting it. */
+[[nodiscard]] constexpr std::uint64_t
+mix(std::uint64_t hash) noexcept
+{
+    hash ^= hash >> 33;
+    hash *= 0xff51'afd7'ed55'8ccdULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+[[nodiscard]] inline std::array<std::uint32_t, bloom_filter::BLOCK_WORDS>
+masks_for(const std::uint32_t key) noexcept
+{
+    std::array<std::uint32_t, bloom_filter::BLOCK_WORDS> masks{};
+    for (std::size_t i = 0; i < masks.size(); ++i) {
+        masks[i] = std::uint32_t{1} << ((key * SALTS[i]) >> 27);
+    }
+    return masks;
+}
+
+}
+
+[[nodiscard]] std::size_t
+bloom_filter::required_size(const std::size_t block_count) noexcept
+{
+    return align_up(sizeof(filter_header)) + block_count * BLOCK_SIZE;
+}
+
+bloom_filter::bloom_filter(std::span<std::byte> region, filter_header *header) noexcept
+: _words(reinterpret_cast<std::uint32_t *>(region.data() + align_up(sizeof(filter_header))))
+, _block_count(header->block_count)
+{}
+
+[[nodiscard]] std::expected<bloom_filter, error>
+bloom_filter::create(std::span<std::byte> region, const std::size_t block_count) noexcept
+{
+    if (reinterpret_cast<std::uintptr_t>(region.data()) % CACHE_LINE_SIZE != 0 || block_count == 0 || block_count > (std::size_t{1} << 32)) {
+        return std::unexpected(error(errc::layout_mismatch, {EINVAL, std::generic_category()}));
+    }
+
+    const auto size = required_size(block_count);
+    if (region.size() < size) {
+        return std::unexpected(error(errc::layout_mismatch, {ENOSPC, std::generic_category()}));
+    }
+
+    std::memset(region.data(), 0, size);
+
+    auto *header = ::new (static_cast<void *>(region.data())) filter_header{};
+    header->block_count = block_count;
+    std::atomic_ref(header->magic).store(MAGIC, std::memory_order_release);
+
+    return bloom_filter(region, header);
+}
+
+[[nodiscard]] std::expected<bloom_filter, error>
+bloom_filter::attach(std::span<std::byte> region) noexcept
+{
+    if (region.size() < sizeof(filter_header) || reinterpret_cast<std::uintptr_t>(region.data()) % CACHE_LINE_SIZE != 0) {
+        return std::unexpected(error(errc::layout_mismatch, {EPROTO, std::generic_category()}));
+    }
+
+    auto *header = std::launder(reinterpret_cast<filter_header *>(region.data()));
+    if (std::atomic_ref(header->magic).load(std::memory_order_acquire) != MAGIC
+        || header->block_count == 0
+        || header->block_count > (std::size_t{1} << 32)
+        || region.size() < required_size(header->block_count)) {
+        return std::unexpected(error(errc::layout_mismatch, {EPROTO, std::generic_category()}));
+    }
+
+    return bloom_filter(region, header);
+}
+
+void
+bloom_filter::insert_hash(const std::uint64_t hash) noexcept
+{
+    const auto mixed = mix(hash);
+    const auto block = ((mixed >> 32) * _block_count) >> 32;
+    const auto masks = masks_for(static_cast<std::uint32_t>(mixed));
+
+    auto *words = _words + block * BLOCK_WORDS;
+    for (std::size_t i = 0; i < BLOCK_WORDS; ++i) {
+        std::atomic_ref word(words[i]);
+        /* Skip the locked RMW when the bit is already there; hot keys stop bouncing the line. */
+        if ((word.load(std::memory_order_relaxed) & masks[i]) != masks[i]) {
+            word.fetch_or(masks[i], std::memory_order_release);
+        }
+    }
+}
+
+[[nodiscard]] bool
+bloom_filter::contains_hash(const std::uint64_t hash) const noexcept
+{
+    const auto mixed = mix(hash);
+    const auto block = ((mixed >> 32) * _block_count) >> 32;
+    const auto masks = masks_for(static_cast<std::uint32_t>(mixed));
+
+    auto *words = _words + block * BLOCK_WORDS;
+    std::uint32_t missing = 0;
+    for (std::size_t i = 0; i < BLOCK_WORDS; ++i) {
+        missing |= masks[i] & ~std::atomic_ref(words[i]).load(std::memory_order_acquire);
+    }
+    return missing == 0;
+}
+
+} // namespace shared_memory
@@ -0,0 +1,508 @@
+/**************************************************************
+ * @file btree.cpp
+ * @brief Implementation of the segment-resident B+tree.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#include "shared_memory/btree.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <tuple>
+
+#include "shared_memory/spin_lock.hpp"
+
+namespace shared_memory {
+
+namespace {
+
+constexpr std::uint32_t NIL{UINT32_MAX};
+constexpr std::uint32_t LEAF_FLAG{1U << 16};
+constexpr std::uint32_t COUNT_MASK{LEAF_FLAG - 1};
+
+/* Every node holds at least MAX_KEYS / 2 keys after a split, so 2^32 nodes never exceed this height. */
+constexpr std::size_t MAX_HEIGHT{16};
+
+}
+
+struct alignas(CACHE_LINE_SIZE) btree::tree_header {
+    std::uint64_t magic;
+    std::uint64_t node_capacity;
+    spin_lock writer;
+    std::atomic<std::uint32_t> root;
+    std::atomic<std::uint32_t> nodes_used;
+    std::atomic<std::uint64_t> size;
+};
+
+/* Keys and slots are atomics so optimistic readers can race with the writer without undefined behavior; torn snapshots are caught by the version check. */
+struct alignas(CACHE_LINE_SIZE) btree::node {
+    std::atomic<std::uint64_t> version;
+    std::atomic<std::uint32_t> meta;
+    std::atomic<std::uint32_t> next;
+    std::array<std::atomic<std::uint64_t>, MAX_KEYS> keys;
+    std::array<std::atomic<std::uint64_t>, MAX_KEYS + 1> slots;
+
+    [[nodiscard]] std::uint64_t
+    read_begin() const noexcept
+    {
+        for (;;) {
+            const auto observed = version.load(std::memory_order_acquire);
+            if ((observed & 1) == 0) {
+                return observed;
+            }
+            spin_lock::cpu_relax();
+        }
+    }
+
+    [[nodiscard]] bool
+    validate(const std::uint64_t observed) const noexcept
+    {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return version.load(std::memory_order_relaxed) == observed;
+    }
+
+    void
+    write_begin() noexcept
+    {
+        version.store(version.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void
+    write_end() noexcept
+    {
+        version.store(version.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    [[nodiscard]] std::size_t
+    count() const noexcept
+    {
+        return std::min<std::size_t>(meta.load(std::memory_order_relaxed) & COUNT_MASK, MAX_KEYS);
+    }
+
+    [[nodiscard]] bool
+    leaf() const noexcept
+    {
+        return (meta.load(std::memory_order_relaxed) & LEAF_FLAG) != 0;
+    }
+
+    void
+    set_count(const std::size_t count) noexcept
+    {
+        meta.store(static_cast<std::uint32_t>(count) | (meta.load(std::memory_order_relaxed) & LEAF_FLAG), std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] std::uint64_t
+    key(const std::size_t index) const noexcept
+    {
+        return keys[index].load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] std::uint64_t
+    slot(const std::size_t index) const noexcept
+    {
+        return slots[index].load(std::memory_order_relaxed);
+    }
+
+    /* Index of the child covering key in an inner node, or of the first key not below it in a leaf. */
+    [[nodiscard]] std::size_t
+    upper_bound(const std::uint64_t search, const std::size_t count) const noexcept
+    {
+        std::size_t position = 0;
+        while (position < count && key(position) <= search) {
+            ++position;
+        }
+        return position;
+    }
+
+    [[nodiscard]] std::size_t
+    lower_bound(const std::uint64_t search, const std::size_t count) const noexcept
+    {
+        std::size_t position = 0;
+        while (position < count && key(position) < search) {
+            ++position;
+        }
+        return position;
+    }
+
+    void
+    assign(const std::span<const std::uint64_t> new_keys, const std::span<const std::uint64_t> new_slots) noexcept
+    {
+        for (std::size_t i = 0; i < new_keys.size(); ++i) {
+            keys[i].store(new_keys[i], std::memory_order_relaxed);
+        }
+        for (std::size_t i = 0; i < new_slots.size(); ++i) {
+            slots[i].store(new_slots[i], std::memory_order_relaxed);
+        }
+        set_count(new_keys.size());
+    }
+};
+
+[[nodiscard]] std::size_t
+btree::required_size(const std::size_t node_capacity) noexcept
+{
+    static_assert(sizeof(node) == NODE_SIZE, "btree nodes must span exactly four cache lines");
+    return align_up(sizeof(tree_header)) + node_capacity * sizeof(node);
+}
+
+btree::btree(std::span<std::byte> region, tree_header *header) noexcept
+: _header(header)
+, _nodes(reinterpret_cast<node *>(region.data() + align_up(sizeof(tree_header))))
+{}
+
+[[nodiscard]] std::expected<btree, error>
+btree::create(std::span<std::byte> region, const std::size_t node_capacity) noexcept
+{
+    if (reinterpret_cast<std::uintptr_t>(region.data()) % CACHE_LINE_SIZE != 0 || node_capacity == 0 || node_capacity >= NIL) {
+        return std::unexpected(error(errc::layout_mismatch, {EINVAL, std::generic_category()}));
+    }
+
+    const auto size = required_size(node_capacity);
+    if (region.size() < size) {
+        return std::unexpected(error(errc::layout_mismatch, {ENOSPC, std::generic_category()}));
+    }
+
+    std::memset(region.data(), 0, size);
+
+    auto *header = ::new (static_cast<void *>(region.data())) tree_header{};
+    header->node_capacity = node_capacity;
+
+    btree tree(region, header);
+    const auto root = tree._allocate(true);
+    header->root.store(root, std::memory_order_relaxed);
+    std::atomic_ref(header->magic).store(MAGIC, std::memory_order_release);
+
+    return tree;
+}
+
+[[nodiscard]] std::expected<btree, error>
+btree::attach(std::span<std::byte> region) noexcept
+{
+    if (region.size() < sizeof(tree_header) || reinterpret_cast<std::uintptr_t>(region.data()) % CACHE_LINE_SIZE != 0) {
+        return std::unexpected(error(errc::layout_mismatch, {EPROTO, std::generic_category()}));
+    }
+
+    auto *header = std::launder(reinterpret_cast<tree_header *>(region.data()));
+    if (std::atomic_ref(header->magic).load(std::memory_order_acquire) != MAGIC
+        || header->node_capacity == 0
+        || header->node_capacity >= NIL
+        || region.size() < required_size(header->node_capacity)) {
+        return std::unexpected(error(errc::layout_mismatch, {EPROTO, std::generic_category()}));
+    }
+
+    return btree(region, header);
+}
+
+[[nodiscard]] btree::node&
+btree::_node(const std::uint32_t index) const noexcept
+{
+    return _nodes[index];
+}
+
+[[nodiscard]] std::uint32_t
+btree::_allocate(const bool leaf) noexcept
+{
+    const auto index = _header->nodes_used.load(std::memory_order_relaxed);
+    _header->nodes_used.store(index + 1, std::memory_order_relaxed);
+
+    auto& fresh = _node(index);
+    fresh.meta.store(leaf ? LEAF_FLAG : 0, std::memory_order_relaxed);
+    fresh.next.store(NIL, std::memory_order_relaxed);
+    return index;
+}
+
+[[nodiscard]] std::pair<std::uint32_t, std::uint64_t>
+btree::_find_leaf(const key_type key) const noexcept
+{
+restart:
+    auto index = _header->root.load(std::memory_order_acquire);
+    auto version = _node(index).read_begin();
+
+    /* A root split keeps the old root write-locked until the new root is published. */
+    if (_header->root.load(std::memory_order_acquire) != index) {
+        goto restart;
+    }
+
+    while (!_node(index).leaf()) {
+        const auto& inner = _node(index);
+        const auto child = inner.slot(inner.upper_bound(key, inner.count()));
+        if (!inner.validate(version) || child >= _header->node_capacity) {
+            goto restart;
+        }
+
+        const auto child_version = _node(static_cast<std::uint32_t>(child)).read_begin();
+        if (!inner.validate(version)) {
+            goto restart;
+        }
+
+        index = static_cast<std::uint32_t>(child);
+        version = child_version;
+    }
+
+    return {index, version};
+}
+
+[[nodiscard]] std::optional<btree::mapped_type>
+btree::find(const key_type key) const noexcept
+{
+    for (;;) {
+        const auto [index, version] = _find_leaf(key);
+        const auto& leaf = _node(index);
+
+        const auto count = leaf.count();
+        const auto position = leaf.lower_bound(key, count);
+        std::optional<mapped_type> result;
+        if (position < count && leaf.key(position) == key) {
+            result = leaf.slot(position);
+        }
+
+        if (leaf.validate(version)) {
+            return result;
+        }
+    }
+}
+
+[[nodiscard]] std::size_t
+btree::scan(key_type first, const key_type last, std::span<value_type> out) const noexcept
+{
+    std::size_t written = 0;
+    if (out.empty() || first >= last) {
+        return written;
+    }
+
+    auto [index, version] = _find_leaf(first);
+    for (;;) {
+        const auto& leaf = _node(index);
+
+        std::array<value_type, MAX_KEYS> snapshot{};
+        std::size_t taken = 0;
+        bool exhausted = false;
+
+        const auto count = leaf.count();
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto key = leaf.key(i);
+            if (key >= last) {
+                exhausted = true;
+                break;
+            }
+            if (key >= first) {
+                snapshot[taken++] = {key, leaf.slot(i)};
+            }
+        }
+        const auto next = leaf.next.load(std::memory_order_relaxed);
+
+        if (!leaf.validate(version)) {
+            std::tie(index, version) = _find_leaf(first);
+            continue;
+        }
+
+        for (std::size_t i = 0; i < taken; ++i) {
+            if (written == out.size()) {
+                return written;
+            }
+            out[written++] = snapshot[i];
+            first = snapshot[i].first + 1;
+        }
+
+        if (exhausted || next == NIL || next >= _header->node_capacity || written == out.size()) {
+            return written;
+        }
+
+        index = next;
+        version = _node(index).read_begin();
+    }
+}
+
+[[nodiscard]] std::expected<bool, error>
+btree::insert(const key_type key, const mapped_type value) noexcept
+{
+    std::scoped_lock lock(_header->writer);
+
+    std::array<std::uint32_t, MAX_HEIGHT> path{};
+    std::size_t depth = 0;
+    auto index = _header->root.load(std::memory_order_relaxed);
+    while (!_node(index).leaf()) {
+        const auto& inner = _node(index);
+        path[depth++] = index;
+        index = static_cast<std::uint32_t>(inner.slot(inner.upper_bound(key, inner.count())));
+    }
+
+    auto& leaf = _node(index);
+    const auto count = leaf.count();
+    const auto position = leaf.lower_bound(key, count);
+
+    if (position < count && leaf.key(position) == key) {
+        leaf.write_begin();
+        leaf.slots[position].store(value, std::memory_order_relaxed);
+        leaf.write_end();
+        return false;
+    }
+
+    std::array<std::uint64_t, MAX_KEYS + 1> keys{};
+    std::array<std::uint64_t, MAX_KEYS + 2> slots{};
+    for (std::size_t i = 0, j = 0; i <= count; ++i) {
+        if (i == position) {
+            keys[i] = key;
+            slots[i] = value;
+        } else {
+            keys[i] = leaf.key(j);
+            slots[i] = leaf.slot(j);
+            ++j;
+        }
+    }
+
+    if (count < MAX_KEYS) {
+        leaf.write_begin();
+        leaf.assign(std::span(keys).first(count + 1), std::span(slots).first(count + 1));
+        leaf.write_end();
+        _header->size.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /* Full ancestors split along with the leaf; the first ancestor with room absorbs the separator. */
+    std::size_t top = depth;
+    while (top > 0 && _node(path[top - 1]).count() == MAX_KEYS) {
+        --top;
+    }
+    const bool grows = top == 0;
+    const std::size_t needed = (depth - top) + 1 + (grows ? 1 : 0);
+    if (_header->nodes_used.load(std::memory_order_relaxed) + needed > _header->node_capacity) {
+        return std::unexpected(error(errc::allocate_failed, {ENOSPC, std::generic_category()}));
+    }
+
+    /* Every node that changes stays write-locked until the separator reaches its parent, so readers never see a half-finished split. */
+    const std::size_t locked_from = grows ? 0 : top - 1;
+    leaf.write_begin();
+    for (std::size_t level = locked_from; level < depth; ++level) {
+        _node(path[level]).write_begin();
+    }
+
+    constexpr std::size_t LEAF_LEFT{(MAX_KEYS + 2) / 2};
+    const auto right_leaf = _allocate(true);
+    auto& right = _node(right_leaf);
+    right.assign(std::span(keys).subspan(LEAF_LEFT, MAX_KEYS + 1 - LEAF_LEFT), std::span(slots).subspan(LEAF_LEFT, MAX_KEYS + 1 - LEAF_LEFT));
+    right.next.store(leaf.next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    leaf.assign(std::span(keys).first(LEAF_LEFT), std::span(slots).first(LEAF_LEFT));
+    leaf.next.store(right_leaf, std::memory_order_relaxed);
+
+    auto separator = keys[LEAF_LEFT];
+    std::uint64_t right_child = right_leaf;
+    bool absorbed = false;
+
+    for (std::size_t level = depth; level > 0 && !absorbed; --level) {
+        auto& parent = _node(path[level - 1]);
+        const auto parent_count = parent.count();
+        const auto slot = parent.upper_bound(separator, parent_count);
+
+        for (std::size_t i = 0, j = 0; i <= parent_count; ++i) {
+            keys[i] = i == slot ? separator : parent.key(j++);
+        }
+        for (std::size_t i = 0, j = 0; i <= parent_count + 1; ++i) {
+            slots[i] = i == slot + 1 ? right_child : parent.slot(j++);
+        }
+
+        if (parent_count < MAX_KEYS) {
+            parent.assign(std::span(keys).first(parent_count + 1), std::span(slots).first(parent_count + 2));
+            absorbed = true;
+            break;
+        }
+
+        /* The middle key moves up; the halves keep MAX_KEYS / 2 keys each. */
+        constexpr std::size_t INNER_LEFT{MAX_KEYS / 2};
+        const auto right_inner = _allocate(false);
+        _node(right_inner).assign(std::span(keys).subspan(INNER_LEFT + 1, MAX_KEYS - INNER_LEFT), std::span(slots).subspan(INNER_LEFT + 1, MAX_KEYS + 1 - INNER_LEFT));
+        parent.assign(std::span(keys).first(INNER_LEFT), std::span(slots).first(INNER_LEFT + 1));
+
+        separator = keys[INNER_LEFT];
+        right_child = right_inner;
+    }
+
+    if (!absorbed) {
+        const auto old_root = _header->root.load(std::memory_order_relaxed);
+        const auto new_root = _allocate(false);
+        const std::array<std::uint64_t, 1> root_keys{separator};
+        const std::array<std::uint64_t, 2> root_slots{old_root, right_child};
+        _node(new_root).assign(root_keys, root_slots);
+        _header->root.store(new_root, std::memory_order_release);
+    }
+
+    for (std::size_t level = depth; level > locked_from; --level) {
+        _node(path[level - 1]).write_end();
+    }
+    leaf.write_end();
+
+    _header->size.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool
+btree::erase(const key_type key) noexcept
+{
+    std::scoped_lock lock(_header->writer);
+
+    auto index = _header->root.load(std::memory_order_relaxed);
+    while (!_node(index).leaf()) {
+        const auto& inner = _node(index);
+        index = static_cast<std::uint32_t>(inner.slot(inner.upper_bound(key, inner.count())));
+    }
+
+    auto& leaf = _node(index);
+    const auto count = leaf.count();
+    const auto position = leaf.lower_bound(key, count);
+    if (position == count || leaf.key(position) != key) {
+        return false;
+    }
+
+    leaf.write_begin();
+    for (std::size_t i = position + 1; i < count; ++i) {
+        leaf.keys[i - 1].store(leaf.key(i), std::memory_order_relaxed);
+        leaf.slots[i - 1].store(leaf.slot(i), std::memory_order_relaxed);
+    }
+    leaf.set_count(count - 1);
+    leaf.write_end();
+
+    _header->size.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+[[nodiscard]] std::size_t
+btree::size() const noexcept
+{
+    return _header->size.load(std::memory_order_relaxed);
+}
+
+} // namespace shared_memory
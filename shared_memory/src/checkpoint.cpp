@@ -0,0 +1,420 @@
+/**************************************************************
+ * @file checkpoint.cpp
+ * @brief Writing segments to checkpoint files and restoring them.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#include "shared_memory/shared_memory.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <optional>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/sysinfo.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "shared_memory/cache_line.hpp"
+
+#include "extents.hpp"
+#include "io_uring.hpp"
+#include "page_size.hpp"
+
+namespace shared_memory {
+
+namespace {
+
+/* The kernel refuses to register a single fixed buffer larger than 1 GiB. */
+constexpr std::size_t MAX_FIXED_BUFFER{std::size_t{1} << 30};
+constexpr std::size_t MAX_FIXED_BUFFERS{64};
+constexpr unsigned MAX_QUEUE_DEPTH{256};
+
+enum class direction {
+    READ,
+    WRITE
+};
+
+struct transfer {
+    std::size_t offset;
+    std::size_t length;
+};
+
+/* Moves data to or from file offset base with pread/pwrite, retrying short and interrupted calls. */
+[[nodiscard]] static int
+transfer_all(const int fd, std::span<std::byte> data, const std::size_t base, const std::size_t chunk, const direction dir) noexcept
+{
+    for (std::size_t done = 0; done < data.size();) {
+        const auto length = std::min(chunk, data.size() - done);
+        const auto offset = static_cast<off_t>(base + done);
+        const auto moved = dir == direction::WRITE ? pwrite(fd, data.data() + done, length, offset) : pread(fd, data.data() + done, length, offset);
+        if (moved < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno;
+        }
+        if (moved == 0) {
+            return EIO;
+        }
+        done += static_cast<std::size_t>(moved);
+    }
+    return 0;
+}
+
+/*
+ * Registers data as fixed buffers of whole chunks so no request straddles two
+ * buffers. Returns the bytes covered by each buffer, or 0 if registration is
+ * not possible and plain requests must be used.
+ */
+[[nodiscard]] static std::size_t
+register_fixed(io_ring& ring, std::span<std::byte> data, const std::size_t chunk) noexcept
+{
+    const auto span = MAX_FIXED_BUFFER / chunk * chunk;
+    const auto count = (data.size() + span - 1) / span;
+    if (count == 0 || count > MAX_FIXED_BUFFERS) {
+        return 0;
+    }
+
+    std::array<iovec, MAX_FIXED_BUFFERS> buffers{};
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto offset = i * span;
+        buffers[i] = iovec{data.data() + offset, std::min(span, data.size() - offset)};
+    }
+
+    return ring.register_buffers(std::span(buffers).first(count)) == 0 ? span : 0;
+}
+
+/*
+ * Keeps up to the ring depth of chunk requests in flight until every extent
+ * has moved. Offsets into data are also file offsets.
+ */
+[[nodiscard]] static int
+transfer_through_ring(io_ring& ring, const int fd, std::span<std::byte> data, std::span<const extent> extents, const std::size_t chunk, const std::size_t fixed_span, const direction dir) noexcept
+{
+    std::array<transfer, MAX_QUEUE_DEPTH> slots{};
+    std::array<unsigned, MAX_QUEUE_DEPTH> free_slots{};
+    const auto depth = std::min(ring.depth(), MAX_QUEUE_DEPTH);
+    unsigned free_count = depth;
+    for (unsigned i = 0; i < depth; ++i) {
+        free_slots[i] = depth - 1 - i;
+    }
+
+    const auto fixed_opcode = dir == direction::WRITE ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+    const auto plain_opcode = dir == direction::WRITE ? IORING_OP_WRITE : IORING_OP_READ;
+    const auto queue = [&](const unsigned slot) {
+        auto *sqe = ring.next_sqe();
+        if (sqe == nullptr) {
+            return false;
+        }
+
+        const auto& pending = slots[slot];
+        sqe->opcode = fixed_span != 0 ? fixed_opcode : plain_opcode;
+        sqe->fd = fd;
+        sqe->addr = reinterpret_cast<std::uintptr_t>(data.data() + pending.offset);
+        sqe->len = static_cast<std::uint32_t>(pending.length);
+        sqe->off = pending.offset;
+        sqe->buf_index = fixed_span != 0 ? static_cast<std::uint16_t>(pending.offset / fixed_span) : 0;
+        sqe->user_data = slot;
+        return true;
+    };
+
+    std::size_t current = 0;
+    std::size_t next = extents.empty() ? 0 : extents.front().offset;
+    unsigned in_flight = 0;
+    while (current < extents.size() || in_flight > 0) {
+        while (free_count > 0 && current < extents.size()) {
+            const auto end = extents[current].offset + extents[current].length;
+            const auto slot = free_slots[free_count - 1];
+            slots[slot] = transfer{next, std::min(chunk, end - next)};
+            if (!queue(slot)) {
+                break;
+            }
+            --free_count;
+            next += slots[slot].length;
+            ++in_flight;
+            if (next == end && ++current < extents.size()) {
+                next = extents[current].offset;
+            }
+        }
+
+        if (const auto result = ring.submit(1); result != 0) {
+            return result;
+        }
+
+        io_uring_cqe completion{};
+        while (ring.pop(completion)) {
+            const auto slot = static_cast<unsigned>(completion.user_data);
+            auto& pending = slots[slot];
+
+            if (completion.res == -EAGAIN || completion.res == -EINTR) {
+                if (!queue(slot)) {
+                    return EBUSY;
+                }
+                continue;
+            }
+            if (completion.res < 0) {
+                return -completion.res;
+            }
+            if (completion.res == 0) {
+                return EIO;
+            }
+
+            /* Short transfers are resubmitted for the remainder from the same slot. */
+            pending.offset += static_cast<std::size_t>(completion.res);
+            pending.length -= static_cast<std::size_t>(completion.res);
+            if (pending.length > 0) {
+                if (!queue(slot)) {
+                    return EBUSY;
+                }
+                continue;
+            }
+
+            free_slots[free_count++] = slot;
+            --in_flight;
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * Moves the extents of data between memory and file; extents is modified. The
+ * page-aligned bulk goes through io_uring when possible; a sub-page tail left
+ * over by O_DIRECT goes through the page cache. Returns 0 or an errno.
+ */
+[[nodiscard]] static int
+transfer_file(const int fd, std::span<std::byte> data, std::span<extent> extents, const bool direct, const std::size_t chunk_size, const unsigned queue_depth, const bool use_io_uring, const direction dir) noexcept
+{
+    const auto page = page_size();
+    const auto chunk = std::min(align_up(std::max(chunk_size, page), page), MAX_FIXED_BUFFER);
+    const auto bulk = direct ? data.size() - data.size() % page : data.size();
+
+    /* Extents are page-aligned, so only the last one can reach into the tail. */
+    std::size_t tail = data.size();
+    if (!extents.empty() && extents.back().offset + extents.back().length > bulk) {
+        tail = std::max(extents.back().offset, bulk);
+        extents.back().length = tail - extents.back().offset;
+        if (extents.back().length == 0) {
+            extents = extents.first(extents.size() - 1);
+        }
+    }
+
+    std::optional<int> result;
+    if (use_io_uring && !extents.empty()) {
+        if (auto ring = io_ring::setup(std::clamp(queue_depth, 1U, MAX_QUEUE_DEPTH))) {
+            /* Registering pins every page, which would populate the holes being skipped. */
+            const bool whole = extents.size() == 1 && extents.front().offset == 0 && extents.front().length == bulk;
+            const auto fixed_span = whole ? register_fixed(*ring, data.first(bulk), chunk) : 0;
+            result = transfer_through_ring(*ring, fd, data, extents, chunk, fixed_span, dir);
+        }
+    }
+    if (!result) {
+        result = 0;
+        for (const auto& range : extents) {
+            if ((*result = transfer_all(fd, data.subspan(range.offset, range.length), range.offset, chunk, dir)) != 0) {
+                break;
+            }
+        }
+    }
+    if (*result != 0 || tail == data.size()) {
+        return *result;
+    }
+
+    if (direct && fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_DIRECT) == -1) {
+        return errno;
+    }
+    return transfer_all(fd, data.subspan(tail), tail, chunk, dir);
+}
+
+/* Finds the ranges of a segment mapping that were ever written, or std::nullopt if that cannot be known. */
+[[nodiscard]] static std::optional<std::vector<extent>>
+populated_extents(const int fd, const bool named, std::span<const std::byte> view, const std::size_t map_offset) noexcept
+{
+    /* File offsets only match mapping offsets when the whole object is mapped. */
+    struct stat st{};
+    if (fd != owned_fd::INVALID_FD && map_offset == 0 && fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) == view.size()) {
+        if (auto extents = data_extents(fd, view.size())) {
+            return extents;
+        }
+    }
+
+    /* Without swap, a shm page is resident exactly when it has been written. */
+    struct sysinfo info{};
+    if (named && map_offset == 0 && sysinfo(&info) == 0 && info.totalswap == 0) {
+        return resident_extents(view);
+    }
+
+    return std::nullopt;
+}
+
+/* Opens path with O_DIRECT when requested, falling back to buffered I/O where the file system refuses it. */
+[[nodiscard]] static owned_fd
+open_for_transfer(const std::filesystem::path& path, const int flags, const bool want_direct, bool& direct) noexcept
+{
+    direct = false;
+    if (want_direct) {
+        auto file = owned_fd(::open(path.c_str(), flags | O_DIRECT, 0644));
+        if (file.is_valid()) {
+            direct = true;
+            return file;
+        }
+    }
+    return owned_fd(::open(path.c_str(), flags, 0644));
+}
+
+}
+
+[[nodiscard]] std::expected<void, error>
+shared_memory::checkpoint(const std::filesystem::path& path, const checkpoint_options& options) const noexcept
+{
+    /* O_DIRECT needs page-aligned memory; range mappings may start mid-page. */
+    const bool aligned = reinterpret_cast<std::uintptr_t>(_mem_view.data()) % page_size() == 0;
+    bool direct = false;
+    auto file = open_for_transfer(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, options.direct_io && aligned, direct);
+    if (!file.is_valid()) {
+        return std::unexpected(error(errc::open_failed, {errno, std::generic_category()}));
+    }
+
+    if (ftruncate(file.get(), static_cast<off_t>(_mem_view.size())) == -1) {
+        return std::unexpected(error(errc::truncate_failed, {errno, std::generic_category()}));
+    }
+
+    /* Skipped ranges stay holes in the truncated file. */
+    extent whole{0, _mem_view.size()};
+    std::optional<std::vector<extent>> populated;
+    if (options.skip_holes) {
+        populated = populated_extents(_fd.is_valid() ? _fd.get() : _unlink_fd.get(), _named, _mem_view, _map_offset);
+    }
+    auto extents = populated ? std::span<extent>(*populated) : std::span<extent>(&whole, 1);
+
+    /* Writes only read from the mapping; the span is non-const because the helpers also serve restore(). */
+    if (const auto result = transfer_file(file.get(), _mem_view, extents, direct, options.chunk_size, options.queue_depth, options.use_io_uring, direction::WRITE); result != 0) {
+        return std::unexpected(error(errc::write_failed, {result, std::generic_category()}));
+    }
+
+    if (options.sync && fdatasync(file.get()) == -1) {
+        return std::unexpected(error(errc::write_failed, {errno, std::generic_category()}));
+    }
+
+    return {};
+}
+
+[[nodiscard]] std::expected<shared_memory, error>
+shared_memory::restore(const std::filesystem::path& path, const segment_name& shm_name, const restore_options& options) noexcept
+{
+    const bool writable = options.segment.mode == access_mode::READ_WRITE;
+
+    if (options.mode == restore_mode::MAPPED_FILE) {
+        auto file = owned_fd(::open(path.c_str(), (writable ? O_RDWR : O_RDONLY) | O_CLOEXEC));
+        if (!file.is_valid()) {
+            return std::unexpected(error(errc::open_failed, {errno, std::generic_category()}));
+        }
+
+        struct stat st{};
+        if (fstat(file.get(), &st) == -1) {
+            return std::unexpected(error(errc::stat_failed, {errno, std::generic_category()}));
+        }
+
+        const auto size = static_cast<std::size_t>(st.st_size);
+        const int prot = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+        void *addr = mmap(nullptr, size, prot, MAP_SHARED | (options.segment.prefault ? MAP_POPULATE : 0), file.get(), 0);
+        if (addr == MAP_FAILED) {
+            return std::unexpected(error(errc::map_failed, {errno, std::generic_category()}));
+        }
+
+        auto result = shared_memory({static_cast<std::byte *>(addr), size}, false);
+        result._deferred_unmap = options.segment.deferred_unmap;
+        if (options.segment.retain_fd) {
+            result._fd = std::move(file);
+        }
+        return result;
+    }
+
+    /* The segment is filled through its own mapping, so it must be writable. */
+    if (!writable) {
+        return std::unexpected(error(errc::open_failed, {EINVAL, std::generic_category()}));
+    }
+
+    bool direct = false;
+    auto file = open_for_transfer(path, O_RDONLY | O_CLOEXEC, options.direct_io, direct);
+    if (!file.is_valid()) {
+        return std::unexpected(error(errc::open_failed, {errno, std::generic_category()}));
+    }
+
+    struct stat st{};
+    if (fstat(file.get(), &st) == -1) {
+        return std::unexpected(error(errc::stat_failed, {errno, std::generic_category()}));
+    }
+
+    auto segment_options = options.segment;
+    segment_options.prefault = false;
+    auto restored = create(shm_name, static_cast<std::size_t>(st.st_size), segment_options);
+    if (!restored) {
+        return std::unexpected(restored.error());
+    }
+
+    /* Holes in the file are left untouched, so they cost neither reads nor segment pages. */
+    extent whole{0, restored->_mem_view.size()};
+    std::optional<std::vector<extent>> populated;
+    if (options.skip_holes) {
+        populated = data_extents(file.get(), whole.length);
+    }
+    auto extents = populated ? std::span<extent>(*populated) : std::span<extent>(&whole, 1);
+
+    /* Unlink a half-filled segment on failure even if the caller wanted it kept. */
+    restored->_should_unlink = true;
+    if (const auto result = transfer_file(file.get(), restored->_mem_view, extents, direct, options.chunk_size, options.queue_depth, options.use_io_uring, direction::READ); result != 0) {
+        return std::unexpected(error(errc::read_failed, {result, std::generic_category()}));
+    }
+    restored->_should_unlink = options.segment.should_unlink;
+
+    return restored;
+}
+
+[[nodiscard]] std::expected<shared_memory, error>
+shared_memory::restore(const std::filesystem::path& path, std::string_view shm_name, const restore_options& options) noexcept
+{
+    auto name = segment_name::make(shm_name);
+    if (!name) {
+        return std::unexpected(name.error());
+    }
+
+    return restore(path, *name, options);
+}
+
+} // namespace shared_memory
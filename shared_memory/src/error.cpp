@@ -52,6 +52,12 @@ to_string(errc kind) noexcept
         case errc::truncate_failed: return "shared memory truncate failed";
         case errc::map_failed:      return "shared memory map failed";
         case errc::stat_failed:     return "shared memory stat failed";
+        case errc::populate_failed: return "shared memory populate failed";
+        case errc::allocate_failed: return "shared memory allocate failed";
+        case errc::wait_failed:     return "shared memory wait failed";
+        case errc::layout_mismatch: return "shared memory layout mismatch";
+        case errc::write_failed:    return "shared memory write failed";
+        case errc::read_failed:     return "shared memory read failed";
         default:                    return "unknown shared memory error";
     }
 }
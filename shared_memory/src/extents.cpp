@@ -0,0 +1,133 @@
+/**************************************************************
+ * @file extents.cpp
+ * @brief Implementation of populated range discovery.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#include "extents.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <new>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "page_size.hpp"
+
+namespace shared_memory {
+
+namespace {
+
+/* mincore() results examined per call. */
+constexpr std::size_t RESIDENCY_WINDOW = 4096;
+
+/* Appends [begin, end), merging with the previous range when they touch. */
+static void
+append(std::vector<extent>& extents, const std::size_t begin, const std::size_t end)
+{
+    if (!extents.empty() && extents.back().offset + extents.back().length >= begin) {
+        extents.back().length = std::max(extents.back().length, end - extents.back().offset);
+        return;
+    }
+    extents.push_back(extent{begin, end - begin});
+}
+
+} // namespace
+
+[[nodiscard]] std::optional<std::vector<extent>>
+data_extents(const int fd, const std::size_t size) noexcept
+{
+    const auto page = page_size();
+
+    try {
+        std::vector<extent> extents;
+        for (std::size_t position = 0; position < size;) {
+            const auto data = lseek(fd, static_cast<off_t>(position), SEEK_DATA);
+            if (data == -1) {
+                /* ENXIO: nothing but holes past position. */
+                if (errno == ENXIO) {
+                    break;
+                }
+                return std::nullopt;
+            }
+            const auto hole = lseek(fd, data, SEEK_HOLE);
+            if (hole == -1) {
+                return std::nullopt;
+            }
+
+            const auto begin = static_cast<std::size_t>(data) & ~(page - 1);
+            if (begin >= size) {
+                break;
+            }
+            const auto end = std::min((static_cast<std::size_t>(hole) + page - 1) & ~(page - 1), size);
+            append(extents, begin, end);
+            position = end;
+        }
+        return extents;
+    } catch (const std::bad_alloc&) {
+        return std::nullopt;
+    }
+}
+
+[[nodiscard]] std::optional<std::vector<extent>>
+resident_extents(std::span<const std::byte> mapping) noexcept
+{
+    const auto page = page_size();
+    const auto pages = (mapping.size() + page - 1) / page;
+    std::array<unsigned char, RESIDENCY_WINDOW> residency{};
+
+    try {
+        std::vector<extent> extents;
+        for (std::size_t first = 0; first < pages; first += RESIDENCY_WINDOW) {
+            const auto count = std::min(RESIDENCY_WINDOW, pages - first);
+            auto *addr = const_cast<std::byte *>(mapping.data()) + first * page;
+            if (mincore(addr, count * page, residency.data()) == -1) {
+                return std::nullopt;
+            }
+
+            for (std::size_t i = 0; i < count; ++i) {
+                if ((residency[i] & 1) != 0) {
+                    const auto begin = (first + i) * page;
+                    append(extents, begin, std::min(begin + page, mapping.size()));
+                }
+            }
+        }
+        return extents;
+    } catch (const std::bad_alloc&) {
+        return std::nullopt;
+    }
+}
+
+} // namespace shared_memory
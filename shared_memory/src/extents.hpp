@@ -0,0 +1,80 @@
+/**************************************************************
+ * @file extents.hpp
+ * @brief Discovery of the populated ranges of files and mappings.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace shared_memory {
+
+/**
+ * @brief A byte range that may hold data; offsets are page-aligned.
+ */
+struct extent {
+    std::size_t offset;
+    std::size_t length;
+};
+
+/**
+ * @brief Lists the ranges of the first @p size bytes of @p fd that hold data.
+ *
+ * Walks the file with SEEK_DATA / SEEK_HOLE, so tmpfs / shm segments report
+ * only pages that were ever written (including swapped-out ones) and sparse
+ * regular files report only allocated blocks. Starts are rounded down and
+ * ends up to the page size, then clamped to @p size.
+ * @param fd A regular file or shm descriptor.
+ * @param size Bytes of the file of interest.
+ * @return The ranges in ascending order, or std::nullopt if the file system
+ * cannot tell or memory ran out.
+ */
+[[nodiscard]] std::optional<std::vector<extent>>
+data_extents(const int fd, const std::size_t size) noexcept;
+
+/**
+ * @brief Lists the ranges of a mapping whose pages are resident, using mincore().
+ *
+ * Only meaningful for shared memory that cannot be swapped: residency then
+ * equals "has been written". Swapped-out pages are reported as absent.
+ * @param mapping A page-aligned mapping.
+ * @return The ranges in ascending order, or std::nullopt on failure.
+ */
+[[nodiscard]] std::optional<std::vector<extent>>
+resident_extents(std::span<const std::byte> mapping) noexcept;
+
+} // namespace shared_memory
@@ -0,0 +1,90 @@
+/**************************************************************
+ * @file futex.hpp
+ * @brief Thin wrappers around the futex system call for
+ * process-shared wait/wake on segment-resident words.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <climits>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace shared_memory {
+
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "futex words must be plain 32-bit integers");
+
+/**
+ * @brief Blocks while @p word holds @p expected, or until @p timeout elapses.
+ *
+ * Uses the shared (non-private) futex variant so waiters and wakers may live in
+ * different processes mapping the same segment.
+ * @param word The futex word, typically inside a shared mapping.
+ * @param expected The value the caller observed; returns immediately if it changed.
+ * @param timeout Maximum time to block; negative values block indefinitely.
+ * @return 0 when woken, -1 with errno set (EAGAIN, ETIMEDOUT, EINTR) otherwise.
+ */
+inline int
+futex_wait(const std::atomic<std::uint32_t>& word, const std::uint32_t expected, const std::chrono::nanoseconds timeout = std::chrono::nanoseconds(-1)) noexcept
+{
+    timespec ts{};
+    timespec *ts_ptr{nullptr};
+    if (timeout.count() >= 0) {
+        ts.tv_sec = static_cast<time_t>(timeout.count() / 1'000'000'000);
+        ts.tv_nsec = static_cast<long>(timeout.count() % 1'000'000'000);
+        ts_ptr = &ts;
+    }
+
+    return static_cast<int>(syscall(SYS_futex, &word, FUTEX_WAIT, expected, ts_ptr, nullptr, 0));
+}
+
+/**
+ * @brief Wakes up to @p count waiters blocked on @p word.
+ * @param word The futex word, typically inside a shared mapping.
+ * @param count Maximum number of waiters to wake (default: all).
+ * @return The number of woken waiters, or -1 with errno set.
+ */
+inline int
+futex_wake(const std::atomic<std::uint32_t>& word, const int count = INT_MAX) noexcept
+{
+    return static_cast<int>(syscall(SYS_futex, &word, FUTEX_WAKE, count, nullptr, nullptr, 0));
+}
+
+} // namespace shared_memory
@@ -0,0 +1,457 @@
+/**************************************************************
+ * @file incremental_checkpoint.cpp
+ * @brief Implementation of incremental checkpoints.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#include "shared_memory/incremental_checkpoint.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "shared_memory/cache_line.hpp"
+#include "shared_memory/hash.hpp"
+
+#include "page_size.hpp"
+
+namespace shared_memory {
+
+namespace {
+
+constexpr std::uint64_t SOFT_DIRTY_BIT{std::uint64_t{1} << 55};
+constexpr std::size_t BATCH_PAGES{512};
+
+/* Soft-dirty bits are per process and clear_refs resets them all, so two trackers would erase each other's changes. */
+constinit std::atomic<bool> soft_dirty_in_use{false};
+
+struct delta_header {
+    std::uint64_t magic;
+    std::uint64_t segment_size;
+    std::uint64_t page_size;
+    std::uint64_t sequence;
+    std::uint64_t page_count;
+};
+
+[[nodiscard]] static std::size_t
+pages_in(const std::size_t bytes, const std::size_t page) noexcept
+{
+    return (bytes + page - 1) / page;
+}
+
+[[nodiscard]] static std::size_t
+bitmap_words(const std::size_t pages) noexcept
+{
+    return (pages + 63) / 64;
+}
+
+/* Word-at-a-time FNV-style hash; the rotation keeps high-bit changes from cancelling out. */
+[[nodiscard]] static std::uint64_t
+page_hash(std::span<const std::byte> page) noexcept
+{
+    std::uint64_t hash = FNV_OFFSET_BASIS;
+    std::size_t i = 0;
+    for (; i + sizeof(std::uint64_t) <= page.size(); i += sizeof(std::uint64_t)) {
+        std::uint64_t word;
+        std::memcpy(&word, page.data() + i, sizeof(word));
+        hash = std::rotl((hash ^ word) * FNV_PRIME, 31);
+    }
+    for (; i < page.size(); ++i) {
+        hash = (hash ^ static_cast<std::uint8_t>(page[i])) * FNV_PRIME;
+    }
+    return hash;
+}
+
+[[nodiscard]] static int
+write_all(const int fd, const std::byte *data, const std::size_t length, const std::size_t offset) noexcept
+{
+    for (std::size_t done = 0; done < length;) {
+        const auto written = pwrite(fd, data + done, length - done, static_cast<off_t>(offset + done));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno;
+        }
+        done += static_cast<std::size_t>(written);
+    }
+    return 0;
+}
+
+/* Returns 0, an errno, or EPROTO if the file ends early. */
+[[nodiscard]] static int
+read_all(const int fd, std::byte *data, const std::size_t length, const std::size_t offset) noexcept
+{
+    for (std::size_t done = 0; done < length;) {
+        const auto read_bytes = pread(fd, data + done, length - done, static_cast<off_t>(offset + done));
+        if (read_bytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno;
+        }
+        if (read_bytes == 0) {
+            return EPROTO;
+        }
+        done += static_cast<std::size_t>(read_bytes);
+    }
+    return 0;
+}
+
+/* Calls visit(position, first_page, run_pages) for each run of consecutive page indices. */
+template <typename Visitor>
+[[nodiscard]] static int
+for_each_run(const std::uint64_t *pages, const std::size_t count, const std::size_t base, Visitor visit) noexcept
+{
+    for (std::size_t start = 0; start < count;) {
+        std::size_t end = start + 1;
+        while (end < count && pages[end] == pages[end - 1] + 1) {
+            ++end;
+        }
+        if (const auto result = visit(base + start, pages[start], end - start); result != 0) {
+            return result;
+        }
+        start = end;
+    }
+    return 0;
+}
+
+[[nodiscard]] static std::expected<void, error>
+clear_soft_dirty() noexcept
+{
+    auto clear_refs = owned_fd(::open("/proc/self/clear_refs", O_WRONLY | O_CLOEXEC));
+    if (!clear_refs.is_valid()) {
+        return std::unexpected(error(errc::open_failed, {errno, std::generic_category()}));
+    }
+    if (::write(clear_refs.get(), "4", 1) != 1) {
+        return std::unexpected(error(errc::write_failed, {errno, std::generic_category()}));
+    }
+    return {};
+}
+
+}
+
+incremental_checkpoint::incremental_checkpoint(std::span<std::byte> memory, const dirty_tracking tracking, std::unique_ptr<std::uint64_t[]> hashes, std::unique_ptr<std::uint64_t[]> unwritten) noexcept
+: _memory(memory),
+  _tracking(tracking),
+  _hashes(std::move(hashes)),
+  _unwritten(std::move(unwritten))
+{}
+
+incremental_checkpoint::~incremental_checkpoint()
+{
+    if (_unwritten) {
+        soft_dirty_in_use.store(false, std::memory_order_release);
+    }
+}
+
+incremental_checkpoint::incremental_checkpoint(incremental_checkpoint&& other) noexcept
+: _memory(std::exchange(other._memory, {})),
+  _tracking(other._tracking),
+  _sequence(std::exchange(other._sequence, 0)),
+  _hashes(std::move(other._hashes)),
+  _unwritten(std::move(other._unwritten))
+{}
+
+incremental_checkpoint&
+incremental_checkpoint::operator=(incremental_checkpoint&& other) noexcept
+{
+    if (this != &other) {
+        if (_unwritten) {
+            soft_dirty_in_use.store(false, std::memory_order_release);
+        }
+        _memory = std::exchange(other._memory, {});
+        _tracking = other._tracking;
+        _sequence = std::exchange(other._sequence, 0);
+        _hashes = std::move(other._hashes);
+        _unwritten = std::move(other._unwritten);
+    }
+    return *this;
+}
+
+[[nodiscard]] bool
+incremental_checkpoint::soft_dirty_supported() noexcept
+{
+    const auto page = page_size();
+    void *probe = mmap(nullptr, page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (probe == MAP_FAILED) {
+        return false;
+    }
+
+    /* Freshly faulted pages start soft-dirty on kernels that track it. */
+    *static_cast<volatile char *>(probe) = 1;
+
+    bool supported = false;
+    auto pagemap = owned_fd(::open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC));
+    std::uint64_t entry = 0;
+    if (pagemap.is_valid() && pread(pagemap.get(), &entry, sizeof(entry), static_cast<off_t>(reinterpret_cast<std::uintptr_t>(probe) / page * sizeof(entry))) == sizeof(entry)) {
+        supported = (entry & SOFT_DIRTY_BIT) != 0;
+    }
+
+    munmap(probe, page);
+    return supported;
+}
+
+[[nodiscard]] std::expected<incremental_checkpoint, error>
+incremental_checkpoint::begin(shared_memory& segment, const std::filesystem::path& base_path, const dirty_tracking tracking, const checkpoint_options& options) noexcept
+{
+    if (tracking == dirty_tracking::SOFT_DIRTY && !soft_dirty_supported()) {
+        return std::unexpected(error(errc::open_failed, {ENOTSUP, std::generic_category()}));
+    }
+
+    const auto resolved = tracking == dirty_tracking::AUTO ? dirty_tracking::PAGE_HASH : tracking;
+    const auto memory = segment.get_memory();
+    const auto page = page_size();
+
+    /* Arm tracking before the base is written so writes made during it land in the first delta. */
+    std::unique_ptr<std::uint64_t[]> hashes;
+    std::unique_ptr<std::uint64_t[]> unwritten;
+    if (resolved == dirty_tracking::SOFT_DIRTY) {
+        unwritten.reset(new (std::nothrow) std::uint64_t[bitmap_words(std::max<std::size_t>(pages_in(memory.size(), page), 1))]());
+        if (!unwritten) {
+            return std::unexpected(error(errc::allocate_failed, {ENOMEM, std::generic_category()}));
+        }
+        if (soft_dirty_in_use.exchange(true, std::memory_order_acquire)) {
+            return std::unexpected(error(errc::open_failed, {EBUSY, std::generic_category()}));
+        }
+        if (auto cleared = clear_soft_dirty(); !cleared) {
+            soft_dirty_in_use.store(false, std::memory_order_release);
+            return std::unexpected(cleared.error());
+        }
+    } else {
+        const auto count = pages_in(memory.size(), page);
+        hashes.reset(new (std::nothrow) std::uint64_t[count]);
+        if (!hashes) {
+            return std::unexpected(error(errc::allocate_failed, {ENOMEM, std::generic_category()}));
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            hashes[i] = page_hash(memory.subspan(i * page, std::min(page, memory.size() - i * page)));
+        }
+    }
+
+    if (auto written = segment.checkpoint(base_path, options); !written) {
+        if (unwritten) {
+            soft_dirty_in_use.store(false, std::memory_order_release);
+        }
+        return std::unexpected(written.error());
+    }
+
+    return incremental_checkpoint(memory, resolved, std::move(hashes), std::move(unwritten));
+}
+
+[[nodiscard]] std::expected<std::size_t, error>
+incremental_checkpoint::_collect_soft_dirty(std::uint64_t *pages) noexcept
+{
+    auto pagemap = owned_fd(::open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC));
+    if (!pagemap.is_valid()) {
+        return std::unexpected(error(errc::open_failed, {errno, std::generic_category()}));
+    }
+
+    const auto page = page_size();
+    const auto count = pages_in(_memory.size(), page);
+    const auto first_entry = reinterpret_cast<std::uintptr_t>(_memory.data()) / page;
+
+    std::size_t dirty = 0;
+    std::array<std::uint64_t, BATCH_PAGES> entries{};
+    for (std::size_t batch = 0; batch < count; batch += BATCH_PAGES) {
+        const auto length = std::min(BATCH_PAGES, count - batch);
+        const auto result = read_all(pagemap.get(), reinterpret_cast<std::byte *>(entries.data()), length * sizeof(std::uint64_t), (first_entry + batch) * sizeof(std::uint64_t));
+        if (result != 0) {
+            return std::unexpected(error(errc::read_failed, {result, std::generic_category()}));
+        }
+
+        for (std::size_t i = 0; i < length; ++i) {
+            const auto index = batch + i;
+            if ((entries[i] & SOFT_DIRTY_BIT) != 0 || (_unwritten[index / 64] >> (index % 64) & 1) != 0) {
+                pages[dirty++] = index;
+            }
+        }
+    }
+
+    if (auto cleared = clear_soft_dirty(); !cleared) {
+        return std::unexpected(cleared.error());
+    }
+    return dirty;
+}
+
+/* Stores the new hash of each changed page next to its index; write_delta() commits them once the delta is durable. */
+[[nodiscard]] std::size_t
+incremental_checkpoint::_collect_changed_hashes(std::uint64_t *pages, std::uint64_t *hashes) const noexcept
+{
+    const auto page = page_size();
+    const auto count = pages_in(_memory.size(), page);
+
+    std::size_t changed = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto hash = page_hash(_memory.subspan(i * page, std::min(page, _memory.size() - i * page)));
+        if (hash != _hashes[i]) {
+            hashes[changed] = hash;
+            pages[changed++] = i;
+        }
+    }
+    return changed;
+}
+
+[[nodiscard]] std::expected<std::size_t, error>
+incremental_checkpoint::write_delta(const std::filesystem::path& path) noexcept
+{
+    const auto page = page_size();
+    const auto total = std::max<std::size_t>(pages_in(_memory.size(), page), 1);
+    const bool soft_dirty = _tracking == dirty_tracking::SOFT_DIRTY;
+
+    /* PAGE_HASH mode keeps the new hashes of the changed pages in the second half. */
+    std::unique_ptr<std::uint64_t[]> pages(new (std::nothrow) std::uint64_t[soft_dirty ? total : 2 * total]);
+    if (!pages) {
+        return std::unexpected(error(errc::allocate_failed, {ENOMEM, std::generic_category()}));
+    }
+
+    std::size_t count = 0;
+    if (soft_dirty) {
+        auto collected = _collect_soft_dirty(pages.get());
+        if (!collected) {
+            return std::unexpected(collected.error());
+        }
+        count = *collected;
+    } else {
+        count = _collect_changed_hashes(pages.get(), pages.get() + total);
+    }
+
+    auto written = _write_delta_file(path, pages.get(), count);
+    if (!written) {
+        /* The soft-dirty bits are already cleared; remember the pages so the next delta still carries them. */
+        if (soft_dirty) {
+            for (std::size_t i = 0; i < count; ++i) {
+                _unwritten[pages[i] / 64] |= std::uint64_t{1} << (pages[i] % 64);
+            }
+        }
+        return std::unexpected(written.error());
+    }
+
+    if (soft_dirty) {
+        std::fill_n(_unwritten.get(), bitmap_words(total), 0);
+    } else {
+        for (std::size_t i = 0; i < count; ++i) {
+            _hashes[pages[i]] = pages[total + i];
+        }
+    }
+    ++_sequence;
+    return count;
+}
+
+[[nodiscard]] std::expected<void, error>
+incremental_checkpoint::_write_delta_file(const std::filesystem::path& path, const std::uint64_t *pages, const std::size_t count) const noexcept
+{
+    const auto page = page_size();
+    auto file = owned_fd(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644));
+    if (!file.is_valid()) {
+        return std::unexpected(error(errc::open_failed, {errno, std::generic_category()}));
+    }
+
+    const delta_header header{MAGIC, _memory.size(), page, _sequence + 1, count};
+    const auto manifest_size = count * sizeof(std::uint64_t);
+    const auto data_offset = align_up(sizeof(header) + manifest_size, page);
+
+    int result = write_all(file.get(), reinterpret_cast<const std::byte *>(&header), sizeof(header), 0);
+    if (result == 0) {
+        result = write_all(file.get(), reinterpret_cast<const std::byte *>(pages), manifest_size, sizeof(header));
+    }
+    if (result == 0) {
+        result = for_each_run(pages, count, 0, [&](const std::size_t position, const std::uint64_t first_page, const std::size_t run) {
+            const auto offset = first_page * page;
+            const auto length = std::min(run * page, _memory.size() - offset);
+            return write_all(file.get(), _memory.data() + offset, length, data_offset + position * page);
+        });
+    }
+    if (result == 0 && fdatasync(file.get()) == -1) {
+        result = errno;
+    }
+    if (result != 0) {
+        return std::unexpected(error(errc::write_failed, {result, std::generic_category()}));
+    }
+    return {};
+}
+
+[[nodiscard]] std::expected<std::uint64_t, error>
+incremental_checkpoint::apply_delta(shared_memory& segment, const std::filesystem::path& path) noexcept
+{
+    auto file = owned_fd(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+    if (!file.is_valid()) {
+        return std::unexpected(error(errc::open_failed, {errno, std::generic_category()}));
+    }
+
+    delta_header header{};
+    if (const auto result = read_all(file.get(), reinterpret_cast<std::byte *>(&header), sizeof(header), 0); result != 0) {
+        return std::unexpected(error(result == EPROTO ? errc::layout_mismatch : errc::read_failed, {result, std::generic_category()}));
+    }
+
+    auto memory = segment.get_memory();
+    if (header.magic != MAGIC || header.segment_size != memory.size() || header.page_size == 0 || !std::has_single_bit(header.page_size)) {
+        return std::unexpected(error(errc::layout_mismatch, {EPROTO, std::generic_category()}));
+    }
+
+    const auto page = static_cast<std::size_t>(header.page_size);
+    const auto total = pages_in(memory.size(), page);
+    const auto data_offset = align_up(sizeof(header) + header.page_count * sizeof(std::uint64_t), page);
+
+    std::array<std::uint64_t, BATCH_PAGES> pages{};
+    for (std::size_t batch = 0; batch < header.page_count; batch += BATCH_PAGES) {
+        const auto length = std::min<std::size_t>(BATCH_PAGES, header.page_count - batch);
+        auto result = read_all(file.get(), reinterpret_cast<std::byte *>(pages.data()), length * sizeof(std::uint64_t), sizeof(header) + batch * sizeof(std::uint64_t));
+        if (result == 0 && std::any_of(pages.begin(), pages.begin() + length, [&](const std::uint64_t index) { return index >= total; })) {
+            result = EPROTO;
+        }
+        if (result == 0) {
+            result = for_each_run(pages.data(), length, batch, [&](const std::size_t position, const std::uint64_t first_page, const std::size_t run) {
+                const auto offset = first_page * page;
+                const auto bytes = std::min(run * page, memory.size() - offset);
+                return read_all(file.get(), memory.data() + offset, bytes, data_offset + position * page);
+            });
+        }
+        if (result != 0) {
+            return std::unexpected(error(result == EPROTO ? errc::layout_mismatch : errc::read_failed, {result, std::generic_category()}));
+        }
+    }
+
+    return header.sequence;
+}
+
+} // namespace shared_memory
@@ -0,0 +1,231 @@
+/**************************************************************
+ * @file intern_table.cpp
+ * @brief Implementation of the shared string interning table.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#include "shared_memory/intern_table.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+#include "shared_memory/hash.hpp"
+
+namespace shared_memory {
+
+struct alignas(CACHE_LINE_SIZE) intern_table::table_header {
+    std::uint64_t magic;
+    std::uint64_t max_strings;
+    std::uint64_t slot_count;
+    std::uint64_t arena_bytes;
+    cache_padded<std::atomic<std::uint32_t>> next_id;
+    cache_padded<std::atomic<std::uint64_t>> arena_used;
+};
+
+namespace {
+
+struct region_offsets {
+    std::size_t slots;
+    std::size_t entries;
+    std::size_t arena;
+    std::size_t end;
+};
+
+[[nodiscard]] static std::size_t
+slot_count_for(const std::size_t max_strings) noexcept
+{
+    return std::bit_ceil(std::max<std::size_t>(max_strings * 2, 2));
+}
+
+[[nodiscard]] static region_offsets
+offsets_for(const std::size_t max_strings, const std::size_t slot_count, const std::size_t arena_bytes, const std::size_t header_size, const std::size_t entry_size) noexcept
+{
+    region_offsets offsets{};
+    offsets.slots = align_up(header_size);
+    offsets.entries = align_up(offsets.slots + slot_count * sizeof(std::atomic<std::uint32_t>));
+    offsets.arena = align_up(offsets.entries + max_strings * entry_size);
+    offsets.end = offsets.arena + arena_bytes;
+    return offsets;
+}
+
+}
+
+[[nodiscard]] std::size_t
+intern_table::required_size(const std::size_t max_strings, const std::size_t arena_bytes) noexcept
+{
+    return offsets_for(max_strings, slot_count_for(max_strings), arena_bytes, sizeof(table_header), sizeof(entry)).end;
+}
+
+intern_table::intern_table(std::span<std::byte> region, table_header *header) noexcept
+: _header(header)
+{
+    const auto offsets = offsets_for(header->max_strings, header->slot_count, header->arena_bytes, sizeof(table_header), sizeof(entry));
+    _slots = reinterpret_cast<std::atomic<std::uint32_t> *>(region.data() + offsets.slots);
+    _entries = reinterpret_cast<entry *>(region.data() + offsets.entries);
+    _arena = reinterpret_cast<char *>(region.data() + offsets.arena);
+    _slot_mask = header->slot_count - 1;
+}
+
+[[nodiscard]] std::expected<intern_table, error>
+intern_table::create(std::span<std::byte> region, const std::size_t max_strings, const std::size_t arena_bytes) noexcept
+{
+    if (reinterpret_cast<std::uintptr_t>(region.data()) % CACHE_LINE_SIZE != 0 || max_strings == 0 || max_strings > (std::size_t{1} << 31)) {
+        return std::unexpected(error(errc::layout_mismatch, {EINVAL, std::generic_category()}));
+    }
+
+    const auto size = required_size(max_strings, arena_bytes);
+    if (region.size() < size) {
+        return std::unexpected(error(errc::layout_mismatch, {ENOSPC, std::generic_category()}));
+    }
+
+    std::memset(region.data(), 0, size);
+
+    auto *header = ::new (static_cast<void *>(region.data())) table_header{};
+    header->max_strings = max_strings;
+    header->slot_count = slot_count_for(max_strings);
+    header->arena_bytes = arena_bytes;
+    std::atomic_ref(header->magic).store(MAGIC, std::memory_order_release);
+
+    return intern_table(region, header);
+}
+
+[[nodiscard]] std::expected<intern_table, error>
+intern_table::attach(std::span<std::byte> region) noexcept
+{
+    if (region.size() < sizeof(table_header) || reinterpret_cast<std::uintptr_t>(region.data()) % CACHE_LINE_SIZE != 0) {
+        return std::unexpected(error(errc::layout_mismatch, {EPROTO, std::generic_category()}));
+    }
+
+    auto *header = std::launder(reinterpret_cast<table_header *>(region.data()));
+    if (std::atomic_ref(header->magic).load(std::memory_order_acquire) != MAGIC
+        || !std::has_single_bit(header->slot_count)
+        || region.size() < required_size(header->max_strings, header->arena_bytes)) {
+        return std::unexpected(error(errc::layout_mismatch, {EPROTO, std::generic_category()}));
+    }
+
+    return intern_table(region, header);
+}
+
+[[nodiscard]] bool
+intern_table::_matches(const std::uint32_t id, const std::uint64_t hash, std::string_view value) const noexcept
+{
+    const auto& candidate = _entries[id];
+    return candidate.hash == hash
+        && candidate.length == value.size()
+        && std::memcmp(_arena + candidate.offset, value.data(), value.size()) == 0;
+}
+
+[[nodiscard]] std::optional<std::uint32_t>
+intern_table::_find(std::string_view value, const std::uint64_t hash) const noexcept
+{
+    for (std::size_t probe = 0, slot = hash & _slot_mask; probe <= _slot_mask; ++probe, slot = (slot + 1) & _slot_mask) {
+        const auto published = _slots[slot].load(std::memory_order_acquire);
+        if (published == 0) {
+            return std::nullopt;
+        }
+
+        if (_matches(published - 1, hash, value)) {
+            return published - 1;
+        }
+    }
+
+    return std::nullopt;
+}
+
+[[nodiscard]] std::optional<std::uint32_t>
+intern_table::find(std::string_view value) const noexcept
+{
+    return _find(value, fnv1a(value));
+}
+
+[[nodiscard]] std::expected<std::uint32_t, error>
+intern_table::intern(std::string_view value) noexcept
+{
+    const auto hash = fnv1a(value);
+    if (auto existing = _find(value, hash)) {
+        return *existing;
+    }
+
+    if (value.size() > MAX_LENGTH) {
+        return std::unexpected(error(errc::allocate_failed, {EINVAL, std::generic_category()}));
+    }
+
+    const auto id = _header->next_id->fetch_add(1, std::memory_order_relaxed);
+    if (id >= _header->max_strings) {
+        return std::unexpected(error(errc::allocate_failed, {ENOSPC, std::generic_category()}));
+    }
+
+    const auto offset = _header->arena_used->fetch_add(value.size(), std::memory_order_relaxed);
+    if (offset > _header->arena_bytes || value.size() > _header->arena_bytes - offset) {
+        return std::unexpected(error(errc::allocate_failed, {ENOSPC, std::generic_category()}));
+    }
+
+    std::memcpy(_arena + offset, value.data(), value.size());
+    _entries[id] = entry{hash, offset, static_cast<std::uint32_t>(value.size()), 0};
+
+    for (std::size_t probe = 0, slot = hash & _slot_mask; probe <= _slot_mask; ++probe, slot = (slot + 1) & _slot_mask) {
+        auto published = _slots[slot].load(std::memory_order_acquire);
+        if (published == 0 && _slots[slot].compare_exchange_strong(published, id + 1, std::memory_order_release, std::memory_order_acquire)) {
+            return id;
+        }
+
+        /* Either the slot was taken before we looked or another inserter just won it. */
+        if (_matches(published - 1, hash, value)) {
+            return published - 1;
+        }
+    }
+
+    return std::unexpected(error(errc::allocate_failed, {ENOSPC, std::generic_category()}));
+}
+
+[[nodiscard]] std::string_view
+intern_table::resolve(const std::uint32_t id) const noexcept
+{
+    if (id >= std::min<std::size_t>(size(), _header->max_strings)) {
+        return {};
+    }
+
+    const auto& resolved = _entries[id];
+    return {_arena + resolved.offset, resolved.length};
+}
+
+[[nodiscard]] std::size_t
+intern_table::size() const noexcept
+{
+    return _header->next_id->load(std::memory_order_acquire);
+}
+
+} // namespace shared_memory
@@ -0,0 +1,190 @@
+/**************************************************************
+ * @file io_uring.cpp
+ * @brief Implementation of the minimal io_uring wrapper.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#include "io_uring.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace shared_memory {
+
+namespace {
+
+[[nodiscard]] static unsigned
+load_acquire(const unsigned *field) noexcept
+{
+    return std::atomic_ref(*const_cast<unsigned *>(field)).load(std::memory_order_acquire);
+}
+
+static void
+store_release(unsigned *field, const unsigned value) noexcept
+{
+    std::atomic_ref(*field).store(value, std::memory_order_release);
+}
+
+}
+
+[[nodiscard]] std::expected<io_ring, int>
+io_ring::setup(const unsigned entries) noexcept
+{
+    io_ring ring;
+
+    const auto fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &ring._params));
+    if (fd < 0) {
+        return std::unexpected(errno);
+    }
+    ring._fd = owned_fd(fd);
+
+    const auto& params = ring._params;
+    ring._sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring._cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+    const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+        ring._sq_ring_size = ring._cq_ring_size = std::max(ring._sq_ring_size, ring._cq_ring_size);
+    }
+
+    ring._sq_ring = mmap(nullptr, ring._sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (ring._sq_ring == MAP_FAILED) {
+        ring._sq_ring = nullptr;
+        return std::unexpected(errno);
+    }
+
+    if (single_mmap) {
+        ring._cq_ring = ring._sq_ring;
+    } else {
+        ring._cq_ring = mmap(nullptr, ring._cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (ring._cq_ring == MAP_FAILED) {
+            ring._cq_ring = nullptr;
+            return std::unexpected(errno);
+        }
+    }
+
+    ring._sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    void *sqes = mmap(nullptr, ring._sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        return std::unexpected(errno);
+    }
+    ring._sqes = static_cast<io_uring_sqe *>(sqes);
+    ring._sq_tail = *ring._sq_field(params.sq_off.tail);
+
+    return ring;
+}
+
+void
+io_ring::_unmap() noexcept
+{
+    if (_sqes != nullptr) {
+        munmap(_sqes, _sqes_size);
+        _sqes = nullptr;
+    }
+    if (_cq_ring != nullptr && _cq_ring != _sq_ring) {
+        munmap(_cq_ring, _cq_ring_size);
+    }
+    _cq_ring = nullptr;
+    if (_sq_ring != nullptr) {
+        munmap(_sq_ring, _sq_ring_size);
+        _sq_ring = nullptr;
+    }
+}
+
+[[nodiscard]] int
+io_ring::register_buffers(std::span<const iovec> buffers) noexcept
+{
+    if (syscall(__NR_io_uring_register, _fd.get(), IORING_REGISTER_BUFFERS, buffers.data(), static_cast<unsigned>(buffers.size())) < 0) {
+        return errno;
+    }
+    return 0;
+}
+
+[[nodiscard]] io_uring_sqe *
+io_ring::next_sqe() noexcept
+{
+    const auto head = load_acquire(_sq_field(_params.sq_off.head));
+    if (_sq_tail - head >= _params.sq_entries) {
+        return nullptr;
+    }
+
+    const auto index = _sq_tail & *_sq_field(_params.sq_off.ring_mask);
+    _sq_field(_params.sq_off.array)[index] = index;
+    ++_sq_tail;
+    ++_to_submit;
+
+    auto *sqe = &_sqes[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+[[nodiscard]] int
+io_ring::submit(const unsigned wait_for) noexcept
+{
+    store_release(_sq_field(_params.sq_off.tail), _sq_tail);
+
+    const unsigned flags = wait_for > 0 ? IORING_ENTER_GETEVENTS : 0;
+    for (;;) {
+        const auto submitted = syscall(__NR_io_uring_enter, _fd.get(), _to_submit, wait_for, flags, nullptr, 0);
+        if (submitted >= 0) {
+            _to_submit -= static_cast<unsigned>(submitted);
+            return 0;
+        }
+        if (errno != EINTR) {
+            return errno;
+        }
+    }
+}
+
+[[nodiscard]] bool
+io_ring::pop(io_uring_cqe& out) noexcept
+{
+    auto *head_field = _cq_field(_params.cq_off.head);
+    const auto head = *head_field;
+    if (head == load_acquire(_cq_field(_params.cq_off.tail))) {
+        return false;
+    }
+
+    const auto index = head & *_cq_field(_params.cq_off.ring_mask);
+    out = reinterpret_cast<const io_uring_cqe *>(static_cast<std::byte *>(_cq_ring) + _params.cq_off.cqes)[index];
+    store_release(head_field, head + 1);
+    return true;
+}
+
+} // namespace shared_memory
@@ -0,0 +1,167 @@
+/**************************************************************
+ * @file io_uring.hpp
+ * @brief Minimal io_uring wrapper over the raw system calls.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <utility>
+
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+
+#include "shared_memory/owned_fd.hpp"
+
+namespace shared_memory {
+
+/**
+ * @brief A single io_uring instance driven without liburing.
+ *
+ * Only what the checkpoint paths need: queue SQEs, submit, and reap CQEs.
+ * Not thread-safe; each transfer owns its own ring.
+ */
+class io_ring {
+public:
+    io_ring() noexcept = default;
+    ~io_ring() { _unmap(); }
+
+    io_ring(const io_ring&) = delete;
+    io_ring& operator=(const io_ring&) = delete;
+
+    io_ring(io_ring&& other) noexcept
+    : _fd(std::move(other._fd)),
+      _sq_ring(std::exchange(other._sq_ring, nullptr)),
+      _sq_ring_size(std::exchange(other._sq_ring_size, 0)),
+      _cq_ring(std::exchange(other._cq_ring, nullptr)),
+      _cq_ring_size(std::exchange(other._cq_ring_size, 0)),
+      _sqes(std::exchange(other._sqes, nullptr)),
+      _sqes_size(std::exchange(other._sqes_size, 0)),
+      _params(other._params),
+      _sq_tail(std::exchange(other._sq_tail, 0)),
+      _to_submit(std::exchange(other._to_submit, 0))
+    {}
+
+    io_ring& operator=(io_ring&& other) noexcept
+    {
+        if (this != &other) {
+            _unmap();
+            _fd = std::move(other._fd);
+            _sq_ring = std::exchange(other._sq_ring, nullptr);
+            _sq_ring_size = std::exchange(other._sq_ring_size, 0);
+            _cq_ring = std::exchange(other._cq_ring, nullptr);
+            _cq_ring_size = std::exchange(other._cq_ring_size, 0);
+            _sqes = std::exchange(other._sqes, nullptr);
+            _sqes_size = std::exchange(other._sqes_size, 0);
+            _params = other._params;
+            _sq_tail = std::exchange(other._sq_tail, 0);
+            _to_submit = std::exchange(other._to_submit, 0);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Creates a ring with at least @p entries submission slots.
+     * @param entries Requested submission queue depth.
+     * @return The ring, or the errno from io_uring_setup or mmap (ENOSYS or
+     * EPERM when io_uring is unavailable or disabled).
+     */
+    [[nodiscard]] static std::expected<io_ring, int>
+    setup(const unsigned entries) noexcept;
+
+    /**
+     * @brief Registers fixed buffers for the *_FIXED opcodes.
+     * @param buffers The buffers; index i is used as buf_index.
+     * @return 0 on success, or the errno (typically ENOMEM under RLIMIT_MEMLOCK).
+     */
+    [[nodiscard]] int
+    register_buffers(std::span<const iovec> buffers) noexcept;
+
+    /**
+     * @brief Returns a zeroed SQE to fill, queued for the next submit().
+     * @return The SQE, or nullptr if the submission queue is full.
+     */
+    [[nodiscard]] io_uring_sqe *
+    next_sqe() noexcept;
+
+    /**
+     * @brief Submits queued SQEs and waits for at least @p wait_for completions.
+     * @param wait_for Number of completions to wait for (0 to only submit).
+     * @return 0 on success, or the errno from io_uring_enter.
+     */
+    [[nodiscard]] int
+    submit(const unsigned wait_for) noexcept;
+
+    /**
+     * @brief Pops one completion if available.
+     * @param out Receives the completion.
+     * @return true if a completion was popped.
+     */
+    [[nodiscard]] bool
+    pop(io_uring_cqe& out) noexcept;
+
+    /**
+     * @brief Returns the submission queue depth granted by the kernel.
+     * @return The number of SQ entries.
+     */
+    [[nodiscard]] unsigned
+    depth() const noexcept { return _params.sq_entries; }
+
+private:
+    void
+    _unmap() noexcept;
+
+    [[nodiscard]] unsigned *
+    _sq_field(const std::uint32_t offset) const noexcept { return reinterpret_cast<unsigned *>(static_cast<std::byte *>(_sq_ring) + offset); }
+
+    [[nodiscard]] unsigned *
+    _cq_field(const std::uint32_t offset) const noexcept { return reinterpret_cast<unsigned *>(static_cast<std::byte *>(_cq_ring) + offset); }
+
+private:
+    owned_fd _fd{};
+    void *_sq_ring{nullptr};
+    std::size_t _sq_ring_size{0};
+    void *_cq_ring{nullptr};  // Aliases _sq_ring when the kernel supports IORING_FEAT_SINGLE_MMAP
+    std::size_t _cq_ring_size{0};
+    io_uring_sqe *_sqes{nullptr};
+    std::size_t _sqes_size{0};
+    io_uring_params _params{};
+    unsigned _sq_tail{0};
+    unsigned _to_submit{0};
+};
+
+} // namespace shared_memory
@@ -0,0 +1,441 @@
+/**************************************************************
+ * @file lazy_restore.cpp
+ * @brief Implementation of userfaultfd-based lazy restore.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#include "shared_memory/lazy_restore.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include <fcntl.h>
+#include <linux/userfaultfd.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "shared_memory/owned_fd.hpp"
+
+#include "extents.hpp"
+#include "page_size.hpp"
+
+namespace shared_memory {
+
+namespace {
+
+/* Pages filled per fault, so a sequential reader does not fault on every page. */
+constexpr std::size_t FAULT_CLUSTER_PAGES = 16;
+
+/* Bytes the streaming thread copies per UFFDIO_COPY. */
+constexpr std::size_t STREAM_CHUNK = std::size_t{1} << 20;
+
+/* Fault messages drained per read(2). */
+constexpr std::size_t MESSAGE_BATCH = 16;
+
+/* Opens a userfaultfd handling missing shmem pages, preferring one that also covers kernel-mode faults. */
+[[nodiscard]] static owned_fd
+open_userfaultfd() noexcept
+{
+    for (const int mode : {0, static_cast<int>(UFFD_USER_MODE_ONLY)}) {
+        auto uffd = owned_fd(static_cast<int>(syscall(SYS_userfaultfd, O_CLOEXEC | O_NONBLOCK | mode)));
+        if (!uffd.is_valid()) {
+            continue;
+        }
+
+        uffdio_api api{};
+        api.api = UFFD_API;
+        api.features = UFFD_FEATURE_MISSING_SHMEM;
+        if (ioctl(uffd.get(), UFFDIO_API, &api) == 0 && (api.features & UFFD_FEATURE_MISSING_SHMEM) != 0) {
+            return uffd;
+        }
+    }
+
+    return owned_fd{};
+}
+
+} // namespace
+
+struct lazy_restore::state {
+    shared_memory segment;
+    const std::byte *source{nullptr};
+    owned_fd file{};
+    std::size_t length{0};
+    owned_fd uffd{};
+    owned_fd stop{};
+    std::thread handler{};
+    std::thread streamer{};
+    std::atomic<bool> done{false};
+    std::atomic<int> failure{0};
+
+    ~state()
+    {
+        if (streamer.joinable()) {
+            streamer.join();
+        }
+        if (handler.joinable()) {
+            handler.join();
+        }
+        if (source != nullptr) {
+            munmap(const_cast<std::byte *>(source), length);
+        }
+    }
+
+    [[nodiscard]] std::byte *
+    target() noexcept { return segment.get_memory().data(); }
+
+    void
+    record(const int err) noexcept
+    {
+        int expected = 0;
+        failure.compare_exchange_strong(expected, err, std::memory_order_relaxed);
+    }
+
+    /* Copies [offset, offset + count) from the file, skipping pages another thread already filled. */
+    [[nodiscard]] int
+    fill(std::size_t offset, std::size_t count) noexcept
+    {
+        while (count > 0) {
+            uffdio_copy copy{};
+            copy.dst = reinterpret_cast<std::uintptr_t>(target() + offset);
+            copy.src = reinterpret_cast<std::uintptr_t>(source + offset);
+            copy.len = count;
+            if (ioctl(uffd.get(), UFFDIO_COPY, &copy) == 0) {
+                return 0;
+            }
+
+            /* A partial copy reports EAGAIN with the bytes done; the page that stopped it comes back as EEXIST. */
+            std::size_t advance = 0;
+            if (errno == EAGAIN) {
+                advance = copy.copy > 0 ? static_cast<std::size_t>(copy.copy) : 0;
+            } else if (errno == EEXIST) {
+                advance = page_size();
+            } else {
+                return errno;
+            }
+            offset += advance;
+            count -= advance;
+        }
+
+        return 0;
+    }
+
+    /*
+     * Places zeroed pages over a range that could not be read, so no access
+     * blocks forever. UFFDIO_ZEROPAGE is anonymous-only, so zeros are copied.
+     */
+    void
+    zero(std::size_t offset, std::size_t count) noexcept
+    {
+        static const auto *zeros = mmap(nullptr, page_size(), PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (zeros == MAP_FAILED) {
+            return;
+        }
+
+        for (const auto page = page_size(); count > 0; offset += page, count -= page) {
+            uffdio_copy copy{};
+            copy.dst = reinterpret_cast<std::uintptr_t>(target() + offset);
+            copy.src = reinterpret_cast<std::uintptr_t>(zeros);
+            copy.len = page;
+            ioctl(uffd.get(), UFFDIO_COPY, &copy);
+        }
+    }
+
+    void
+    serve(const std::uintptr_t address) noexcept
+    {
+        const auto page = page_size();
+        const auto offset = (address - reinterpret_cast<std::uintptr_t>(target())) & ~(page - 1);
+        const auto count = std::min(FAULT_CLUSTER_PAGES * page, length - offset);
+
+        if (const int err = fill(offset, count); err != 0) {
+            record(err);
+            zero(offset, count);
+        }
+
+        /* The streamer may have filled the page first; the faulting thread still waits for a wake. */
+        uffdio_range range{};
+        range.start = reinterpret_cast<std::uintptr_t>(target() + offset);
+        range.len = page;
+        ioctl(uffd.get(), UFFDIO_WAKE, &range);
+    }
+
+    void
+    handle_faults() noexcept
+    {
+        std::array<pollfd, 2> fds{{{uffd.get(), POLLIN, 0}, {stop.get(), POLLIN, 0}}};
+        std::array<uffd_msg, MESSAGE_BATCH> messages{};
+
+        while (true) {
+            /* Faulting threads block until served, so transient poll errors are retried rather than abandoned. */
+            if (poll(fds.data(), fds.size(), -1) == -1) {
+                continue;
+            }
+            if ((fds[1].revents & POLLIN) != 0) {
+                break;
+            }
+
+            const auto bytes = read(uffd.get(), messages.data(), sizeof(messages));
+            if (bytes <= 0) {
+                continue;
+            }
+            for (std::size_t i = 0; i < static_cast<std::size_t>(bytes) / sizeof(uffd_msg); ++i) {
+                if (messages[i].event == UFFD_EVENT_PAGEFAULT) {
+                    serve(messages[i].arg.pagefault.address);
+                }
+            }
+        }
+
+        /*
+         * Every page is present. Unregistering wakes faults still queued and keeps
+         * later hole punches from faulting into a handler that no longer runs.
+         */
+        uffdio_range range{};
+        range.start = reinterpret_cast<std::uintptr_t>(target());
+        range.len = length;
+        ioctl(uffd.get(), UFFDIO_UNREGISTER, &range);
+    }
+
+    void
+    stream_range(const std::size_t begin, const std::size_t end) noexcept
+    {
+        for (std::size_t offset = begin; offset < end; offset += STREAM_CHUNK) {
+            const auto count = std::min(STREAM_CHUNK, end - offset);
+            if (const int err = fill(offset, count); err != 0) {
+                record(err);
+                zero(offset, count);
+            }
+        }
+    }
+
+    /* Streams the file's data ranges in order; holes stay unpopulated and read as zeros once unregistered. */
+    void
+    stream() noexcept
+    {
+        if (const auto extents = data_extents(file.get(), length)) {
+            for (const auto& range : *extents) {
+                stream_range(range.offset, range.offset + range.length);
+            }
+        } else {
+            stream_range(0, length);
+        }
+        file = owned_fd{};
+
+        const std::uint64_t one = 1;
+        [[maybe_unused]] const auto written = ::write(stop.get(), &one, sizeof(one));
+
+        done.store(true, std::memory_order_release);
+        done.notify_all();
+    }
+
+    /* Restores without userfaultfd once the segment exists, reading through the file mapping; holes stay unpopulated. */
+    void
+    copy_eagerly() noexcept
+    {
+        if (const auto extents = data_extents(file.get(), segment.size())) {
+            for (const auto& range : *extents) {
+                std::memcpy(target() + range.offset, source + range.offset, range.length);
+            }
+        } else {
+            std::memcpy(target(), source, segment.size());
+        }
+        file = owned_fd{};
+        done.store(true, std::memory_order_release);
+    }
+};
+
+lazy_restore::lazy_restore() noexcept = default;
+
+lazy_restore::lazy_restore(std::unique_ptr<state> restore_state) noexcept
+  : _state(std::move(restore_state))
+{
+}
+
+lazy_restore::~lazy_restore() = default;
+
+lazy_restore::lazy_restore(lazy_restore&&) noexcept = default;
+
+lazy_restore& lazy_restore::operator=(lazy_restore&&) noexcept = default;
+
+[[nodiscard]] std::expected<lazy_restore, error>
+lazy_restore::start(const std::filesystem::path& path, const segment_name& shm_name, const restore_options& options) noexcept
+{
+    /* Pages are filled through the segment's own mapping, as in restore(). */
+    if (options.segment.mode != access_mode::READ_WRITE) {
+        return std::unexpected(error(errc::open_failed, {EINVAL, std::generic_category()}));
+    }
+
+    auto restore_state = std::unique_ptr<state>(new (std::nothrow) state{});
+    if (!restore_state) {
+        return std::unexpected(error(errc::allocate_failed, {ENOMEM, std::generic_category()}));
+    }
+
+    restore_state->uffd = open_userfaultfd();
+    restore_state->stop = owned_fd(eventfd(0, EFD_CLOEXEC));
+    if (!restore_state->uffd.is_valid() || !restore_state->stop.is_valid()) {
+        auto eager_options = options;
+        eager_options.mode = restore_mode::COPY;
+        auto restored = shared_memory::restore(path, shm_name, eager_options);
+        if (!restored) {
+            return std::unexpected(restored.error());
+        }
+        restore_state->segment = std::move(*restored);
+        restore_state->uffd = owned_fd{};
+        restore_state->done.store(true, std::memory_order_release);
+        return lazy_restore(std::move(restore_state));
+    }
+
+    auto file = owned_fd(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+    if (!file.is_valid()) {
+        return std::unexpected(error(errc::open_failed, {errno, std::generic_category()}));
+    }
+
+    struct stat st{};
+    if (fstat(file.get(), &st) == -1) {
+        return std::unexpected(error(errc::stat_failed, {errno, std::generic_category()}));
+    }
+
+    const auto size = static_cast<std::size_t>(st.st_size);
+    const auto page = page_size();
+    const auto length = (size + page - 1) & ~(page - 1);
+    if (size != 0) {
+        void *addr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, file.get(), 0);
+        if (addr == MAP_FAILED) {
+            return std::unexpected(error(errc::map_failed, {errno, std::generic_category()}));
+        }
+        madvise(addr, length, MADV_SEQUENTIAL);
+        restore_state->source = static_cast<const std::byte *>(addr);
+        restore_state->length = length;
+    }
+
+    /* Prefaulting or fallocate would instantiate zero pages and hide them from userfaultfd. */
+    auto segment_options = options.segment;
+    segment_options.prefault = false;
+    segment_options.preallocate = false;
+    auto created = shared_memory::create(shm_name, size, segment_options);
+    if (!created) {
+        return std::unexpected(created.error());
+    }
+    restore_state->segment = std::move(*created);
+
+    restore_state->file = std::move(file);
+
+    uffdio_register registration{};
+    registration.range.start = reinterpret_cast<std::uintptr_t>(restore_state->target());
+    registration.range.len = length;
+    registration.mode = UFFDIO_REGISTER_MODE_MISSING;
+    if (ioctl(restore_state->uffd.get(), UFFDIO_REGISTER, &registration) == -1
+        || (registration.ioctls & (std::uint64_t{1} << _UFFDIO_COPY)) == 0) {
+        restore_state->uffd = owned_fd{};
+        restore_state->copy_eagerly();
+        return lazy_restore(std::move(restore_state));
+    }
+
+    auto *raw = restore_state.get();
+    try {
+        raw->handler = std::thread([raw] { raw->handle_faults(); });
+        raw->streamer = std::thread([raw] { raw->stream(); });
+    } catch (const std::system_error&) {
+    } catch (const std::bad_alloc&) {
+    }
+
+    if (!raw->streamer.joinable()) {
+        /* Closing the descriptor unregisters the range; a started handler exits on the stop event. */
+        const std::uint64_t one = 1;
+        [[maybe_unused]] const auto written = ::write(raw->stop.get(), &one, sizeof(one));
+        if (raw->handler.joinable()) {
+            raw->handler.join();
+        }
+        raw->uffd = owned_fd{};
+        raw->copy_eagerly();
+    }
+
+    return lazy_restore(std::move(restore_state));
+}
+
+[[nodiscard]] std::expected<lazy_restore, error>
+lazy_restore::start(const std::filesystem::path& path, std::string_view shm_name, const restore_options& options) noexcept
+{
+    auto name = segment_name::make(shm_name);
+    if (!name) {
+        return std::unexpected(name.error());
+    }
+
+    return start(path, *name, options);
+}
+
+[[nodiscard]] shared_memory&
+lazy_restore::segment() noexcept
+{
+    return _state->segment;
+}
+
+[[nodiscard]] bool
+lazy_restore::is_lazy() const noexcept
+{
+    return _state && _state->uffd.is_valid();
+}
+
+[[nodiscard]] bool
+lazy_restore::complete() const noexcept
+{
+    return !_state || _state->done.load(std::memory_order_acquire);
+}
+
+[[nodiscard]] std::expected<void, error>
+lazy_restore::wait() noexcept
+{
+    if (!_state) {
+        return {};
+    }
+
+    _state->done.wait(false, std::memory_order_acquire);
+    if (const int err = _state->failure.load(std::memory_order_relaxed); err != 0) {
+        return std::unexpected(error(errc::read_failed, {err, std::generic_category()}));
+    }
+
+    return {};
+}
+
+} // namespace shared_memory
@@ -0,0 +1,309 @@
+/**************************************************************
+ * @file persistent_segment.cpp
+ * @brief Implementation of the file-backed persistent segment.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#include "shared_memory/persistent_segment.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "page_size.hpp"
+
+namespace shared_memory {
+
+namespace {
+
+constexpr std::size_t WORD_BITS = 64;
+
+} // namespace
+
+struct persistent_segment::state {
+    shared_memory segment;
+    sync_policy policy{};
+    std::unique_ptr<std::atomic<std::uint64_t>[]> dirty{};
+    std::size_t words{0};
+    /* Dirty pages; signed because a flush can claim bits before mark() has counted them. */
+    std::atomic<std::ptrdiff_t> pending{0};
+    std::atomic<int> failure{0};
+    std::mutex flush_mutex{};
+    std::mutex wake_mutex{};
+    std::condition_variable wake{};
+    bool requested{false};
+    bool stopping{false};
+    std::thread flusher{};
+
+    ~state()
+    {
+        if (flusher.joinable()) {
+            {
+                std::lock_guard lock(wake_mutex);
+                stopping = true;
+            }
+            wake.notify_one();
+            flusher.join();
+        }
+        flush();
+    }
+
+    void
+    mark(const std::size_t first, const std::size_t last) noexcept
+    {
+        std::size_t added = 0;
+        for (auto word = first / WORD_BITS; word <= last / WORD_BITS; ++word) {
+            const auto low = word == first / WORD_BITS ? first % WORD_BITS : 0;
+            const auto high = word == last / WORD_BITS ? last % WORD_BITS : WORD_BITS - 1;
+            const auto mask = (~std::uint64_t{0} >> (WORD_BITS - 1 - high)) & (~std::uint64_t{0} << low);
+
+            /* Skip the read-modify-write when every page is already dirty. */
+            auto& bits = dirty[word];
+            if ((bits.load(std::memory_order_relaxed) & mask) == mask) {
+                continue;
+            }
+            const auto previous = bits.fetch_or(mask, std::memory_order_release);
+            added += static_cast<std::size_t>(std::popcount(mask & ~previous));
+        }
+        if (added == 0) {
+            return;
+        }
+
+        const auto page = page_size();
+        const auto before = static_cast<std::size_t>(std::max<std::ptrdiff_t>(pending.fetch_add(static_cast<std::ptrdiff_t>(added), std::memory_order_relaxed), 0)) * page;
+        const auto after = before + added * page;
+        if (policy.dirty_threshold != 0 && before < policy.dirty_threshold && after >= policy.dirty_threshold && flusher.joinable()) {
+            {
+                std::lock_guard lock(wake_mutex);
+                requested = true;
+            }
+            wake.notify_one();
+        }
+    }
+
+    /* Syncs one run of dirty pages; a failed run is marked again so the next flush retries it. */
+    [[nodiscard]] int
+    sync_run(const std::size_t first, const std::size_t count) noexcept
+    {
+        const auto page = page_size();
+        auto memory = segment.get_memory();
+        const auto offset = first * page;
+        if (msync(memory.data() + offset, std::min(count * page, memory.size() - offset), MS_SYNC) == 0) {
+            return 0;
+        }
+
+        const int err = errno;
+        mark(first, first + count - 1);
+        return err;
+    }
+
+    /* Syncs every page dirty when the flush starts. Returns 0 or the first msync errno. */
+    int
+    flush() noexcept
+    {
+        std::lock_guard lock(flush_mutex);
+
+        int result = 0;
+        std::size_t run_first = 0;
+        std::size_t run_count = 0;
+        const auto emit = [&] {
+            if (run_count == 0) {
+                return;
+            }
+            if (const int err = sync_run(run_first, run_count); err != 0 && result == 0) {
+                result = err;
+            }
+            run_count = 0;
+        };
+
+        for (std::size_t word = 0; word < words; ++word) {
+            auto bits = dirty[word].exchange(0, std::memory_order_acquire);
+            pending.fetch_sub(std::popcount(bits), std::memory_order_relaxed);
+            while (bits != 0) {
+                const auto page = word * WORD_BITS + static_cast<std::size_t>(std::countr_zero(bits));
+                bits &= bits - 1;
+                if (run_count != 0 && run_first + run_count == page) {
+                    ++run_count;
+                    continue;
+                }
+                emit();
+                run_first = page;
+                run_count = 1;
+            }
+        }
+        emit();
+
+        if (result != 0) {
+            int expected = 0;
+            failure.compare_exchange_strong(expected, result, std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    void
+    run() noexcept
+    {
+        std::unique_lock lock(wake_mutex);
+        const auto woken = [this] { return stopping || requested; };
+
+        while (true) {
+            if (policy.interval.count() > 0) {
+                wake.wait_for(lock, policy.interval, woken);
+            } else {
+                wake.wait(lock, woken);
+            }
+            if (stopping) {
+                return;
+            }
+            requested = false;
+
+            lock.unlock();
+            flush();
+            lock.lock();
+        }
+    }
+};
+
+persistent_segment::persistent_segment() noexcept = default;
+
+persistent_segment::persistent_segment(std::unique_ptr<state> segment_state) noexcept
+  : _state(std::move(segment_state))
+{
+}
+
+persistent_segment::~persistent_segment() = default;
+
+persistent_segment::persistent_segment(persistent_segment&&) noexcept = default;
+
+persistent_segment& persistent_segment::operator=(persistent_segment&&) noexcept = default;
+
+[[nodiscard]] std::expected<persistent_segment, error>
+persistent_segment::open(const std::filesystem::path& path, const std::size_t size, const file_options& options, const sync_policy& policy) noexcept
+{
+    /* Flushing only makes sense for a mapping the caller writes through. */
+    if (options.mode != access_mode::READ_WRITE) {
+        return std::unexpected(error(errc::open_failed, {EINVAL, std::generic_category()}));
+    }
+
+    auto mapped = shared_memory::map_file(path, size, options);
+    if (!mapped) {
+        return std::unexpected(mapped.error());
+    }
+
+    auto segment_state = std::unique_ptr<state>(new (std::nothrow) state{});
+    if (!segment_state) {
+        return std::unexpected(error(errc::allocate_failed, {ENOMEM, std::generic_category()}));
+    }
+
+    const auto pages = (mapped->size() + page_size() - 1) / page_size();
+    segment_state->words = (pages + WORD_BITS - 1) / WORD_BITS;
+    segment_state->dirty.reset(new (std::nothrow) std::atomic<std::uint64_t>[segment_state->words]());
+    if (!segment_state->dirty && segment_state->words != 0) {
+        return std::unexpected(error(errc::allocate_failed, {ENOMEM, std::generic_category()}));
+    }
+    segment_state->segment = std::move(*mapped);
+    segment_state->policy = policy;
+
+    if (policy.interval.count() > 0 || policy.dirty_threshold != 0) {
+        auto *raw = segment_state.get();
+        try {
+            raw->flusher = std::thread([raw] { raw->run(); });
+        } catch (const std::system_error& e) {
+            return std::unexpected(error(errc::allocate_failed, e.code()));
+        } catch (const std::bad_alloc&) {
+            return std::unexpected(error(errc::allocate_failed, {ENOMEM, std::generic_category()}));
+        }
+    }
+
+    return persistent_segment(std::move(segment_state));
+}
+
+[[nodiscard]] shared_memory&
+persistent_segment::segment() noexcept
+{
+    return _state->segment;
+}
+
+void
+persistent_segment::mark_dirty(const std::size_t offset, const std::size_t length) noexcept
+{
+    const auto size = _state->segment.size();
+    if (length == 0 || offset >= size) {
+        return;
+    }
+
+    const auto page = page_size();
+    const auto end = offset + std::min(length, size - offset);
+    _state->mark(offset / page, (end - 1) / page);
+}
+
+[[nodiscard]] bool
+persistent_segment::write(const std::size_t offset, std::span<const std::byte> data) noexcept
+{
+    if (!_state->segment.write(offset, data)) {
+        return false;
+    }
+
+    mark_dirty(offset, data.size());
+    return true;
+}
+
+[[nodiscard]] std::expected<void, error>
+persistent_segment::barrier() noexcept
+{
+    _state->flush();
+    if (const int err = _state->failure.exchange(0, std::memory_order_relaxed); err != 0) {
+        return std::unexpected(error(errc::write_failed, {err, std::generic_category()}));
+    }
+
+    return {};
+}
+
+[[nodiscard]] std::size_t
+persistent_segment::dirty_bytes() const noexcept
+{
+    return static_cast<std::size_t>(std::max<std::ptrdiff_t>(_state->pending.load(std::memory_order_relaxed), 0)) * page_size();
+}
+
+} // namespace shared_memory
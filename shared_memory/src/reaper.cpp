@@ -0,0 +1,109 @@
+/**************************************************************
+ * @file reaper.cpp
+ * @brief Implementation of the deferred unmap reaper thread.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#include "reaper.hpp"
+
+#include <new>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include <sys/mman.h>
+
+namespace shared_memory {
+
+reaper&
+reaper::instance() noexcept
+{
+    static auto *instance = new reaper();
+    return *instance;
+}
+
+bool
+reaper::submit(void *addr, const std::size_t length) noexcept
+{
+    std::unique_lock lock(_mutex);
+
+    try {
+        if (!_started) {
+            std::thread([this] { _run(); }).detach();
+            _started = true;
+        }
+        _queue.push_back({addr, length});
+    } catch (const std::bad_alloc&) {
+        return false;
+    } catch (const std::system_error&) {
+        return false;
+    }
+
+    lock.unlock();
+    _work_ready.notify_one();
+
+    return true;
+}
+
+void
+reaper::drain() noexcept
+{
+    std::unique_lock lock(_mutex);
+    _work_done.wait(lock, [this] { return _queue.empty() && _in_flight == 0; });
+}
+
+void
+reaper::_run() noexcept
+{
+    std::vector<mapping> batch{};
+
+    std::unique_lock lock(_mutex);
+    while (true) {
+        _work_ready.wait(lock, [this] { return !_queue.empty(); });
+
+        std::swap(batch, _queue);
+        _in_flight = batch.size();
+        lock.unlock();
+
+        for (const auto& [addr, length] : batch) {
+            munmap(addr, length);
+        }
+        batch.clear();
+
+        lock.lock();
+        _in_flight = 0;
+        _work_done.notify_all();
+    }
+}
+
+} // namespace shared_memory
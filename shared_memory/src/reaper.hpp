@@ -0,0 +1,99 @@
+/**************************************************************
+ * @file reaper.hpp
+ * @brief Background thread that releases deferred shared memory
+ * mappings.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace shared_memory {
+
+/**
+ * @brief Process-wide worker that performs munmap off the caller's thread.
+ *
+ * The thread is started on the first submission. The instance is never
+ * destroyed, so handles released during static destruction can still submit.
+ */
+class reaper {
+public:
+    /**
+     * @brief Returns the process-wide reaper.
+     * @return A reference to the singleton reaper.
+     */
+    [[nodiscard]] static reaper&
+    instance() noexcept;
+
+    /* Non-copyable, non-movable */
+    reaper(const reaper&) = delete;
+    reaper& operator=(const reaper&) = delete;
+
+    /**
+     * @brief Queues a mapping for unmapping on the reaper thread.
+     * @param addr Start of the mapping.
+     * @param length Length of the mapping in bytes.
+     * @return true if queued; false if the caller must unmap inline.
+     */
+    [[nodiscard]] bool
+    submit(void *addr, const std::size_t length) noexcept;
+
+    /** @brief Blocks until every mapping queued so far has been unmapped. */
+    void
+    drain() noexcept;
+
+private:
+    struct mapping {
+        void *addr;
+        std::size_t length;
+    };
+
+    reaper() = default;
+
+    void
+    _run() noexcept;
+
+private:
+    std::mutex _mutex{};
+    std::condition_variable _work_ready{};
+    std::condition_variable _work_done{};
+    std::vector<mapping> _queue{};
+    std::size_t _in_flight{0};
+    bool _started{false};
+};
+
+} // namespace shared_memory
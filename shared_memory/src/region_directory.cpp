@@ -0,0 +1,210 @@
+/**************************************************************
+ * @file region_directory.cpp
+ * @brief Implementation of region_layout and region_directory.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#include "shared_memory/region_directory.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+#include "page_size.hpp"
+
+namespace shared_memory {
+
+namespace {
+
+/* Precedes the entries in the payload; padded to one cache line. */
+struct region_table {
+    std::uint64_t count;
+    std::uint64_t reserved[7];
+};
+
+static_assert(sizeof(region_table) == CACHE_LINE_SIZE, "region_table must stay one cache line");
+
+[[nodiscard]] static std::size_t
+table_end(const std::size_t count) noexcept
+{
+    return HEADER_SIZE + sizeof(region_table) + count * sizeof(region_entry);
+}
+
+}
+
+[[nodiscard]] std::expected<void, error>
+region_layout::add(std::string_view name, const std::size_t size, const std::size_t alignment)
+{
+    /* Entries are NUL-terminated in the table, so an embedded NUL would silently truncate the name. */
+    if (name.empty() || name.find('\0') != std::string_view::npos) {
+        return std::unexpected(error(errc::layout_mismatch, {EINVAL, std::generic_category()}));
+    }
+
+    if (name.size() > region_entry::NAME_CAPACITY) {
+        return std::unexpected(error(errc::layout_mismatch, {ENAMETOOLONG, std::generic_category()}));
+    }
+
+    if (!std::has_single_bit(alignment) || alignment > page_size()) {
+        return std::unexpected(error(errc::layout_mismatch, {EINVAL, std::generic_category()}));
+    }
+
+    const bool duplicate = std::ranges::any_of(_entries, [name](const region_entry& entry) {
+        return name == entry.name;
+    });
+    if (duplicate) {
+        return std::unexpected(error(errc::layout_mismatch, {EEXIST, std::generic_category()}));
+    }
+
+    region_entry entry{};
+    std::memcpy(entry.name, name.data(), name.size());
+    entry.size = size;
+
+    _entries.push_back(entry);
+    _alignments.push_back(alignment);
+
+    return {};
+}
+
+[[nodiscard]] std::vector<region_entry>
+region_layout::entries() const
+{
+    std::vector<region_entry> placed = _entries;
+
+    std::size_t cursor = table_end(placed.size());
+    for (std::size_t i = 0; i < placed.size(); ++i) {
+        cursor = align_up(cursor, _alignments[i]);
+        placed[i].offset = cursor;
+        cursor += placed[i].size;
+    }
+
+    return placed;
+}
+
+[[nodiscard]] std::size_t
+region_layout::segment_size() const noexcept
+{
+    std::size_t cursor = table_end(_entries.size());
+    for (std::size_t i = 0; i < _entries.size(); ++i) {
+        cursor = align_up(cursor, _alignments[i]) + _entries[i].size;
+    }
+
+    return cursor;
+}
+
+[[nodiscard]] std::expected<region_directory, error>
+region_directory::_create_unpublished(const segment_name& shm_name, const region_layout& layout, const create_options& options) noexcept
+{
+    try {
+        const auto entries = layout.entries();
+
+        auto shm = create_unpublished(shm_name, layout.segment_size() - HEADER_SIZE, LAYOUT, options);
+        if (!shm) {
+            return std::unexpected(shm.error());
+        }
+
+        auto *table = reinterpret_cast<region_table *>(payload(*shm).data());
+        table->count = entries.size();
+        std::memcpy(table + 1, entries.data(), entries.size() * sizeof(region_entry));
+
+        region_directory directory{};
+        directory._shm = std::move(*shm);
+        if (auto indexed = directory._build_index(); !indexed) {
+            return std::unexpected(indexed.error());
+        }
+
+        return directory;
+    } catch (const std::bad_alloc&) {
+        return std::unexpected(error(errc::map_failed, {ENOMEM, std::generic_category()}));
+    }
+}
+
+[[nodiscard]] std::expected<region_directory, error>
+region_directory::open(const segment_name& shm_name, const std::chrono::milliseconds timeout) noexcept
+{
+    auto shm = open_published(shm_name, LAYOUT, timeout);
+    if (!shm) {
+        return std::unexpected(shm.error());
+    }
+
+    region_directory directory{};
+    directory._shm = std::move(*shm);
+    if (auto indexed = directory._build_index(); !indexed) {
+        return std::unexpected(indexed.error());
+    }
+
+    return directory;
+}
+
+[[nodiscard]] std::expected<void, error>
+region_directory::_build_index() noexcept
+{
+    const auto memory = _shm.get_memory();
+    const auto *table = reinterpret_cast<const region_table *>(payload(_shm).data());
+
+    if (memory.size() < table_end(0)) {
+        return std::unexpected(error(errc::layout_mismatch, {EPROTO, std::generic_category()}));
+    }
+
+    /* Every process can write the table, so each field is read once and names are copied out. */
+    const std::size_t count = table->count;
+    if (count > (memory.size() - table_end(0)) / sizeof(region_entry)) {
+        return std::unexpected(error(errc::layout_mismatch, {EPROTO, std::generic_category()}));
+    }
+
+    const auto *entries = reinterpret_cast<const region_entry *>(table + 1);
+
+    try {
+        _index.clear();
+        _index.reserve(count);
+
+        for (std::size_t i = 0; i < count; ++i) {
+            region_entry entry{};
+            std::memcpy(&entry, &entries[i], sizeof(entry));
+            const auto name_length = ::strnlen(entry.name, sizeof(entry.name));
+
+            if (name_length == sizeof(entry.name) || entry.offset > memory.size() || entry.size > memory.size() - entry.offset) {
+                return std::unexpected(error(errc::layout_mismatch, {EPROTO, std::generic_category()}));
+            }
+
+            _index.emplace(std::string(entry.name, name_length), memory.subspan(entry.offset, entry.size));
+        }
+    } catch (const std::bad_alloc&) {
+        return std::unexpected(error(errc::map_failed, {ENOMEM, std::generic_category()}));
+    }
+
+    return {};
+}
+
+} // namespace shared_memory
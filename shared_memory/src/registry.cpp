@@ -0,0 +1,135 @@
+/**************************************************************
+ * @file registry.cpp
+ * @brief Implementation of the process-wide shared memory registry.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#include "shared_memory/registry.hpp"
+
+#include <cerrno>
+#include <new>
+#include <string>
+#include <utility>
+
+namespace shared_memory {
+
+namespace {
+
+/* "foo" and "/foo" name the same segment, so entries are keyed without the optional slash. */
+[[nodiscard]] static std::string_view
+key_of(const segment_name& name) noexcept
+{
+    const auto view = name.view();
+    return view.front() == '/' ? view.substr(1) : view;
+}
+
+}
+
+registry&
+registry::instance() noexcept
+{
+    static registry instance{};
+    return instance;
+}
+
+std::expected<registry::handle, error>
+registry::open(std::string_view shm_name) noexcept
+{
+    auto name = segment_name::make(shm_name);
+    if (!name) {
+        return std::unexpected(name.error());
+    }
+    const auto key = key_of(*name);
+
+    std::scoped_lock lock(_mutex);
+
+    if (auto it = _entries.find(key); it != _entries.end()) {
+        if (auto existing = it->second.lock()) {
+            return existing;
+        }
+    }
+
+    try {
+        auto attached = shared_memory::open(*name);
+        if (!attached) {
+            return std::unexpected(attached.error());
+        }
+
+        auto shared = std::make_shared<shared_memory>(std::move(*attached));
+
+        _sweep_expired();
+        _entries.insert_or_assign(std::string(key), shared);
+
+        return shared;
+    } catch (const std::bad_alloc&) {
+        return std::unexpected(error(errc::map_failed, {ENOMEM, std::generic_category()}));
+    }
+}
+
+void
+registry::evict(std::string_view shm_name) noexcept
+{
+    auto name = segment_name::make(shm_name);
+    if (!name) {
+        return;
+    }
+
+    std::scoped_lock lock(_mutex);
+
+    if (auto it = _entries.find(key_of(*name)); it != _entries.end()) {
+        _entries.erase(it);
+    }
+}
+
+std::size_t
+registry::size() const noexcept
+{
+    std::scoped_lock lock(_mutex);
+
+    std::size_t live{0};
+    for (const auto& [name, entry] : _entries) {
+        if (!entry.expired()) {
+            ++live;
+        }
+    }
+
+    return live;
+}
+
+void
+registry::_sweep_expired() noexcept
+{
+    std::erase_if(_entries, [](const auto& entry) { return entry.second.expired(); });
+}
+
+} // namespace shared_memory
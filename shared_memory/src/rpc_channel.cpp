@@ -0,0 +1,411 @@
+/**************************************************************
+ * @file rpc_channel.cpp
+ * @brief Implementation of the shared-memory request/response channel.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#include "shared_memory/rpc_channel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#include "shared_memory/spin_lock.hpp"
+
+#include "futex.hpp"
+
+namespace shared_memory {
+
+namespace {
+
+using steady_clock = std::chrono::steady_clock;
+
+/* Slot states. Only the owning client leaves FREE, IDLE and RESPONSE; only a server leaves REQUEST and PROCESSING. */
+constexpr std::uint32_t FREE{0};
+constexpr std::uint32_t IDLE{1};
+constexpr std::uint32_t REQUEST{2};
+constexpr std::uint32_t PROCESSING{3};
+constexpr std::uint32_t RESPONSE{4};
+constexpr std::uint32_t ABANDONED{5};
+
+/* Response length reported for a call whose handler threw; slot capacities stay below it. */
+constexpr std::uint32_t FAILED_RESPONSE{UINT32_MAX};
+
+[[nodiscard]] static std::chrono::nanoseconds
+remaining(const steady_clock::time_point deadline, const steady_clock::time_point now) noexcept
+{
+    return deadline == steady_clock::time_point::max() ? std::chrono::nanoseconds(-1) : std::chrono::nanoseconds(deadline - now);
+}
+
+}
+
+/* The doorbell is written by every client, so it sits apart from the read-mostly geometry. */
+struct alignas(CACHE_LINE_SIZE) rpc_channel::channel_header {
+    std::uint64_t magic;
+    std::uint64_t clients;
+    std::uint64_t slot_capacity;
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint32_t> doorbell;
+    std::atomic<std::uint32_t> sleeping_servers;
+};
+
+/* Followed by the request buffer, then the response buffer, each cache-line aligned. */
+struct alignas(CACHE_LINE_SIZE) rpc_channel::slot_header {
+    std::atomic<std::uint32_t> state;
+    std::atomic<std::uint32_t> client_waiting;
+    std::uint32_t request_length;
+    std::uint32_t response_length;
+};
+
+/* One line for the slot header, then the request and response buffers. */
+[[nodiscard]] static std::size_t
+slot_stride(const std::size_t slot_capacity) noexcept
+{
+    return CACHE_LINE_SIZE + 2 * align_up(slot_capacity);
+}
+
+[[nodiscard]] std::size_t
+rpc_channel::required_size(const std::size_t clients, const std::size_t slot_capacity) noexcept
+{
+    static_assert(sizeof(slot_header) == CACHE_LINE_SIZE, "slot_header must fill exactly the line slot_stride() reserves");
+    if (slot_capacity > (SIZE_MAX - CACHE_LINE_SIZE) / 2 - CACHE_LINE_SIZE) {
+        return SIZE_MAX;
+    }
+
+    /* No region can be SIZE_MAX bytes, so it doubles as the overflow marker. */
+    std::size_t size = 0;
+    if (__builtin_mul_overflow(clients, slot_stride(slot_capacity), &size) || __builtin_add_overflow(size, align_up(sizeof(channel_header)), &size)) {
+        return SIZE_MAX;
+    }
+    return size;
+}
+
+rpc_channel::rpc_channel(std::span<std::byte> region, channel_header *header) noexcept
+: _header(header)
+, _slots(region.data() + align_up(sizeof(channel_header)))
+{}
+
+[[nodiscard]] std::expected<rpc_channel, error>
+rpc_channel::create(std::span<std::byte> region, const std::size_t clients, const std::size_t slot_capacity) noexcept
+{
+    const auto size = required_size(clients, slot_capacity);
+    if (reinterpret_cast<std::uintptr_t>(region.data()) % CACHE_LINE_SIZE != 0 || clients == 0 || slot_capacity == 0 || slot_capacity >= FAILED_RESPONSE || size == SIZE_MAX) {
+        return std::unexpected(error(errc::layout_mismatch, {EINVAL, std::generic_category()}));
+    }
+
+    if (region.size() < size) {
+        return std::unexpected(error(errc::layout_mismatch, {ENOSPC, std::generic_category()}));
+    }
+
+    std::memset(region.data(), 0, size);
+
+    auto *header = ::new (static_cast<void *>(region.data())) channel_header{};
+    header->clients = clients;
+    header->slot_capacity = slot_capacity;
+
+    rpc_channel channel(region, header);
+    for (std::size_t i = 0; i < clients; ++i) {
+        ::new (static_cast<void *>(channel._slot(i))) slot_header{};
+    }
+
+    std::atomic_ref(header->magic).store(MAGIC, std::memory_order_release);
+    return channel;
+}
+
+[[nodiscard]] std::expected<rpc_channel, error>
+rpc_channel::attach(std::span<std::byte> region) noexcept
+{
+    if (region.size() < sizeof(channel_header) || reinterpret_cast<std::uintptr_t>(region.data()) % CACHE_LINE_SIZE != 0) {
+        return std::unexpected(error(errc::layout_mismatch, {EPROTO, std::generic_category()}));
+    }
+
+    /* An overflowing layout saturates required_size() to SIZE_MAX, which no region reaches. */
+    auto *header = std::launder(reinterpret_cast<channel_header *>(region.data()));
+    if (std::atomic_ref(header->magic).load(std::memory_order_acquire) != MAGIC
+        || header->clients == 0
+        || header->slot_capacity == 0
+        || header->slot_capacity >= FAILED_RESPONSE
+        || region.size() < required_size(header->clients, header->slot_capacity)) {
+        return std::unexpected(error(errc::layout_mismatch, {EPROTO, std::generic_category()}));
+    }
+
+    return rpc_channel(region, header);
+}
+
+[[nodiscard]] std::expected<rpc_client, error>
+rpc_channel::connect() noexcept
+{
+    for (std::size_t i = 0; i < _header->clients; ++i) {
+        auto expected = FREE;
+        if (_slot(i)->state.compare_exchange_strong(expected, IDLE, std::memory_order_acquire, std::memory_order_relaxed)) {
+            return rpc_client(*this, i);
+        }
+    }
+
+    return std::unexpected(error(errc::allocate_failed, {ENOSPC, std::generic_category()}));
+}
+
+[[nodiscard]] bool
+rpc_channel::wait_for_requests(const std::chrono::nanoseconds timeout) noexcept
+{
+    /* Pairs with the client's request store: announce sleeping, then re-check the slots. */
+    _header->sleeping_servers.fetch_add(1, std::memory_order_seq_cst);
+    const auto ring = _header->doorbell.load(std::memory_order_seq_cst);
+    if (!_has_request()) {
+        futex_wait(_header->doorbell, ring, timeout);
+    }
+    _header->sleeping_servers.fetch_sub(1, std::memory_order_relaxed);
+
+    return _has_request();
+}
+
+[[nodiscard]] std::size_t
+rpc_channel::clients() const noexcept
+{
+    return _header->clients;
+}
+
+[[nodiscard]] std::size_t
+rpc_channel::slot_capacity() const noexcept
+{
+    return _header->slot_capacity;
+}
+
+[[nodiscard]] rpc_channel::slot_header *
+rpc_channel::_slot(const std::size_t index) const noexcept
+{
+    return std::launder(reinterpret_cast<slot_header *>(_slots + index * slot_stride(_header->slot_capacity)));
+}
+
+[[nodiscard]] std::size_t
+rpc_channel::_claim(const std::size_t from) noexcept
+{
+    for (auto i = from; i < _header->clients; ++i) {
+        auto *slot = _slot(i);
+        auto expected = REQUEST;
+        if (slot->state.load(std::memory_order_relaxed) == REQUEST
+            && slot->state.compare_exchange_strong(expected, PROCESSING, std::memory_order_acquire, std::memory_order_relaxed)) {
+            return i;
+        }
+    }
+    return NONE;
+}
+
+[[nodiscard]] std::span<const std::byte>
+rpc_channel::_request(const std::size_t index) const noexcept
+{
+    /* Clients write the length, so it must not reach past the request buffer. */
+    auto *data = reinterpret_cast<std::byte *>(_slot(index)) + CACHE_LINE_SIZE;
+    return {data, std::min<std::size_t>(_slot(index)->request_length, _header->slot_capacity)};
+}
+
+[[nodiscard]] std::span<std::byte>
+rpc_channel::_response(const std::size_t index) const noexcept
+{
+    auto *data = reinterpret_cast<std::byte *>(_slot(index)) + CACHE_LINE_SIZE + align_up(_header->slot_capacity);
+    return {data, _header->slot_capacity};
+}
+
+void
+rpc_channel::_complete(const std::size_t index, const std::size_t length) noexcept
+{
+    _finish(index, static_cast<std::uint32_t>(std::min<std::size_t>(length, _header->slot_capacity)));
+}
+
+void
+rpc_channel::_fail(const std::size_t index) noexcept
+{
+    _finish(index, FAILED_RESPONSE);
+}
+
+void
+rpc_channel::_finish(const std::size_t index, const std::uint32_t response_length) noexcept
+{
+    auto *slot = _slot(index);
+    slot->response_length = response_length;
+
+    /* A client that left mid-call marked the slot ABANDONED; hand it back to the free pool. */
+    auto expected = PROCESSING;
+    if (!slot->state.compare_exchange_strong(expected, RESPONSE, std::memory_order_seq_cst)) {
+        slot->state.store(FREE, std::memory_order_release);
+        return;
+    }
+
+    /* Sequentially consistent with the client's waiting flag, so one side always sees the other. */
+    if (slot->client_waiting.load(std::memory_order_seq_cst) != 0) {
+        futex_wake(slot->state, 1);
+    }
+}
+
+[[nodiscard]] bool
+rpc_channel::_has_request() const noexcept
+{
+    for (std::size_t i = 0; i < _header->clients; ++i) {
+        if (_slot(i)->state.load(std::memory_order_seq_cst) == REQUEST) {
+            return true;
+        }
+    }
+    return false;
+}
+
+rpc_client::rpc_client(const rpc_channel& channel, const std::size_t index) noexcept
+: _channel(channel)
+, _index(index)
+{}
+
+rpc_client::rpc_client(rpc_client&& other) noexcept
+: _channel(std::exchange(other._channel, rpc_channel{}))
+, _index(std::exchange(other._index, rpc_channel::NONE))
+, _in_flight(std::exchange(other._in_flight, false))
+{}
+
+rpc_client&
+rpc_client::operator=(rpc_client&& other) noexcept
+{
+    if (this != &other) {
+        _release();
+        _channel = std::exchange(other._channel, rpc_channel{});
+        _index = std::exchange(other._index, rpc_channel::NONE);
+        _in_flight = std::exchange(other._in_flight, false);
+    }
+    return *this;
+}
+
+[[nodiscard]] std::expected<std::size_t, error>
+rpc_client::call(std::span<const std::byte> request, std::span<std::byte> response, const std::chrono::nanoseconds timeout) noexcept
+{
+    auto *slot = _channel._slot(_index);
+    if (request.size() > _channel._header->slot_capacity) {
+        return std::unexpected(error(errc::allocate_failed, {EMSGSIZE, std::generic_category()}));
+    }
+
+    const auto deadline = timeout.count() >= 0 ? steady_clock::now() + timeout : steady_clock::time_point::max();
+
+    /* A call that timed out earlier still owns the slot until its response arrives. */
+    if (_in_flight) {
+        if (auto drained = _await_response(deadline); !drained) {
+            return std::unexpected(drained.error());
+        }
+        slot->state.store(IDLE, std::memory_order_relaxed);
+        _in_flight = false;
+    }
+
+    std::ranges::copy(request, reinterpret_cast<std::byte *>(slot) + CACHE_LINE_SIZE);
+    slot->request_length = static_cast<std::uint32_t>(request.size());
+
+    /* Pairs with wait_for_requests(): publish the request, then check for a sleeping server. */
+    slot->state.store(REQUEST, std::memory_order_seq_cst);
+    _in_flight = true;
+    if (_channel._header->sleeping_servers.load(std::memory_order_seq_cst) != 0) {
+        _channel._header->doorbell.fetch_add(1, std::memory_order_seq_cst);
+        futex_wake(_channel._header->doorbell, 1);
+    }
+
+    if (auto answered = _await_response(deadline); !answered) {
+        return std::unexpected(answered.error());
+    }
+    _in_flight = false;
+
+    if (slot->response_length == FAILED_RESPONSE) {
+        slot->state.store(IDLE, std::memory_order_relaxed);
+        return std::unexpected(error(errc::read_failed, {EREMOTEIO, std::generic_category()}));
+    }
+
+    const auto length = static_cast<std::size_t>(slot->response_length);
+    const auto fits = length <= response.size();
+    if (fits) {
+        std::memcpy(response.data(), _channel._response(_index).data(), length);
+    }
+    slot->state.store(IDLE, std::memory_order_relaxed);
+
+    if (!fits) {
+        return std::unexpected(error(errc::read_failed, {EMSGSIZE, std::generic_category()}));
+    }
+    return length;
+}
+
+[[nodiscard]] std::expected<void, error>
+rpc_client::_await_response(const steady_clock::time_point deadline) noexcept
+{
+    auto *slot = _channel._slot(_index);
+
+    for (unsigned spins = 0; spins < SPINS_BEFORE_WAIT; ++spins) {
+        if (slot->state.load(std::memory_order_acquire) == RESPONSE) {
+            return {};
+        }
+        spin_lock::cpu_relax();
+    }
+
+    for (;;) {
+        slot->client_waiting.store(1, std::memory_order_seq_cst);
+        const auto state = slot->state.load(std::memory_order_seq_cst);
+        if (state == RESPONSE) {
+            slot->client_waiting.store(0, std::memory_order_relaxed);
+            return {};
+        }
+
+        const auto now = steady_clock::now();
+        if (now >= deadline) {
+            slot->client_waiting.store(0, std::memory_order_relaxed);
+            return std::unexpected(error(errc::wait_failed, {ETIMEDOUT, std::generic_category()}));
+        }
+
+        if (futex_wait(slot->state, state, remaining(deadline, now)) == -1 && errno != EAGAIN && errno != EINTR && errno != ETIMEDOUT) {
+            slot->client_waiting.store(0, std::memory_order_relaxed);
+            return std::unexpected(error(errc::wait_failed, {errno, std::generic_category()}));
+        }
+    }
+}
+
+void
+rpc_client::_release() noexcept
+{
+    if (_index == rpc_channel::NONE) {
+        return;
+    }
+
+    /* Hand the slot back directly unless a server is mid-call; then the server frees it in _complete(). */
+    auto *slot = _channel._slot(_index);
+    for (auto state = slot->state.load(std::memory_order_acquire);;) {
+        const auto next = state == PROCESSING ? ABANDONED : FREE;
+        if (slot->state.compare_exchange_weak(state, next, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            break;
+        }
+    }
+    _index = rpc_channel::NONE;
+}
+
+} // namespace shared_memory
@@ -0,0 +1,155 @@
+/**************************************************************
+ * @file segment_header.cpp
+ * @brief Implementation of the segment header ready handshake.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#include "shared_memory/segment_header.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <thread>
+
+#include <unistd.h>
+
+#include "futex.hpp"
+
+namespace shared_memory {
+
+namespace {
+
+using steady_clock = std::chrono::steady_clock;
+
+/* A segment that exists by name but is not yet truncated maps as EINVAL. */
+[[nodiscard]] static bool
+is_not_created_yet(const error& err) noexcept
+{
+    return (err.kind() == errc::open_failed && err.code().value() == ENOENT)
+        || (err.kind() == errc::map_failed && err.code().value() == EINVAL);
+}
+
+[[nodiscard]] static std::expected<void, error>
+wait_until_ready(const segment_header& header, const steady_clock::time_point deadline) noexcept
+{
+    while (true) {
+        const auto state = header.state.load(std::memory_order_acquire);
+        if (state == std::to_underlying(segment_state::READY)) {
+            return {};
+        }
+
+        const auto now = steady_clock::now();
+        if (now >= deadline) {
+            return std::unexpected(error(errc::wait_failed, {ETIMEDOUT, std::generic_category()}));
+        }
+
+        if (futex_wait(header.state, state, deadline - now) == -1 && errno != EAGAIN && errno != EINTR && errno != ETIMEDOUT) {
+            return std::unexpected(error(errc::wait_failed, {errno, std::generic_category()}));
+        }
+    }
+}
+
+}
+
+[[nodiscard]] std::expected<shared_memory, error>
+create_unpublished(const segment_name& shm_name, const std::size_t payload_size, const std::uint64_t layout, const create_options& options) noexcept
+{
+    const std::size_t size = HEADER_SIZE + payload_size;
+
+    auto shm = shared_memory::create(shm_name, size, options);
+    if (!shm) {
+        return shm;
+    }
+
+    auto *header = new (shm->get_memory().data()) segment_header{};
+    header->magic = segment_header::MAGIC;
+    header->layout = layout;
+    header->size = size;
+    header->creator_pid = static_cast<std::int32_t>(getpid());
+    header->format = segment_header::FORMAT;
+    header->state.store(std::to_underlying(segment_state::INITIALIZING), std::memory_order_release);
+
+    return shm;
+}
+
+void
+publish(shared_memory& shm) noexcept
+{
+    auto& header = header_of(shm);
+    header.state.store(std::to_underlying(segment_state::READY), std::memory_order_release);
+    futex_wake(header.state);
+}
+
+[[nodiscard]] std::expected<shared_memory, error>
+open_published(const segment_name& shm_name, const std::uint64_t layout, const std::chrono::milliseconds timeout) noexcept
+{
+    const auto deadline = steady_clock::now() + timeout;
+    auto backoff = std::chrono::microseconds(50);
+
+    while (true) {
+        auto shm = shared_memory::open(shm_name);
+        if (!shm) {
+            if (!is_not_created_yet(shm.error())) {
+                return shm;
+            }
+
+            if (steady_clock::now() >= deadline) {
+                return std::unexpected(error(errc::wait_failed, {ETIMEDOUT, std::generic_category()}));
+            }
+
+            /* The segment has no futex word yet, so back off until it appears. */
+            std::this_thread::sleep_for(backoff);
+            backoff = std::min(backoff * 2, std::chrono::microseconds(10'000));
+            continue;
+        }
+
+        if (shm->size() < HEADER_SIZE) {
+            return std::unexpected(error(errc::layout_mismatch, {EPROTO, std::generic_category()}));
+        }
+
+        const auto& header = header_of(*shm);
+        if (auto ready = wait_until_ready(header, deadline); !ready) {
+            return std::unexpected(ready.error());
+        }
+
+        if (header.magic != segment_header::MAGIC
+            || header.format != segment_header::FORMAT
+            || header.layout != layout
+            || header.size != shm->size()) {
+            return std::unexpected(error(errc::layout_mismatch, {EPROTO, std::generic_category()}));
+        }
+
+        return shm;
+    }
+}
+
+} // namespace shared_memory
@@ -0,0 +1,60 @@
+/**************************************************************
+ * @file segment_name.cpp
+ * @brief Implementation of segment_name::make.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#include "shared_memory/segment_name.hpp"
+
+#include <cerrno>
+
+namespace shared_memory {
+
+[[nodiscard]] std::expected<segment_name, error>
+segment_name::make(std::string_view name) noexcept
+{
+    if (name.size() > CAPACITY) {
+        return std::unexpected(error(errc::open_failed, {ENAMETOOLONG, std::generic_category()}));
+    }
+
+    if (!is_valid(name)) {
+        return std::unexpected(error(errc::open_failed, {EINVAL, std::generic_category()}));
+    }
+
+    segment_name result{};
+    result._assign(name);
+
+    return result;
+}
+
+} // namespace shared_memory
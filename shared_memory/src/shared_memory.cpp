@@ -37,10 +37,20 @@
 
 #include "shared_memory/shared_memory.hpp"
 
-#include <sys/mman.h>
+#include <array>
+#include <climits>
+#include <cstdio>
+#include <string_view>
 #include <utility>
 
-#include "owned_fd.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "shared_memory/owned_fd.hpp"
+#include "page_size.hpp"
+#include "reaper.hpp"
 
 namespace shared_memory {
 
@@ -57,12 +67,43 @@ to_prot(const access_mode mode) noexcept
     return PROT_READ | PROT_WRITE;
 }
 
+/* Faults in every page of a fresh mapping. Returns -1 with errno set on failure. */
+static int
+populate(void *addr, const std::size_t size, const int prot) noexcept
+{
+    if (size == 0) {
+        return 0;
+    }
+
+    if (madvise(addr, size, (prot & PROT_WRITE) ? MADV_POPULATE_WRITE : MADV_POPULATE_READ) == 0) {
+        return 0;
+    }
+
+    if (errno != EINVAL) {
+        return -1;
+    }
+
+    /* Kernels before 5.14 lack MADV_POPULATE_*; a read fault allocates tmpfs pages as well. */
+    const auto *bytes = static_cast<const volatile std::byte *>(addr);
+    for (std::size_t offset = 0; offset < size; offset += page_size()) {
+        (void)bytes[offset];
+    }
+
+    return 0;
+}
+
+}
+
+[[nodiscard]] std::expected<shared_memory, error>
+shared_memory::create(const segment_name& shm_name, const std::size_t size, access_mode mode, const bool should_unlink) noexcept
+{
+    return create(shm_name, size, create_options{.mode = mode, .should_unlink = should_unlink});
 }
 
 [[nodiscard]] std::expected<shared_memory, error>
-shared_memory::create(std::string shm_name, const std::size_t size, access_mode mode, const bool should_unlink) noexcept 
+shared_memory::create(const segment_name& shm_name, const std::size_t size, const create_options& options) noexcept
 {
-    auto shm_fd = owned_fd(shm_open(shm_name.c_str(), O_RDWR | O_CREAT | O_EXCL, std::to_underlying(mode)));
+    auto shm_fd = owned_fd(shm_open(shm_name.c_str(), O_RDWR | O_CREAT | O_EXCL, std::to_underlying(options.mode)));
     if (!shm_fd.is_valid()) {
         return std::unexpected(error(errc::open_failed, {errno, std::generic_category()}));
     }
@@ -73,18 +114,47 @@ shared_memory::create(std::string shm_name, const std::size_t size, access_mode
         return std::unexpected(err);
     }
 
-    void *addr = mmap(nullptr, size, to_prot(mode), MAP_SHARED, shm_fd.get(), 0);
+    if (options.preallocate && size != 0 && fallocate(shm_fd.get(), 0, 0, static_cast<off_t>(size)) == -1) {
+        auto err = error(errc::allocate_failed, {errno, std::generic_category()});
+        shm_unlink(shm_name.c_str());
+        return std::unexpected(err);
+    }
+
+    const int prot = to_prot(options.mode);
+    void *addr = mmap(nullptr, size, prot, MAP_SHARED, shm_fd.get(), 0);
     if (addr == MAP_FAILED) {
         auto err = error(errc::map_failed, {errno, std::generic_category()});
         shm_unlink(shm_name.c_str());
         return std::unexpected(err);
     }
 
-    return shared_memory(std::move(shm_name), {static_cast<std::byte *>(addr), size}, should_unlink);
+    if (options.prefault && populate(addr, size, prot) == -1) {
+        auto err = error(errc::populate_failed, {errno, std::generic_category()});
+        munmap(addr, size);
+        shm_unlink(shm_name.c_str());
+        return std::unexpected(err);
+    }
+
+    auto result = shared_memory({static_cast<std::byte *>(addr), size}, true);
+    result._should_unlink = options.should_unlink;
+    result._deferred_unmap = options.deferred_unmap;
+    if (options.retain_fd) {
+        result._fd = std::move(shm_fd);
+    } else if (options.should_unlink) {
+        result._unlink_fd = std::move(shm_fd);
+    }
+
+    return result;
 }
 
 [[nodiscard]] std::expected<shared_memory, error>
-shared_memory::open(std::string shm_name) noexcept 
+shared_memory::open(const segment_name& shm_name) noexcept
+{
+    return open(shm_name, open_options{});
+}
+
+[[nodiscard]] std::expected<shared_memory, error>
+shared_memory::open(const segment_name& shm_name, const open_options& options) noexcept
 {
     auto shm_fd = owned_fd(shm_open(shm_name.c_str(), O_RDWR, S_IRUSR | S_IWUSR));
     if (!shm_fd.is_valid()) {
@@ -102,7 +172,265 @@ shared_memory::open(std::string shm_name) noexcept
         return std::unexpected(error(errc::map_failed, {errno, std::generic_category()}));
     }
 
-    return shared_memory(std::move(shm_name), {static_cast<std::byte *>(addr), size}, false);
+    auto result = shared_memory({static_cast<std::byte *>(addr), size}, true);
+    if (options.retain_fd) {
+        result._fd = std::move(shm_fd);
+    }
+
+    return result;
+}
+
+[[nodiscard]] std::expected<shared_memory, error>
+shared_memory::adopt(owned_fd shm_fd) noexcept
+{
+    if (!shm_fd.is_valid()) {
+        return std::unexpected(error(errc::open_failed, {EBADF, std::generic_category()}));
+    }
+
+    struct stat st{};
+    if (fstat(shm_fd.get(), &st) == -1) {
+        return std::unexpected(error(errc::stat_failed, {errno, std::generic_category()}));
+    }
+
+    auto size = static_cast<std::size_t>(st.st_size);
+    void *addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd.get(), 0);
+    if (addr == MAP_FAILED) {
+        return std::unexpected(error(errc::map_failed, {errno, std::generic_category()}));
+    }
+
+    auto result = shared_memory({static_cast<std::byte *>(addr), size}, false);
+    result._fd = std::move(shm_fd);
+
+    return result;
+}
+
+[[nodiscard]] std::expected<shared_memory, error>
+shared_memory::map_file(const std::filesystem::path& path, const std::size_t size, const file_options& options) noexcept
+{
+    /* A shared writable mapping needs a descriptor that can also read. */
+    const int access = options.mode == access_mode::READ ? O_RDONLY : O_RDWR;
+    auto file = owned_fd(::open(path.c_str(), access | O_CLOEXEC | (options.create ? O_CREAT : 0), std::to_underlying(options.mode)));
+    if (!file.is_valid()) {
+        return std::unexpected(error(errc::open_failed, {errno, std::generic_category()}));
+    }
+
+    struct stat st{};
+    if (fstat(file.get(), &st) == -1) {
+        return std::unexpected(error(errc::stat_failed, {errno, std::generic_category()}));
+    }
+
+    const auto length = size != 0 ? size : static_cast<std::size_t>(st.st_size);
+    if (static_cast<std::size_t>(st.st_size) < length && ftruncate(file.get(), static_cast<off_t>(length)) == -1) {
+        return std::unexpected(error(errc::truncate_failed, {errno, std::generic_category()}));
+    }
+
+    if (options.preallocate && length != 0 && fallocate(file.get(), 0, 0, static_cast<off_t>(length)) == -1) {
+        return std::unexpected(error(errc::allocate_failed, {errno, std::generic_category()}));
+    }
+
+    const int prot = to_prot(options.mode);
+    void *addr = mmap(nullptr, length, prot, MAP_SHARED, file.get(), 0);
+    if (addr == MAP_FAILED) {
+        return std::unexpected(error(errc::map_failed, {errno, std::generic_category()}));
+    }
+
+    if (options.prefault && populate(addr, length, prot) == -1) {
+        auto err = error(errc::populate_failed, {errno, std::generic_category()});
+        munmap(addr, length);
+        return std::unexpected(err);
+    }
+
+    auto result = shared_memory({static_cast<std::byte *>(addr), length}, false);
+    result._deferred_unmap = options.deferred_unmap;
+    if (options.retain_fd) {
+        result._fd = std::move(file);
+    }
+
+    return result;
+}
+
+[[nodiscard]] std::expected<shared_memory, error>
+shared_memory::open_range(const segment_name& shm_name, const std::size_t offset, const std::size_t length) noexcept
+{
+    auto shm_fd = owned_fd(shm_open(shm_name.c_str(), O_RDWR, S_IRUSR | S_IWUSR));
+    if (!shm_fd.is_valid()) {
+        return std::unexpected(error(errc::open_failed, {errno, std::generic_category()}));
+    }
+
+    struct stat st{};
+    if (fstat(shm_fd.get(), &st) == -1) {
+        return std::unexpected(error(errc::stat_failed, {errno, std::generic_category()}));
+    }
+
+    const auto size = static_cast<std::size_t>(st.st_size);
+    if (length == 0 || offset > size || length > size - offset) {
+        return std::unexpected(error(errc::map_failed, {EINVAL, std::generic_category()}));
+    }
+
+    const std::size_t map_offset = offset % page_size();
+    const std::size_t map_length = length + map_offset;
+    void *addr = mmap(nullptr, map_length, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd.get(), static_cast<off_t>(offset - map_offset));
+    if (addr == MAP_FAILED) {
+        return std::unexpected(error(errc::map_failed, {errno, std::generic_category()}));
+    }
+
+    return shared_memory({static_cast<std::byte *>(addr) + map_offset, length}, true, map_offset);
+}
+
+[[nodiscard]] std::expected<shared_memory, error>
+shared_memory::create(std::string_view shm_name, const std::size_t size, access_mode mode, const bool should_unlink) noexcept
+{
+    auto name = segment_name::make(shm_name);
+    if (!name) {
+        return std::unexpected(name.error());
+    }
+
+    return create(*name, size, mode, should_unlink);
+}
+
+[[nodiscard]] std::expected<shared_memory, error>
+shared_memory::open(std::string_view shm_name) noexcept
+{
+    auto name = segment_name::make(shm_name);
+    if (!name) {
+        return std::unexpected(name.error());
+    }
+
+    return open(*name);
+}
+
+[[nodiscard]] std::expected<shared_memory, error>
+shared_memory::open_range(std::string_view shm_name, const std::size_t offset, const std::size_t length) noexcept
+{
+    auto name = segment_name::make(shm_name);
+    if (!name) {
+        return std::unexpected(name.error());
+    }
+
+    return open_range(*name, offset, length);
+}
+
+[[nodiscard]] std::expected<struct stat, error>
+shared_memory::stat() const noexcept
+{
+    struct stat st{};
+    if (fstat(_fd.get(), &st) == -1) {
+        return std::unexpected(error(errc::stat_failed, {errno, std::generic_category()}));
+    }
+
+    return st;
+}
+
+[[nodiscard]] std::expected<owned_fd, error>
+shared_memory::duplicate_fd() const noexcept
+{
+    auto copy = owned_fd(fcntl(_fd.get(), F_DUPFD_CLOEXEC, 0));
+    if (!copy.is_valid()) {
+        return std::unexpected(error(errc::open_failed, {errno, std::generic_category()}));
+    }
+
+    return copy;
+}
+
+[[nodiscard]] std::expected<void, error>
+shared_memory::resize(const std::size_t new_size) noexcept
+{
+    if (!_fd.is_valid()) {
+        return std::unexpected(error(errc::truncate_failed, {EBADF, std::generic_category()}));
+    }
+
+    if (new_size == 0 || _map_offset != 0) {
+        return std::unexpected(error(errc::truncate_failed, {EINVAL, std::generic_category()}));
+    }
+
+    if (ftruncate(_fd.get(), static_cast<off_t>(new_size)) == -1) {
+        return std::unexpected(error(errc::truncate_failed, {errno, std::generic_category()}));
+    }
+
+    void *addr = _mem_view.empty()
+        ? mmap(nullptr, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd.get(), 0)
+        : mremap(_mem_view.data(), _mem_view.size(), new_size, MREMAP_MAYMOVE);
+    if (addr == MAP_FAILED) {
+        return std::unexpected(error(errc::map_failed, {errno, std::generic_category()}));
+    }
+
+    _mem_view = {static_cast<std::byte *>(addr), new_size};
+
+    return {};
+}
+
+[[nodiscard]] std::expected<void, error>
+shared_memory::allocate(const std::size_t offset, const std::size_t length) noexcept
+{
+    /* fallocate() would silently grow the object past the mapping. */
+    if (length == 0 || _map_offset != 0 || offset > _mem_view.size() || length > _mem_view.size() - offset) {
+        return std::unexpected(error(errc::allocate_failed, {EINVAL, std::generic_category()}));
+    }
+
+    if (fallocate(_fd.get(), 0, static_cast<off_t>(offset), static_cast<off_t>(length)) == -1) {
+        return std::unexpected(error(errc::allocate_failed, {errno, std::generic_category()}));
+    }
+
+    return {};
+}
+
+[[nodiscard]] std::expected<shared_memory, error>
+shared_memory::map_private() const noexcept
+{
+    if (!_fd.is_valid()) {
+        return std::unexpected(error(errc::map_failed, {EBADF, std::generic_category()}));
+    }
+
+    auto st = stat();
+    if (!st) {
+        return std::unexpected(st.error());
+    }
+
+    auto size = static_cast<std::size_t>(st->st_size);
+    void *addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, _fd.get(), 0);
+    if (addr == MAP_FAILED) {
+        return std::unexpected(error(errc::map_failed, {errno, std::generic_category()}));
+    }
+
+    return shared_memory({static_cast<std::byte *>(addr), size}, false);
+}
+
+void
+shared_memory::drain_deferred_unmaps() noexcept
+{
+    reaper::instance().drain();
+}
+
+bool
+shared_memory::_defer_unmap(void *addr, const std::size_t length) noexcept
+{
+    return reaper::instance().submit(addr, length);
+}
+
+void
+shared_memory::_unlink() const noexcept
+{
+    const int fd = _fd.is_valid() ? _fd.get() : _unlink_fd.get();
+
+    /* Once the object is unlinked its name may belong to a newer segment, which must survive. */
+    struct stat st{};
+    if (fd == owned_fd::INVALID_FD || fstat(fd, &st) == -1 || st.st_nlink == 0) {
+        return;
+    }
+
+    /* The descriptor links to /dev/shm/<name>; segment names contain no other '/'. */
+    std::array<char, 32> link{};
+    std::snprintf(link.data(), link.size(), "/proc/self/fd/%d", fd);
+    std::array<char, PATH_MAX> target{};
+    const auto length = readlink(link.data(), target.data(), target.size() - 1);
+    if (length <= 0) {
+        return;
+    }
+
+    const std::string_view path(target.data(), static_cast<std::size_t>(length));
+    if (const auto slash = path.rfind('/'); slash != std::string_view::npos) {
+        shm_unlink(target.data() + slash);
+    }
 }
 
 } // namespace shared_memory
@@ -0,0 +1,386 @@
+/**************************************************************
+ * @file timer_wheel.cpp
+ * @brief Implementation of the shared hierarchical timer wheel.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#include "shared_memory/timer_wheel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+#include "shared_memory/spin_lock.hpp"
+
+namespace shared_memory {
+
+namespace {
+
+constexpr std::uint32_t NIL{UINT32_MAX};
+constexpr std::uint32_t DUE_BUCKET{timer_wheel::LEVELS * timer_wheel::SLOTS_PER_LEVEL};
+constexpr std::uint32_t FREE_BUCKET{DUE_BUCKET + 1};
+constexpr std::uint64_t SLOT_MASK{timer_wheel::SLOTS_PER_LEVEL - 1};
+
+[[nodiscard]] constexpr std::uint64_t
+level_span(const std::size_t level) noexcept
+{
+    return std::uint64_t{1} << (timer_wheel::SLOT_BITS * level);
+}
+
+}
+
+/* Everything past the magic is only touched with the lock held. */
+struct alignas(CACHE_LINE_SIZE) timer_wheel::wheel_header {
+    std::uint64_t magic;
+    std::uint64_t capacity;
+    spin_lock lock;
+    std::uint32_t free_head;
+    std::uint32_t due_tail;
+    std::uint64_t now;
+    std::uint64_t active;
+    std::uint64_t in_wheel;
+    std::array<std::uint32_t, DUE_BUCKET + 1> heads;
+};
+
+struct timer_wheel::timer_entry {
+    std::uint64_t deadline;
+    std::uint64_t payload;
+    std::uint32_t next;
+    std::uint32_t prev;
+    std::uint32_t generation;
+    std::uint32_t bucket;
+};
+
+[[nodiscard]] std::size_t
+timer_wheel::required_size(const std::size_t capacity) noexcept
+{
+    return align_up(sizeof(wheel_header)) + capacity * sizeof(timer_entry);
+}
+
+timer_wheel::timer_wheel(std::span<std::byte> region, wheel_header *header) noexcept
+: _header(header)
+, _entries(reinterpret_cast<timer_entry *>(region.data() + align_up(sizeof(wheel_header))))
+{}
+
+[[nodiscard]] std::expected<timer_wheel, error>
+timer_wheel::create(std::span<std::byte> region, const std::size_t capacity, const std::uint64_t now) noexcept
+{
+    if (reinterpret_cast<std::uintptr_t>(region.data()) % CACHE_LINE_SIZE != 0 || capacity == 0 || capacity >= NIL) {
+        return std::unexpected(error(errc::layout_mismatch, {EINVAL, std::generic_category()}));
+    }
+
+    const auto size = required_size(capacity);
+    if (region.size() < size) {
+        return std::unexpected(error(errc::layout_mismatch, {ENOSPC, std::generic_category()}));
+    }
+
+    std::memset(region.data(), 0, size);
+
+    auto *header = ::new (static_cast<void *>(region.data())) wheel_header{};
+    header->capacity = capacity;
+    header->now = now;
+    header->heads.fill(NIL);
+    header->due_tail = NIL;
+    header->free_head = 0;
+
+    timer_wheel wheel(region, header);
+    for (std::uint32_t i = 0; i < capacity; ++i) {
+        wheel._entries[i] = timer_entry{0, 0, i + 1 < capacity ? i + 1 : NIL, NIL, 0, FREE_BUCKET};
+    }
+
+    std::atomic_ref(header->magic).store(MAGIC, std::memory_order_release);
+    return wheel;
+}
+
+[[nodiscard]] std::expected<timer_wheel, error>
+timer_wheel::attach(std::span<std::byte> region) noexcept
+{
+    if (region.size() < sizeof(wheel_header) || reinterpret_cast<std::uintptr_t>(region.data()) % CACHE_LINE_SIZE != 0) {
+        return std::unexpected(error(errc::layout_mismatch, {EPROTO, std::generic_category()}));
+    }
+
+    auto *header = std::launder(reinterpret_cast<wheel_header *>(region.data()));
+    if (std::atomic_ref(header->magic).load(std::memory_order_acquire) != MAGIC
+        || header->capacity == 0
+        || header->capacity >= NIL
+        || region.size() < required_size(header->capacity)) {
+        return std::unexpected(error(errc::layout_mismatch, {EPROTO, std::generic_category()}));
+    }
+
+    return timer_wheel(region, header);
+}
+
+void
+timer_wheel::_link(const std::uint32_t index, const std::uint32_t bucket) noexcept
+{
+    auto& entry = _entries[index];
+    entry.bucket = bucket;
+
+    /* The due list is FIFO so collected timers come out in expiry order; wheel slots are unordered. */
+    if (bucket == DUE_BUCKET) {
+        entry.next = NIL;
+        entry.prev = _header->due_tail;
+        if (_header->due_tail == NIL) {
+            _header->heads[DUE_BUCKET] = index;
+        } else {
+            _entries[_header->due_tail].next = index;
+        }
+        _header->due_tail = index;
+        return;
+    }
+
+    entry.prev = NIL;
+    entry.next = _header->heads[bucket];
+    if (entry.next != NIL) {
+        _entries[entry.next].prev = index;
+    }
+    _header->heads[bucket] = index;
+    ++_header->in_wheel;
+}
+
+void
+timer_wheel::_unlink(const std::uint32_t index) noexcept
+{
+    auto& entry = _entries[index];
+    if (entry.prev == NIL) {
+        _header->heads[entry.bucket] = entry.next;
+    } else {
+        _entries[entry.prev].next = entry.next;
+    }
+
+    if (entry.next != NIL) {
+        _entries[entry.next].prev = entry.prev;
+    } else if (entry.bucket == DUE_BUCKET) {
+        _header->due_tail = entry.prev;
+    }
+
+    if (entry.bucket != DUE_BUCKET) {
+        --_header->in_wheel;
+    }
+    entry.next = entry.prev = NIL;
+}
+
+void
+timer_wheel::_place(const std::uint32_t index) noexcept
+{
+    const auto now = _header->now;
+    const auto deadline = _entries[index].deadline;
+    if (deadline <= now) {
+        _link(index, DUE_BUCKET);
+        return;
+    }
+
+    /* Deadlines past the wheel range park in the last level and are re-placed when that slot cascades. */
+    const auto effective = std::min(deadline, now + (RANGE - 1));
+    const auto delta = effective - now;
+
+    std::size_t level = 0;
+    while (level + 1 < LEVELS && delta >= level_span(level + 1)) {
+        ++level;
+    }
+
+    const auto slot = (effective >> (SLOT_BITS * level)) & SLOT_MASK;
+    _link(index, static_cast<std::uint32_t>(level * SLOTS_PER_LEVEL + slot));
+}
+
+void
+timer_wheel::_release(const std::uint32_t index) noexcept
+{
+    auto& entry = _entries[index];
+    ++entry.generation;
+    entry.bucket = FREE_BUCKET;
+    entry.prev = NIL;
+    entry.next = _header->free_head;
+    _header->free_head = index;
+    --_header->active;
+}
+
+void
+timer_wheel::_tick() noexcept
+{
+    const auto now = ++_header->now;
+
+    /* Cascade from the highest level whose slot boundary was crossed, so entries settle in one pass. */
+    for (std::size_t level = LEVELS - 1; level > 0; --level) {
+        if ((now & (level_span(level) - 1)) != 0) {
+            continue;
+        }
+
+        const auto bucket = level * SLOTS_PER_LEVEL + ((now >> (SLOT_BITS * level)) & SLOT_MASK);
+        auto index = _header->heads[bucket];
+        while (index != NIL) {
+            const auto next = _entries[index].next;
+            _unlink(index);
+            _place(index);
+            index = next;
+        }
+    }
+
+    auto index = _header->heads[now & SLOT_MASK];
+    while (index != NIL) {
+        const auto next = _entries[index].next;
+        _unlink(index);
+        _link(index, DUE_BUCKET);
+        index = next;
+    }
+}
+
+/* Whether _tick() reaching @p tick would expire or cascade anything. */
+[[nodiscard]] bool
+timer_wheel::_moves_entries_at(const std::uint64_t tick) const noexcept
+{
+    if (_header->heads[tick & SLOT_MASK] != NIL) {
+        return true;
+    }
+    for (std::size_t level = 1; level < LEVELS && (tick & (level_span(level) - 1)) == 0; ++level) {
+        if (_header->heads[level * SLOTS_PER_LEVEL + ((tick >> (SLOT_BITS * level)) & SLOT_MASK)] != NIL) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Returns the first tick in (now, limit] at which entries move, or limit. Levels
+ * below the lowest occupied one stay empty until then, so only multiples of
+ * that level's span can matter; one rotation of it always reaches an entry.
+ */
+[[nodiscard]] std::uint64_t
+timer_wheel::_next_event(const std::uint64_t limit) const noexcept
+{
+    std::size_t lowest = 0;
+    while (lowest < LEVELS) {
+        const auto *first = _header->heads.data() + lowest * SLOTS_PER_LEVEL;
+        if (std::any_of(first, first + SLOTS_PER_LEVEL, [](const std::uint32_t head) { return head != NIL; })) {
+            break;
+        }
+        ++lowest;
+    }
+    if (lowest == LEVELS) {
+        return limit;
+    }
+
+    const auto step = level_span(lowest);
+    for (auto tick = (_header->now / step + 1) * step; tick < limit; tick += step) {
+        if (_moves_entries_at(tick)) {
+            return tick;
+        }
+    }
+    return limit;
+}
+
+[[nodiscard]] std::expected<timer_handle, error>
+timer_wheel::schedule(const std::uint64_t deadline, const std::uint64_t payload) noexcept
+{
+    std::scoped_lock lock(_header->lock);
+
+    const auto index = _header->free_head;
+    if (index == NIL) {
+        return std::unexpected(error(errc::allocate_failed, {ENOSPC, std::generic_category()}));
+    }
+
+    auto& entry = _entries[index];
+    _header->free_head = entry.next;
+    ++_header->active;
+
+    entry.deadline = deadline;
+    entry.payload = payload;
+    _place(index);
+
+    return timer_handle{index, entry.generation};
+}
+
+bool
+timer_wheel::cancel(const timer_handle handle) noexcept
+{
+    std::scoped_lock lock(_header->lock);
+
+    if (handle.index >= _header->capacity) {
+        return false;
+    }
+
+    const auto& entry = _entries[handle.index];
+    if (entry.generation != handle.generation || entry.bucket == FREE_BUCKET) {
+        return false;
+    }
+
+    _unlink(handle.index);
+    _release(handle.index);
+    return true;
+}
+
+std::size_t
+timer_wheel::advance(const std::uint64_t now, std::span<expired_timer> out) noexcept
+{
+    std::scoped_lock lock(_header->lock);
+
+    while (_header->now < now) {
+        if (_header->in_wheel == 0) {
+            _header->now = now;
+            break;
+        }
+        _header->now = _next_event(now) - 1;
+        _tick();
+    }
+
+    std::size_t count = 0;
+    while (count < out.size() && _header->heads[DUE_BUCKET] != NIL) {
+        const auto index = _header->heads[DUE_BUCKET];
+        const auto& entry = _entries[index];
+        out[count++] = expired_timer{{index, entry.generation}, entry.deadline, entry.payload};
+
+        _unlink(index);
+        _release(index);
+    }
+
+    return count;
+}
+
+[[nodiscard]] std::uint64_t
+timer_wheel::now() const noexcept
+{
+    std::scoped_lock lock(_header->lock);
+    return _header->now;
+}
+
+[[nodiscard]] std::size_t
+timer_wheel::size() const noexcept
+{
+    std::scoped_lock lock(_header->lock);
+    return _header->active;
+}
+
+} // namespace shared_memory
@@ -0,0 +1,558 @@
+/**************************************************************
+ * @file wal.cpp
+ * @brief Implementation of the shared-memory write-ahead log.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#include "shared_memory/wal.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <new>
+#include <optional>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "shared_memory/owned_fd.hpp"
+
+#include "futex.hpp"
+#include "io_uring.hpp"
+
+namespace shared_memory {
+
+namespace {
+
+using steady_clock = std::chrono::steady_clock;
+
+constexpr std::size_t MIN_CAPACITY{4096};
+
+/* The kernel refuses to register a single fixed buffer larger than 1 GiB. */
+constexpr std::size_t MAX_FIXED_BUFFER{std::size_t{1} << 30};
+
+/* Writes data at file offset base with pwrite, retrying short and interrupted calls. */
+[[nodiscard]] static int
+write_all(const int fd, std::span<const std::byte> data, const std::uint64_t base) noexcept
+{
+    for (std::size_t done = 0; done < data.size();) {
+        const auto written = pwrite(fd, data.data() + done, data.size() - done, static_cast<off_t>(base + done));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno;
+        }
+        done += static_cast<std::size_t>(written);
+    }
+    return 0;
+}
+
+}
+
+/*
+ * reserved is contended by appenders, durable and released are written by
+ * the flusher and read by appenders, and the commit futex is touched on every
+ * commit, so each group has its own cache line. released trails durable while
+ * the flusher zeroes ring bytes that are already on disk.
+ */
+struct alignas(CACHE_LINE_SIZE) write_ahead_log::log_header {
+    std::uint64_t magic;
+    std::uint64_t capacity;
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> reserved;
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> durable;
+    std::atomic<std::uint64_t> released;
+    std::atomic<std::uint32_t> durable_epoch;
+    std::atomic<std::uint32_t> durable_waiters;
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint32_t> commit_epoch;
+    std::atomic<std::uint32_t> flusher_sleeping;
+};
+
+[[nodiscard]] std::size_t
+write_ahead_log::required_size(const std::size_t capacity) noexcept
+{
+    return align_up(sizeof(log_header)) + capacity;
+}
+
+write_ahead_log::write_ahead_log(std::span<std::byte> region, log_header *header) noexcept
+: _header(header)
+, _ring(region.data() + align_up(sizeof(log_header)))
+{}
+
+[[nodiscard]] std::expected<write_ahead_log, error>
+write_ahead_log::create(std::span<std::byte> region, const std::size_t capacity, const std::uint64_t start_lsn) noexcept
+{
+    if (reinterpret_cast<std::uintptr_t>(region.data()) % CACHE_LINE_SIZE != 0
+        || capacity < MIN_CAPACITY
+        || !std::has_single_bit(capacity)
+        || start_lsn % RECORD_ALIGNMENT != 0) {
+        return std::unexpected(error(errc::layout_mismatch, {EINVAL, std::generic_category()}));
+    }
+
+    const auto size = required_size(capacity);
+    if (region.size() < size) {
+        return std::unexpected(error(errc::layout_mismatch, {ENOSPC, std::generic_category()}));
+    }
+
+    /* A zeroed ring is what marks every future record as uncommitted. */
+    std::memset(region.data(), 0, size);
+
+    auto *header = ::new (static_cast<void *>(region.data())) log_header{};
+    header->capacity = capacity;
+    header->reserved.store(start_lsn, std::memory_order_relaxed);
+    header->durable.store(start_lsn, std::memory_order_relaxed);
+    header->released.store(start_lsn, std::memory_order_relaxed);
+
+    std::atomic_ref(header->magic).store(MAGIC, std::memory_order_release);
+    return write_ahead_log(region, header);
+}
+
+[[nodiscard]] std::expected<write_ahead_log, error>
+write_ahead_log::attach(std::span<std::byte> region) noexcept
+{
+    if (region.size() < sizeof(log_header) || reinterpret_cast<std::uintptr_t>(region.data()) % CACHE_LINE_SIZE != 0) {
+        return std::unexpected(error(errc::layout_mismatch, {EPROTO, std::generic_category()}));
+    }
+
+    auto *header = std::launder(reinterpret_cast<log_header *>(region.data()));
+    if (std::atomic_ref(header->magic).load(std::memory_order_acquire) != MAGIC
+        || header->capacity < MIN_CAPACITY
+        || !std::has_single_bit(header->capacity)
+        || region.size() < required_size(header->capacity)) {
+        return std::unexpected(error(errc::layout_mismatch, {EPROTO, std::generic_category()}));
+    }
+
+    return write_ahead_log(region, header);
+}
+
+[[nodiscard]] std::expected<wal_reservation, error>
+write_ahead_log::reserve(const std::size_t length) noexcept
+{
+    const auto capacity = _header->capacity;
+    const auto size = record_size(length);
+
+    /* Half the ring bounds record plus padding, so an empty ring always has room. */
+    if (length > UINT32_MAX || size > capacity / 2) {
+        return std::unexpected(error(errc::allocate_failed, {EMSGSIZE, std::generic_category()}));
+    }
+
+    auto reserved = _header->reserved.load(std::memory_order_relaxed);
+    std::size_t gap = 0;
+    for (;;) {
+        const auto position = reserved & (capacity - 1);
+        gap = capacity - position < size ? capacity - position : 0;
+
+        /* Acquiring released orders our writes after the flusher zeroed the bytes it released. */
+        if (reserved + gap + size - _header->released.load(std::memory_order_acquire) > capacity) {
+            return std::unexpected(error(errc::allocate_failed, {ENOSPC, std::generic_category()}));
+        }
+        if (_header->reserved.compare_exchange_weak(reserved, reserved + gap + size, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    if (gap != 0) {
+        auto *padding = reinterpret_cast<wal_record_header *>(_ring + (reserved & (capacity - 1)));
+        padding->length = static_cast<std::uint32_t>(gap - sizeof(wal_record_header));
+        std::atomic_ref(padding->kind).store(wal_record_header::PADDING, std::memory_order_release);
+    }
+
+    const auto lsn = reserved + gap;
+    auto *record = _ring + (lsn & (capacity - 1));
+    reinterpret_cast<wal_record_header *>(record)->length = static_cast<std::uint32_t>(length);
+    return wal_reservation{lsn, std::span(record + sizeof(wal_record_header), length)};
+}
+
+void
+write_ahead_log::commit(const wal_reservation& reservation) noexcept
+{
+    auto *record = reinterpret_cast<wal_record_header *>(_ring + (reservation.lsn & (_header->capacity - 1)));
+
+    /* Sequentially consistent with the flusher's sleeping flag, so one side always sees the other. */
+    std::atomic_ref(record->kind).store(wal_record_header::RECORD, std::memory_order_seq_cst);
+    if (_header->flusher_sleeping.load(std::memory_order_seq_cst) != 0) {
+        _header->commit_epoch.fetch_add(1, std::memory_order_seq_cst);
+        futex_wake(_header->commit_epoch);
+    }
+}
+
+[[nodiscard]] std::expected<std::uint64_t, error>
+write_ahead_log::append(std::span<const std::byte> payload) noexcept
+{
+    auto reservation = reserve(payload.size());
+    if (!reservation) {
+        return std::unexpected(reservation.error());
+    }
+
+    std::ranges::copy(payload, reservation->payload.begin());
+    commit(*reservation);
+    return reservation->lsn;
+}
+
+[[nodiscard]] std::uint64_t
+write_ahead_log::durable_lsn() const noexcept
+{
+    return _header->durable.load(std::memory_order_acquire);
+}
+
+[[nodiscard]] std::expected<void, error>
+write_ahead_log::wait_durable(const std::uint64_t lsn, const std::chrono::nanoseconds timeout) const noexcept
+{
+    const auto deadline = timeout.count() >= 0 ? steady_clock::now() + timeout : steady_clock::time_point::max();
+
+    for (;;) {
+        const auto epoch = _header->durable_epoch.load(std::memory_order_seq_cst);
+        if (_header->durable.load(std::memory_order_acquire) > lsn) {
+            return {};
+        }
+
+        const auto now = steady_clock::now();
+        if (now >= deadline) {
+            return std::unexpected(error(errc::wait_failed, {ETIMEDOUT, std::generic_category()}));
+        }
+
+        /* The flusher bumps the epoch before reading the waiter count, so a missed wake shows up as EAGAIN. */
+        _header->durable_waiters.fetch_add(1, std::memory_order_seq_cst);
+        const auto remaining = deadline == steady_clock::time_point::max() ? std::chrono::nanoseconds(-1) : std::chrono::nanoseconds(deadline - now);
+        const int result = futex_wait(_header->durable_epoch, epoch, remaining);
+        const int err = errno;
+        _header->durable_waiters.fetch_sub(1, std::memory_order_relaxed);
+
+        if (result == -1 && err != EAGAIN && err != EINTR && err != ETIMEDOUT) {
+            return std::unexpected(error(errc::wait_failed, {err, std::generic_category()}));
+        }
+    }
+}
+
+[[nodiscard]] std::size_t
+write_ahead_log::capacity() const noexcept
+{
+    return _header->capacity;
+}
+
+struct wal_flusher::state {
+    write_ahead_log log;
+    owned_fd file{};
+    std::optional<io_ring> ring{};
+    bool fixed{false};
+    wal_flusher_options options{};
+
+    [[nodiscard]] wal_record_header *
+    record_at(const std::uint64_t lsn) const noexcept
+    {
+        return reinterpret_cast<wal_record_header *>(log._ring + (lsn & (log._header->capacity - 1)));
+    }
+
+    /* Writes the pieces with a linked write chain ending in fdatasync. Returns false if the ring could not do it all. */
+    [[nodiscard]] bool
+    persist_through_ring(std::span<const std::span<const std::byte>> pieces, const std::uint64_t base) noexcept
+    {
+        unsigned queued = 0;
+        auto offset = base;
+        for (const auto& piece : pieces) {
+            auto *sqe = ring->next_sqe();
+            if (sqe == nullptr) {
+                abandon_ring(queued);
+                return false;
+            }
+            sqe->opcode = fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+            sqe->flags = IOSQE_IO_LINK;
+            sqe->fd = file.get();
+            sqe->addr = reinterpret_cast<std::uintptr_t>(piece.data());
+            sqe->len = static_cast<std::uint32_t>(piece.size());
+            sqe->off = offset;
+            sqe->user_data = queued++;
+            offset += piece.size();
+        }
+
+        auto *sync = ring->next_sqe();
+        if (sync == nullptr) {
+            abandon_ring(queued);
+            return false;
+        }
+        sync->opcode = IORING_OP_FSYNC;
+        sync->fd = file.get();
+        sync->fsync_flags = IORING_FSYNC_DATASYNC;
+        sync->user_data = queued++;
+
+        if (ring->submit(queued) != 0) {
+            abandon_ring(queued);
+            return false;
+        }
+
+        /* A short write cancels the rest of the chain; the caller then redoes everything synchronously. */
+        bool complete = true;
+        for (unsigned popped = 0; popped < queued;) {
+            io_uring_cqe completion{};
+            if (!ring->pop(completion)) {
+                if (ring->submit(1) != 0) {
+                    abandon_ring(queued - popped);
+                    return false;
+                }
+                continue;
+            }
+            ++popped;
+
+            const auto index = completion.user_data;
+            const auto expected = index < pieces.size() ? static_cast<std::int32_t>(pieces[index].size()) : 0;
+            complete = complete && completion.res == expected;
+        }
+        return complete;
+    }
+
+    /*
+     * Reaps the @p outstanding completions of a batch the ring failed on, so
+     * none of its writes land after the synchronous fallback and none of its
+     * completions are matched to a later batch, then drops the ring for good.
+     * If the ring cannot even be waited on, closing it cancels what is left.
+     */
+    void
+    abandon_ring(unsigned outstanding) noexcept
+    {
+        while (outstanding > 0) {
+            io_uring_cqe completion{};
+            if (ring->pop(completion)) {
+                --outstanding;
+            } else if (ring->submit(1) != 0) {
+                break;
+            }
+        }
+        ring.reset();
+    }
+
+    /*
+     * Checks whether file bytes [durable, size) are still in the ring, as they
+     * are when a flusher died after writing but before publishing them.
+     * Returns 1 if they match, 0 if not, or a negative errno.
+     */
+    [[nodiscard]] int
+    tail_matches_ring(const std::uint64_t durable, const std::uint64_t size) const noexcept
+    {
+        const auto capacity = log._header->capacity;
+        if (size - durable > capacity || size > log._header->reserved.load(std::memory_order_acquire)) {
+            return 0;
+        }
+
+        std::array<std::byte, 4096> buffer{};
+        for (auto lsn = durable; lsn < size;) {
+            const auto position = lsn & (capacity - 1);
+            const auto length = std::min({static_cast<std::uint64_t>(buffer.size()), size - lsn, capacity - position});
+            const auto got = pread(file.get(), buffer.data(), length, static_cast<off_t>(lsn));
+            if (got < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return -errno;
+            }
+            if (got == 0) {
+                return 0;
+            }
+            if (std::memcmp(buffer.data(), log._ring + position, static_cast<std::size_t>(got)) != 0) {
+                return 0;
+            }
+            lsn += static_cast<std::uint64_t>(got);
+        }
+        return 1;
+    }
+
+    /* Zeroes the ring bytes of [from, to), already durable, so reused space reads as uncommitted, then hands them to reserve(). */
+    void
+    release(const std::uint64_t from, const std::uint64_t to) noexcept
+    {
+        const auto capacity = log._header->capacity;
+        for (auto lsn = from; lsn < to;) {
+            const auto position = lsn & (capacity - 1);
+            const auto length = std::min<std::uint64_t>(to - lsn, capacity - position);
+            std::memset(log._ring + position, 0, length);
+            lsn += length;
+        }
+        log._header->released.store(to, std::memory_order_release);
+    }
+
+    [[nodiscard]] int
+    persist(std::span<const std::span<const std::byte>> pieces, const std::uint64_t base) noexcept
+    {
+        if (ring && persist_through_ring(pieces, base)) {
+            return 0;
+        }
+
+        auto offset = base;
+        for (const auto& piece : pieces) {
+            if (const int err = write_all(file.get(), piece, offset); err != 0) {
+                return err;
+            }
+            offset += piece.size();
+        }
+        return fdatasync(file.get()) == 0 ? 0 : errno;
+    }
+};
+
+wal_flusher::wal_flusher() noexcept = default;
+
+wal_flusher::wal_flusher(std::unique_ptr<state> flusher_state) noexcept
+  : _state(std::move(flusher_state))
+{
+}
+
+wal_flusher::~wal_flusher() = default;
+
+wal_flusher::wal_flusher(wal_flusher&&) noexcept = default;
+
+wal_flusher& wal_flusher::operator=(wal_flusher&&) noexcept = default;
+
+[[nodiscard]] std::expected<wal_flusher, error>
+wal_flusher::open(const write_ahead_log& log, const std::filesystem::path& path, const wal_flusher_options& options) noexcept
+{
+    auto flusher_state = std::unique_ptr<state>(new (std::nothrow) state{log});
+    if (!flusher_state) {
+        return std::unexpected(error(errc::allocate_failed, {ENOMEM, std::generic_category()}));
+    }
+    flusher_state->options = options;
+
+    flusher_state->file = owned_fd(::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644));
+    if (!flusher_state->file.is_valid()) {
+        return std::unexpected(error(errc::open_failed, {errno, std::generic_category()}));
+    }
+
+    struct stat st{};
+    if (fstat(flusher_state->file.get(), &st) == -1) {
+        return std::unexpected(error(errc::stat_failed, {errno, std::generic_category()}));
+    }
+
+    /* The file is the only durable copy: never cut it unless the excess is provably this log's unacknowledged tail. */
+    const auto durable = log.durable_lsn();
+    const auto size = static_cast<std::uint64_t>(st.st_size);
+    if (size < durable) {
+        return std::unexpected(error(errc::layout_mismatch, {EPROTO, std::generic_category()}));
+    }
+    if (size > durable) {
+        const int matches = flusher_state->tail_matches_ring(durable, size);
+        if (matches < 0) {
+            return std::unexpected(error(errc::read_failed, {-matches, std::generic_category()}));
+        }
+        if (matches == 0) {
+            return std::unexpected(error(errc::layout_mismatch, {EEXIST, std::generic_category()}));
+        }
+        if (ftruncate(flusher_state->file.get(), static_cast<off_t>(durable)) == -1) {
+            return std::unexpected(error(errc::truncate_failed, {errno, std::generic_category()}));
+        }
+    }
+
+    /* A previous flusher that died after publishing durable left its bytes unzeroed. */
+    if (const auto released = log._header->released.load(std::memory_order_acquire); released < durable) {
+        flusher_state->release(released, durable);
+    }
+
+    if (options.use_io_uring) {
+        if (auto ring = io_ring::setup(4)) {
+            const auto capacity = log.capacity();
+            const iovec buffer{log._ring, capacity};
+            flusher_state->fixed = capacity <= MAX_FIXED_BUFFER && ring->register_buffers(std::span(&buffer, 1)) == 0;
+            flusher_state->ring = std::move(*ring);
+        }
+    }
+
+    return wal_flusher(std::move(flusher_state));
+}
+
+[[nodiscard]] std::expected<std::uint64_t, error>
+wal_flusher::flush() noexcept
+{
+    auto *header = _state->log._header;
+    const auto capacity = header->capacity;
+    const auto start = header->durable.load(std::memory_order_relaxed);
+    const auto reserved = header->reserved.load(std::memory_order_acquire);
+
+    /* The committed prefix ends at the first record whose kind is still 0. */
+    auto end = start;
+    while (end < reserved && end - start < _state->options.max_batch) {
+        const auto *record = _state->record_at(end);
+        if (std::atomic_ref(record->kind).load(std::memory_order_acquire) == 0) {
+            break;
+        }
+        end += write_ahead_log::record_size(record->length);
+    }
+    if (end == start) {
+        return start;
+    }
+
+    const auto first = start & (capacity - 1);
+    const auto head = std::min<std::size_t>(end - start, capacity - first);
+    const std::array<std::span<const std::byte>, 2> pieces{
+        std::span<const std::byte>(_state->log._ring + first, head),
+        std::span<const std::byte>(_state->log._ring, end - start - head),
+    };
+    const auto used = std::span(pieces).first(pieces[1].empty() ? 1 : 2);
+
+    if (const int err = _state->persist(used, start); err != 0) {
+        return std::unexpected(error(errc::write_failed, {err, std::generic_category()}));
+    }
+
+    /* Publish as soon as the bytes are on disk, so a flusher dying below never leaves the file ahead of durable. */
+    header->durable.store(end, std::memory_order_seq_cst);
+    header->durable_epoch.fetch_add(1, std::memory_order_seq_cst);
+    if (header->durable_waiters.load(std::memory_order_seq_cst) != 0) {
+        futex_wake(header->durable_epoch);
+    }
+
+    _state->release(start, end);
+    return end;
+}
+
+[[nodiscard]] bool
+wal_flusher::wait_for_commits(const std::chrono::nanoseconds timeout) noexcept
+{
+    auto *header = _state->log._header;
+    const auto ready = [&] {
+        const auto *record = _state->record_at(header->durable.load(std::memory_order_relaxed));
+        return std::atomic_ref(record->kind).load(std::memory_order_seq_cst) != 0;
+    };
+
+    /* Pairs with commit(): announce sleeping, then re-check for a committed record. */
+    header->flusher_sleeping.store(1, std::memory_order_seq_cst);
+    const auto epoch = header->commit_epoch.load(std::memory_order_seq_cst);
+    if (!ready()) {
+        futex_wait(header->commit_epoch, epoch, timeout);
+    }
+    header->flusher_sleeping.store(0, std::memory_order_relaxed);
+
+    return ready();
+}
+
+} // namespace shared_memory
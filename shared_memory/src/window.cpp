@@ -0,0 +1,133 @@
+/**************************************************************
+ * @file window.cpp
+ * @brief Implementation of the sliding shared memory window.
+ **************************************************************/
+
+/**************************************************************
+ * Copyright (c) 2026 Vladimir Kostic
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to
+ * whom the Software is furnished to do so, subject to the
+ * following conditions:
+ *
+ * The above copyright notice and this permission notice shall
+ * be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of shared_memory
+ *
+ * Author:          Vladimir Kostic <vladimir.kostic1997@gmail.com>
+ * Version:         v1.0.0
+ **************************************************************/
+
+#include "shared_memory/window.hpp"
+
+#include <algorithm>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "page_size.hpp"
+
+namespace shared_memory {
+
+[[nodiscard]] std::expected<window, error>
+window::open(const segment_name& shm_name, const std::size_t window_size) noexcept
+{
+    if (window_size == 0) {
+        return std::unexpected(error(errc::map_failed, {EINVAL, std::generic_category()}));
+    }
+
+    auto shm_fd = owned_fd(shm_open(shm_name.c_str(), O_RDWR, S_IRUSR | S_IWUSR));
+    if (!shm_fd.is_valid()) {
+        return std::unexpected(error(errc::open_failed, {errno, std::generic_category()}));
+    }
+
+    struct stat st{};
+    if (fstat(shm_fd.get(), &st) == -1) {
+        return std::unexpected(error(errc::stat_failed, {errno, std::generic_category()}));
+    }
+
+    window result{};
+    result._fd = std::move(shm_fd);
+    result._segment_size = static_cast<std::size_t>(st.st_size);
+    result._window_size = window_size;
+
+    if (auto mapped = result.seek(0); !mapped) {
+        return std::unexpected(mapped.error());
+    }
+
+    return result;
+}
+
+[[nodiscard]] std::expected<window, error>
+window::open(std::string_view shm_name, const std::size_t window_size) noexcept
+{
+    auto name = segment_name::make(shm_name);
+    if (!name) {
+        return std::unexpected(name.error());
+    }
+
+    return open(*name, window_size);
+}
+
+[[nodiscard]] std::expected<std::span<std::byte>, error>
+window::seek(const std::size_t offset) noexcept
+{
+    if (offset > _segment_size) [[unlikely]] {
+        return std::unexpected(error(errc::map_failed, {EINVAL, std::generic_category()}));
+    }
+
+    const std::size_t wanted_end = offset + std::min(_window_size, _segment_size - offset);
+    const bool covered = !_map.empty() && offset >= _map_start && wanted_end <= _map_start + _map.size();
+
+    if (!covered && wanted_end > offset) {
+        /* Map whole pages on both sides so small forward seeks stay inside the mapping. */
+        const std::size_t page = page_size();
+        const std::size_t map_start = offset - (offset % page);
+        const std::size_t map_end = std::min((wanted_end + page - 1) / page * page, _segment_size);
+        const std::size_t map_length = map_end - map_start;
+
+        void *addr = mmap(nullptr, map_length, PROT_READ | PROT_WRITE, MAP_SHARED, _fd.get(), static_cast<off_t>(map_start));
+        if (addr == MAP_FAILED) {
+            return std::unexpected(error(errc::map_failed, {errno, std::generic_category()}));
+        }
+
+        _unmap();
+        _map = {static_cast<std::byte *>(addr), map_length};
+        _map_start = map_start;
+    }
+
+    _cursor = offset;
+
+    return _visible();
+}
+
+void
+window::_unmap() noexcept
+{
+    if (!_map.empty()) {
+        munmap(_map.data(), _map.size());
+        _map = {};
+        _map_start = 0;
+    }
+}
+
+} // namespace shared_memory
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include "shared_memory/async_create.hpp"
+#include "shared_memory/shared_memory.hpp"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+using shm_type = shared_memory::shared_memory;
+using shared_memory::segment_name;
+
+segment_name unique_shm_name() {
+    static int counter = 0;
+    return *segment_name::make("/shm_async_test_" + std::to_string(getpid()) + "_" + std::to_string(counter++));
+}
+
+TEST(CreateOptionsTest, PrefaultedSegmentIsUsable) {
+    shared_memory::create_options options{};
+    options.prefault = true;
+
+    auto result = shm_type::create(unique_shm_name(), 1 << 20, options);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->size(), 1u << 20);
+    EXPECT_EQ(result->get_memory()[12345], std::byte{0});
+}
+
+TEST(CreateAsyncTest, ProducesSegmentOnceReady) {
+    shared_memory::create_options options{};
+    options.prefault = true;
+
+    auto pending = shared_memory::create_async(unique_shm_name(), 4 << 20, options);
+    ASSERT_TRUE(pending.valid());
+
+    pending.wait();
+    EXPECT_TRUE(pending.ready());
+
+    auto result = pending.get();
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->size(), 4u << 20);
+    EXPECT_FALSE(pending.valid());
+}
+
+TEST(CreateAsyncTest, ReportsCreationErrors) {
+    const auto name = unique_shm_name();
+    auto first = shm_type::create(name, 64);
+    ASSERT_TRUE(first.has_value());
+
+    auto pending = shared_memory::create_async(name, 64);
+    auto result = pending.get();
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().kind(), shared_memory::errc::open_failed);
+}
+
+TEST(CreateAsyncTest, DroppedHandleReleasesSegment) {
+    shared_memory::create_options options{};
+    options.prefault = true;
+
+    const auto name = unique_shm_name();
+    {
+        auto dropped = shared_memory::create_async(name, 64 << 20, options);
+    }
+
+    /* The name frees up once the background thread has released the segment. */
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    auto reused = shm_type::create(name, 64);
+    while (!reused.has_value() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        reused = shm_type::create(name, 64);
+    }
+    EXPECT_TRUE(reused.has_value());
+}
+
+TEST(CreateAsyncTest, DefaultHandleIsNotReady) {
+    shared_memory::pending_segment pending;
+    EXPECT_FALSE(pending.valid());
+    EXPECT_FALSE(pending.ready());
+}
+
+} // namespace
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+
+#include "shared_memory/bitmap.hpp"
+#include "shared_memory/shared_memory.hpp"
+
+#include <algorithm>
+#include <barrier>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+using shared_memory::hierarchical_bitmap;
+using shm_type = shared_memory::shared_memory;
+
+std::string unique_shm_name() {
+    static int counter = 0;
+    return "/shm_bitmap_test_" + std::to_string(getpid()) + "_" + std::to_string(counter++);
+}
+
+TEST(BitmapTest, SetClearAndTest) {
+    auto owner = shm_type::create(unique_shm_name(), hierarchical_bitmap::required_size(1000));
+    ASSERT_TRUE(owner.has_value());
+    auto bitmap = hierarchical_bitmap::create(owner->get_memory(), 1000);
+    ASSERT_TRUE(bitmap.has_value());
+
+    EXPECT_FALSE(bitmap->set(5));
+    EXPECT_TRUE(bitmap->set(5));
+    EXPECT_TRUE(bitmap->test(5));
+    EXPECT_FALSE(bitmap->test(6));
+    EXPECT_TRUE(bitmap->clear(5));
+    EXPECT_FALSE(bitmap->clear(5));
+    EXPECT_FALSE(bitmap->test(5));
+}
+
+TEST(BitmapTest, FindsAcrossSummaryLevels) {
+    constexpr std::size_t bits = 3'000'000;
+    auto owner = shm_type::create(unique_shm_name(), hierarchical_bitmap::required_size(bits));
+    ASSERT_TRUE(owner.has_value());
+    auto bitmap = hierarchical_bitmap::create(owner->get_memory(), bits);
+    ASSERT_TRUE(bitmap.has_value());
+
+    EXPECT_FALSE(bitmap->find_first_set().has_value());
+    EXPECT_EQ(bitmap->find_first_clear(), 0u);
+
+    bitmap->set(70);
+    bitmap->set(300'000);
+    bitmap->set(bits - 1);
+    EXPECT_EQ(bitmap->find_first_set(), 70u);
+    EXPECT_EQ(bitmap->find_first_set(71), 300'000u);
+    EXPECT_EQ(bitmap->find_first_set(300'001), bits - 1);
+    EXPECT_FALSE(bitmap->find_first_set(bits).has_value());
+
+    bitmap->clear(300'000);
+    EXPECT_EQ(bitmap->find_first_set(71), bits - 1);
+    EXPECT_EQ(bitmap->find_first_clear(70), 71u);
+}
+
+TEST(BitmapTest, AcquireFillsInOrderAndReportsExhaustion) {
+    constexpr std::size_t bits = 200;
+    auto owner = shm_type::create(unique_shm_name(), hierarchical_bitmap::required_size(bits));
+    ASSERT_TRUE(owner.has_value());
+    auto bitmap = hierarchical_bitmap::create(owner->get_memory(), bits);
+    ASSERT_TRUE(bitmap.has_value());
+
+    for (std::size_t i = 0; i < bits; ++i) {
+        ASSERT_EQ(bitmap->acquire().value(), i);
+    }
+    auto full = bitmap->acquire();
+    ASSERT_FALSE(full.has_value());
+    EXPECT_EQ(full.error().kind(), shared_memory::errc::allocate_failed);
+    EXPECT_EQ(full.error().code().value(), ENOSPC);
+    EXPECT_FALSE(bitmap->find_first_clear().has_value());
+
+    EXPECT_TRUE(bitmap->release(130));
+    EXPECT_EQ(bitmap->acquire().value(), 130u);
+}
+
+TEST(BitmapTest, AttachedBitmapSharesBits) {
+    const std::string name = unique_shm_name();
+    auto owner = shm_type::create(name, hierarchical_bitmap::required_size(128));
+    ASSERT_TRUE(owner.has_value());
+    auto first = hierarchical_bitmap::create(owner->get_memory(), 128);
+    ASSERT_TRUE(first.has_value());
+    first->set(99);
+
+    auto mapping = shm_type::open(name);
+    ASSERT_TRUE(mapping.has_value());
+    auto second = hierarchical_bitmap::attach(mapping->get_memory());
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(second->size(), 128u);
+    EXPECT_EQ(second->find_first_set(), 99u);
+
+    auto unformatted = shm_type::create(unique_shm_name(), 4096);
+    ASSERT_TRUE(unformatted.has_value());
+    auto rejected = hierarchical_bitmap::attach(unformatted->get_memory());
+    ASSERT_FALSE(rejected.has_value());
+    EXPECT_EQ(rejected.error().code().value(), EPROTO);
+}
+
+TEST(BitmapTest, ConcurrentAcquireHandsOutEachSlotOnce) {
+    constexpr std::size_t bits = 64 * 64 * 3;
+    auto owner = shm_type::create(unique_shm_name(), hierarchical_bitmap::required_size(bits));
+    ASSERT_TRUE(owner.has_value());
+    auto bitmap = hierarchical_bitmap::create(owner->get_memory(), bits);
+    ASSERT_TRUE(bitmap.has_value());
+
+    constexpr int threads = 4;
+    std::vector<std::vector<std::size_t>> claimed(threads);
+    std::barrier churned(threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            /* Churn a few slots so releases race with acquires before claiming for good. */
+            for (int round = 0; round < 1000; ++round) {
+                const auto slot = bitmap->acquire().value();
+                bitmap->release(slot);
+            }
+            churned.arrive_and_wait();
+            while (auto slot = bitmap->acquire()) {
+                claimed[t].push_back(*slot);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    std::vector<std::size_t> all;
+    for (const auto& slots : claimed) {
+        all.insert(all.end(), slots.begin(), slots.end());
+    }
+    std::sort(all.begin(), all.end());
+    ASSERT_EQ(all.size(), bits);
+    for (std::size_t i = 0; i < bits; ++i) {
+        ASSERT_EQ(all[i], i);
+    }
+}
+
+} // namespace
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include "shared_memory/bloom_filter.hpp"
+#include "shared_memory/shared_memory.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+using shared_memory::bloom_filter;
+using shm_type = shared_memory::shared_memory;
+
+std::string unique_shm_name() {
+    static int counter = 0;
+    return "/shm_bloom_test_" + std::to_string(getpid()) + "_" + std::to_string(counter++);
+}
+
+TEST(BloomFilterTest, InsertedKeysAreAlwaysFound) {
+    const auto blocks = bloom_filter::blocks_for(10000);
+    auto owner = shm_type::create(unique_shm_name(), bloom_filter::required_size(blocks));
+    ASSERT_TRUE(owner.has_value());
+    auto filter = bloom_filter::create(owner->get_memory(), blocks);
+    ASSERT_TRUE(filter.has_value());
+
+    EXPECT_FALSE(filter->contains("absent"));
+    for (int i = 0; i < 10000; ++i) {
+        filter->insert("key-" + std::to_string(i));
+    }
+    for (int i = 0; i < 10000; ++i) {
+        ASSERT_TRUE(filter->contains("key-" + std::to_string(i)));
+    }
+}
+
+TEST(BloomFilterTest, FalsePositiveRateMatchesBudget) {
+    const auto blocks = bloom_filter::blocks_for(10000, 10);
+    auto owner = shm_type::create(unique_shm_name(), bloom_filter::required_size(blocks));
+    ASSERT_TRUE(owner.has_value());
+    auto filter = bloom_filter::create(owner->get_memory(), blocks);
+    ASSERT_TRUE(filter.has_value());
+
+    for (std::uint64_t i = 0; i < 10000; ++i) {
+        filter->insert_hash(shared_memory::fnv1a(i));
+    }
+
+    int false_positives = 0;
+    for (std::uint64_t i = 10000; i < 110000; ++i) {
+        false_positives += filter->contains_hash(shared_memory::fnv1a(i));
+    }
+    EXPECT_LT(false_positives, 3000);
+}
+
+TEST(BloomFilterTest, AttachedFilterSeesInsertsFromOtherMapping) {
+    const std::string name = unique_shm_name();
+    auto owner = shm_type::create(name, bloom_filter::required_size(16));
+    ASSERT_TRUE(owner.has_value());
+    auto writer = bloom_filter::create(owner->get_memory(), 16);
+    ASSERT_TRUE(writer.has_value());
+
+    auto mapping = shm_type::open(name);
+    ASSERT_TRUE(mapping.has_value());
+    auto reader = bloom_filter::attach(mapping->get_memory());
+    ASSERT_TRUE(reader.has_value());
+    EXPECT_EQ(reader->block_count(), 16u);
+
+    writer->insert("order-17");
+    EXPECT_TRUE(reader->contains("order-17"));
+}
+
+TEST(BloomFilterTest, RejectsBadRegions) {
+    auto owner = shm_type::create(unique_shm_name(), 4096);
+    ASSERT_TRUE(owner.has_value());
+
+    auto too_small = bloom_filter::create(owner->get_memory(), 1000);
+    ASSERT_FALSE(too_small.has_value());
+    EXPECT_EQ(too_small.error().code().value(), ENOSPC);
+
+    auto unformatted = bloom_filter::attach(owner->get_memory());
+    ASSERT_FALSE(unformatted.has_value());
+    EXPECT_EQ(unformatted.error().code().value(), EPROTO);
+}
+
+TEST(BloomFilterTest, ConcurrentInsertsAreNotLost) {
+    const auto blocks = bloom_filter::blocks_for(40000);
+    auto owner = shm_type::create(unique_shm_name(), bloom_filter::required_size(blocks));
+    ASSERT_TRUE(owner.has_value());
+    auto filter = bloom_filter::create(owner->get_memory(), blocks);
+    ASSERT_TRUE(filter.has_value());
+
+    std::vector<std::thread> writers;
+    for (std::uint64_t t = 0; t < 4; ++t) {
+        writers.emplace_back([&, t] {
+            for (std::uint64_t i = t; i < 40000; i += 4) {
+                filter->insert_hash(shared_memory::fnv1a(i));
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    for (std::uint64_t i = 0; i < 40000; ++i) {
+        ASSERT_TRUE(filter->contains_hash(shared_memory::fnv1a(i)));
+    }
+}
+
+} // namespace
@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+
+#include "shared_memory/btree.hpp"
+#include "shared_memory/shared_memory.hpp"
+
+#include <atomic>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+using shared_memory::btree;
+using shm_type = shared_memory::shared_memory;
+
+std::string unique_shm_name() {
+    static int counter = 0;
+    return "/shm_btree_test_" + std::to_string(getpid()) + "_" + std::to_string(counter++);
+}
+
+TEST(BtreeTest, InsertFindAndOverwrite) {
+    auto owner = shm_type::create(unique_shm_name(), btree::required_size(64));
+    ASSERT_TRUE(owner.has_value());
+    auto tree = btree::create(owner->get_memory(), 64);
+    ASSERT_TRUE(tree.has_value());
+
+    EXPECT_TRUE(tree->insert(42, 1).value());
+    EXPECT_FALSE(tree->insert(42, 2).value());
+    EXPECT_EQ(tree->find(42), 2u);
+    EXPECT_FALSE(tree->find(41).has_value());
+    EXPECT_EQ(tree->size(), 1u);
+}
+
+TEST(BtreeTest, MatchesStdMapAcrossSplits) {
+    constexpr std::size_t nodes = 4096;
+    auto owner = shm_type::create(unique_shm_name(), btree::required_size(nodes));
+    ASSERT_TRUE(owner.has_value());
+    auto tree = btree::create(owner->get_memory(), nodes);
+    ASSERT_TRUE(tree.has_value());
+
+    std::map<std::uint64_t, std::uint64_t> reference;
+    std::mt19937_64 random(7);
+    for (int i = 0; i < 20000; ++i) {
+        const auto key = random() % 50000;
+        ASSERT_TRUE(tree->insert(key, key * 3).has_value());
+        reference[key] = key * 3;
+    }
+    for (int i = 0; i < 5000; ++i) {
+        const auto key = random() % 50000;
+        EXPECT_EQ(tree->erase(key), reference.erase(key) == 1);
+    }
+
+    EXPECT_EQ(tree->size(), reference.size());
+    for (const auto& [key, value] : reference) {
+        ASSERT_EQ(tree->find(key), value);
+    }
+
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> visited;
+    tree->for_each(1000, 30000, [&](std::uint64_t key, std::uint64_t value) { visited.emplace_back(key, value); });
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> expected(reference.lower_bound(1000), reference.lower_bound(30000));
+    EXPECT_EQ(visited, expected);
+}
+
+TEST(BtreeTest, ForEachStopsWhenVisitorReturnsFalse) {
+    auto owner = shm_type::create(unique_shm_name(), btree::required_size(64));
+    ASSERT_TRUE(owner.has_value());
+    auto tree = btree::create(owner->get_memory(), 64);
+    ASSERT_TRUE(tree.has_value());
+    for (std::uint64_t key = 0; key < 100; ++key) {
+        ASSERT_TRUE(tree->insert(key, key).has_value());
+    }
+
+    int calls = 0;
+    tree->for_each(10, UINT64_MAX, [&](std::uint64_t, std::uint64_t) { return ++calls < 5; });
+    EXPECT_EQ(calls, 5);
+}
+
+TEST(BtreeTest, AttachedTreeSharesEntries) {
+    const std::string name = unique_shm_name();
+    auto owner = shm_type::create(name, btree::required_size(64));
+    ASSERT_TRUE(owner.has_value());
+    auto writer = btree::create(owner->get_memory(), 64);
+    ASSERT_TRUE(writer.has_value());
+    ASSERT_TRUE(writer->insert(7, 70).has_value());
+
+    auto mapping = shm_type::open(name);
+    ASSERT_TRUE(mapping.has_value());
+    auto reader = btree::attach(mapping->get_memory());
+    ASSERT_TRUE(reader.has_value());
+    EXPECT_EQ(reader->find(7), 70u);
+
+    ASSERT_TRUE(reader->insert(8, 80).has_value());
+    EXPECT_EQ(writer->find(8), 80u);
+}
+
+TEST(BtreeTest, ReportsNodeExhaustion) {
+    auto owner = shm_type::create(unique_shm_name(), btree::required_size(2));
+    ASSERT_TRUE(owner.has_value());
+    auto tree = btree::create(owner->get_memory(), 2);
+    ASSERT_TRUE(tree.has_value());
+
+    for (std::uint64_t key = 0; key < btree::MAX_KEYS; ++key) {
+        ASSERT_TRUE(tree->insert(key, key).has_value());
+    }
+    auto full = tree->insert(btree::MAX_KEYS, 0);
+    ASSERT_FALSE(full.has_value());
+    EXPECT_EQ(full.error().kind(), shared_memory::errc::allocate_failed);
+    EXPECT_EQ(full.error().code().value(), ENOSPC);
+    EXPECT_EQ(tree->size(), btree::MAX_KEYS);
+}
+
+TEST(BtreeTest, RejectsBadRegions) {
+    auto owner = shm_type::create(unique_shm_name(), 4096);
+    ASSERT_TRUE(owner.has_value());
+
+    auto too_small = btree::create(owner->get_memory(), 1000);
+    ASSERT_FALSE(too_small.has_value());
+    EXPECT_EQ(too_small.error().code().value(), ENOSPC);
+
+    auto unformatted = btree::attach(owner->get_memory());
+    ASSERT_FALSE(unformatted.has_value());
+    EXPECT_EQ(unformatted.error().code().value(), EPROTO);
+}
+
+TEST(BtreeTest, ReadersNeverMissStableKeysDuringSplits) {
+    constexpr std::size_t nodes = 8192;
+    auto owner = shm_type::create(unique_shm_name(), btree::required_size(nodes));
+    ASSERT_TRUE(owner.has_value());
+    auto tree = btree::create(owner->get_memory(), nodes);
+    ASSERT_TRUE(tree.has_value());
+
+    /* Even keys exist before the readers start; odd keys are inserted concurrently and force splits. */
+    for (std::uint64_t key = 0; key < 20000; key += 2) {
+        ASSERT_TRUE(tree->insert(key, key).has_value());
+    }
+
+    std::atomic<bool> done{false};
+    std::atomic<int> misses{0};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&] {
+            std::uint64_t key = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                if (tree->find(key) != key) {
+                    misses.fetch_add(1);
+                }
+                key = (key + 2) % 20000;
+
+                std::uint64_t previous = 0;
+                std::size_t evens = 0;
+                tree->for_each(4000, 4200, [&](std::uint64_t k, std::uint64_t) {
+                    if (k < previous) {
+                        misses.fetch_add(1);
+                    }
+                    previous = k;
+                    evens += k % 2 == 0;
+                });
+                if (evens != 100) {
+                    misses.fetch_add(1);
+                }
+            }
+        });
+    }
+
+    for (std::uint64_t key = 1; key < 20000; key += 2) {
+        ASSERT_TRUE(tree->insert(key, key).has_value());
+    }
+    done = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(misses.load(), 0);
+    EXPECT_EQ(tree->size(), 20000u);
+}
+
+} // namespace
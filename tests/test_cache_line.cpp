@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include "shared_memory/cache_line.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace {
+
+using shared_memory::CACHE_LINE_SIZE;
+using shared_memory::cache_padded;
+using shared_memory::field_info;
+
+constexpr std::uint32_t PRODUCER = 1;
+constexpr std::uint32_t CONSUMER = 2;
+
+struct unpadded_queue {
+    std::atomic<std::uint64_t> head;
+    std::atomic<std::uint64_t> tail;
+    std::uint64_t capacity;
+};
+
+struct padded_queue {
+    cache_padded<std::atomic<std::uint64_t>> head;
+    cache_padded<std::atomic<std::uint64_t>> tail;
+    std::uint64_t capacity;
+};
+
+constexpr std::array<field_info, 3> unpadded_fields{
+    SHARED_MEMORY_FIELD(unpadded_queue, head, PRODUCER),
+    SHARED_MEMORY_FIELD(unpadded_queue, tail, CONSUMER),
+    SHARED_MEMORY_FIELD(unpadded_queue, capacity, shared_memory::READ_ONLY_FIELD),
+};
+
+constexpr std::array<field_info, 3> padded_fields{
+    SHARED_MEMORY_FIELD(padded_queue, head, PRODUCER),
+    SHARED_MEMORY_FIELD(padded_queue, tail, CONSUMER),
+    SHARED_MEMORY_FIELD(padded_queue, capacity, shared_memory::READ_ONLY_FIELD),
+};
+
+static_assert(shared_memory::has_false_sharing(unpadded_fields));
+static_assert(!shared_memory::has_false_sharing(padded_fields));
+
+TEST(CacheLineTest, PaddedValueOccupiesWholeLine) {
+    EXPECT_EQ(sizeof(cache_padded<std::uint8_t>), CACHE_LINE_SIZE);
+    EXPECT_EQ(alignof(cache_padded<std::uint8_t>), CACHE_LINE_SIZE);
+    EXPECT_EQ(sizeof(cache_padded<std::array<std::byte, 65>>), 2 * CACHE_LINE_SIZE);
+
+    cache_padded<int> padded{};
+    *padded = 5;
+    EXPECT_EQ(padded.value, 5);
+}
+
+TEST(CacheLineTest, PlacementHelpers) {
+    EXPECT_EQ(shared_memory::align_up(0), 0u);
+    EXPECT_EQ(shared_memory::align_up(1), 64u);
+    EXPECT_EQ(shared_memory::align_up(100, 32), 128u);
+    EXPECT_EQ(shared_memory::cache_line_of(127), 1u);
+
+    EXPECT_TRUE(shared_memory::shares_cache_line(0, 8, 56, 8));
+    EXPECT_FALSE(shared_memory::shares_cache_line(0, 8, 64, 8));
+    EXPECT_TRUE(shared_memory::shares_cache_line(60, 8, 64, 8));
+    EXPECT_FALSE(shared_memory::shares_cache_line(0, 0, 0, 8));
+}
+
+TEST(CacheLineTest, FindFalseSharingReportsConflicts) {
+    const auto conflicts = shared_memory::find_false_sharing(unpadded_fields);
+    ASSERT_EQ(conflicts.size(), 3u);
+    EXPECT_EQ(conflicts[0].first, "head");
+    EXPECT_EQ(conflicts[0].second, "tail");
+    EXPECT_EQ(conflicts[0].line, 0u);
+
+    EXPECT_TRUE(shared_memory::find_false_sharing(padded_fields).empty());
+}
+
+TEST(CacheLineTest, PerCoreArraySlotsAreIsolated) {
+    shared_memory::per_core_array<std::atomic<std::uint64_t>, 4> counters{};
+    EXPECT_EQ(counters.size(), 4u);
+    EXPECT_LT(counters.current_slot(), 4u);
+
+    counters.local().fetch_add(1);
+    std::uint64_t total = 0;
+    for (std::size_t i = 0; i < counters.size(); ++i) {
+        total += counters[i].load();
+    }
+    EXPECT_EQ(total, 1u);
+
+    EXPECT_EQ(reinterpret_cast<std::byte *>(&counters[1]) - reinterpret_cast<std::byte *>(&counters[0]),
+              static_cast<std::ptrdiff_t>(CACHE_LINE_SIZE));
+}
+
+} // namespace
@@ -0,0 +1,285 @@
+#include <gtest/gtest.h>
+
+#include "shared_memory/shared_memory.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+using shm_type = shared_memory::shared_memory;
+
+std::string unique_shm_name() {
+    static int counter = 0;
+    return "/shm_checkpoint_test_" + std::to_string(getpid()) + "_" + std::to_string(counter++);
+}
+
+std::filesystem::path unique_file_path() {
+    static int counter = 0;
+    return std::filesystem::temp_directory_path() / ("shm_checkpoint_test_" + std::to_string(getpid()) + "_" + std::to_string(counter++));
+}
+
+void fill_pattern(shm_type& shm) {
+    auto memory = shm.get_memory();
+    for (std::size_t i = 0; i < memory.size(); ++i) {
+        memory[i] = static_cast<std::byte>((i * 31 + i / 4096) & 0xff);
+    }
+}
+
+std::vector<std::byte> read_file(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::vector<std::byte> result(bytes.size());
+    std::ranges::transform(bytes, result.begin(), [](char c) { return static_cast<std::byte>(c); });
+    return result;
+}
+
+std::size_t allocated_bytes(const std::filesystem::path& path) {
+    struct stat st{};
+    EXPECT_EQ(::stat(path.c_str(), &st), 0);
+    return static_cast<std::size_t>(st.st_blocks) * 512;
+}
+
+/* A 64 MiB segment with three written pages, the last one partial. */
+shm_type make_sparse_segment(const std::string& name) {
+    auto shm = shm_type::create(name, (64u << 20) + 123);
+    EXPECT_TRUE(shm.has_value());
+    auto memory = shm->get_memory();
+    memory[5] = std::byte{1};
+    memory[(20u << 20) + 7] = std::byte{2};
+    memory[memory.size() - 1] = std::byte{3};
+    return std::move(*shm);
+}
+
+/* Compares without reading the segment, which would fault its holes in. */
+void expect_sparse_contents(const std::vector<std::byte>& contents) {
+    ASSERT_EQ(contents.size(), (64u << 20) + 123);
+    auto expected = std::vector<std::byte>(contents.size());
+    expected[5] = std::byte{1};
+    expected[(20u << 20) + 7] = std::byte{2};
+    expected.back() = std::byte{3};
+    EXPECT_TRUE(contents == expected);
+}
+
+void expect_file_matches(const shm_type& shm, const std::filesystem::path& path) {
+    const auto contents = read_file(path);
+    const auto memory = shm.get_memory();
+    ASSERT_EQ(contents.size(), memory.size());
+    EXPECT_TRUE(std::ranges::equal(contents, memory));
+}
+
+TEST(CheckpointTest, WritesSegmentThroughDefaultPath) {
+    auto shm = shm_type::create(unique_shm_name(), 3 * 1024 * 1024 + 123);
+    ASSERT_TRUE(shm.has_value());
+    fill_pattern(*shm);
+
+    const auto path = unique_file_path();
+    ASSERT_TRUE(shm->checkpoint(path).has_value());
+    expect_file_matches(*shm, path);
+    std::filesystem::remove(path);
+}
+
+TEST(CheckpointTest, ManySmallChunksInFlight) {
+    auto shm = shm_type::create(unique_shm_name(), 1024 * 1024);
+    ASSERT_TRUE(shm.has_value());
+    fill_pattern(*shm);
+
+    shared_memory::checkpoint_options options;
+    options.chunk_size = 4096;
+    options.queue_depth = 8;
+    options.direct_io = false;
+
+    const auto path = unique_file_path();
+    ASSERT_TRUE(shm->checkpoint(path, options).has_value());
+    expect_file_matches(*shm, path);
+    std::filesystem::remove(path);
+}
+
+TEST(CheckpointTest, PwriteFallbackProducesSameFile) {
+    auto shm = shm_type::create(unique_shm_name(), 200'000);
+    ASSERT_TRUE(shm.has_value());
+    fill_pattern(*shm);
+
+    shared_memory::checkpoint_options options;
+    options.use_io_uring = false;
+    options.chunk_size = 65536;
+
+    const auto path = unique_file_path();
+    ASSERT_TRUE(shm->checkpoint(path, options).has_value());
+    expect_file_matches(*shm, path);
+    std::filesystem::remove(path);
+}
+
+TEST(CheckpointTest, OverwritesExistingFile) {
+    auto shm = shm_type::create(unique_shm_name(), 8192);
+    ASSERT_TRUE(shm.has_value());
+    fill_pattern(*shm);
+
+    const auto path = unique_file_path();
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << std::string(100'000, 'x');
+    }
+    ASSERT_TRUE(shm->checkpoint(path).has_value());
+    expect_file_matches(*shm, path);
+    std::filesystem::remove(path);
+}
+
+TEST(CheckpointTest, ReportsOpenFailure) {
+    auto shm = shm_type::create(unique_shm_name(), 4096);
+    ASSERT_TRUE(shm.has_value());
+
+    auto result = shm->checkpoint("/nonexistent_dir_for_checkpoint/file");
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().kind(), shared_memory::errc::open_failed);
+    EXPECT_EQ(result.error().code().value(), ENOENT);
+}
+
+TEST(CheckpointTest, SkipsHolesAndWritesSparseFile) {
+    const std::string name = unique_shm_name();
+    auto shm = make_sparse_segment(name);
+
+    for (const bool use_io_uring : {true, false}) {
+        shared_memory::checkpoint_options options;
+        options.use_io_uring = use_io_uring;
+        const auto path = unique_file_path();
+        ASSERT_TRUE(shm.checkpoint(path, options).has_value());
+        EXPECT_LT(allocated_bytes(path), std::size_t{1} << 20);
+        expect_sparse_contents(read_file(path));
+        std::filesystem::remove(path);
+    }
+
+    /* Neither pass faulted the untouched pages into the segment. */
+    EXPECT_LT(allocated_bytes("/dev/shm" + name), std::size_t{1} << 20);
+}
+
+TEST(CheckpointTest, IgnoresHolesOfReplacedName) {
+    const std::string name = unique_shm_name();
+    auto shm = make_sparse_segment(name);
+
+    /* A same-sized, never-written object now answers to the name. */
+    ASSERT_EQ(shm_unlink(name.c_str()), 0);
+    auto impostor = shm_type::create(name, shm.size());
+    ASSERT_TRUE(impostor.has_value());
+
+    const auto path = unique_file_path();
+    ASSERT_TRUE(shm.checkpoint(path).has_value());
+    expect_sparse_contents(read_file(path));
+    std::filesystem::remove(path);
+}
+
+TEST(CheckpointTest, SkipHolesDisabledWritesEverything) {
+    auto shm = make_sparse_segment(unique_shm_name());
+
+    shared_memory::checkpoint_options options;
+    options.skip_holes = false;
+    const auto path = unique_file_path();
+    ASSERT_TRUE(shm.checkpoint(path, options).has_value());
+    expect_file_matches(shm, path);
+    EXPECT_GE(allocated_bytes(path), shm.size() - 4096);
+    std::filesystem::remove(path);
+}
+
+TEST(RestoreTest, CopiesCheckpointIntoNewSegment) {
+    auto source = shm_type::create(unique_shm_name(), 2 * 1024 * 1024 + 777);
+    ASSERT_TRUE(source.has_value());
+    fill_pattern(*source);
+    const auto path = unique_file_path();
+    ASSERT_TRUE(source->checkpoint(path).has_value());
+
+    const std::string name = unique_shm_name();
+    auto restored = shm_type::restore(path, name);
+    ASSERT_TRUE(restored.has_value());
+    EXPECT_TRUE(std::ranges::equal(restored->get_memory(), source->get_memory()));
+
+    auto attached = shm_type::open(name);
+    ASSERT_TRUE(attached.has_value());
+    EXPECT_EQ(attached->size(), source->size());
+    std::filesystem::remove(path);
+}
+
+TEST(RestoreTest, PreadFallbackWithSmallChunks) {
+    auto source = shm_type::create(unique_shm_name(), 100'003);
+    ASSERT_TRUE(source.has_value());
+    fill_pattern(*source);
+    const auto path = unique_file_path();
+    ASSERT_TRUE(source->checkpoint(path).has_value());
+
+    shared_memory::restore_options options;
+    options.use_io_uring = false;
+    options.direct_io = false;
+    options.chunk_size = 4096;
+
+    auto restored = shm_type::restore(path, unique_shm_name(), options);
+    ASSERT_TRUE(restored.has_value());
+    EXPECT_TRUE(std::ranges::equal(restored->get_memory(), source->get_memory()));
+    std::filesystem::remove(path);
+}
+
+TEST(RestoreTest, SparseCheckpointLeavesHolesUnpopulated) {
+    auto source = make_sparse_segment(unique_shm_name());
+    const auto path = unique_file_path();
+    ASSERT_TRUE(source.checkpoint(path).has_value());
+
+    const std::string name = unique_shm_name();
+    auto restored = shm_type::restore(path, name);
+    ASSERT_TRUE(restored.has_value());
+    EXPECT_LT(allocated_bytes("/dev/shm" + name), std::size_t{1} << 20);
+    EXPECT_TRUE(std::ranges::equal(restored->get_memory(), source.get_memory()));
+    std::filesystem::remove(path);
+}
+
+TEST(RestoreTest, MappedFileModeWritesThroughToFile) {
+    auto source = shm_type::create(unique_shm_name(), 8192);
+    ASSERT_TRUE(source.has_value());
+    fill_pattern(*source);
+    const auto path = unique_file_path();
+    ASSERT_TRUE(source->checkpoint(path).has_value());
+
+    shared_memory::restore_options options;
+    options.mode = shared_memory::restore_mode::MAPPED_FILE;
+    {
+        auto mapped = shm_type::restore(path, unique_shm_name(), options);
+        ASSERT_TRUE(mapped.has_value());
+        EXPECT_TRUE(std::ranges::equal(mapped->get_memory(), source->get_memory()));
+        mapped->get_memory()[10] = std::byte{0x5a};
+    }
+
+    EXPECT_EQ(read_file(path)[10], std::byte{0x5a});
+    std::filesystem::remove(path);
+}
+
+TEST(RestoreTest, ReportsFailures) {
+    auto missing = shm_type::restore("/nonexistent_dir_for_checkpoint/file", unique_shm_name());
+    ASSERT_FALSE(missing.has_value());
+    EXPECT_EQ(missing.error().kind(), shared_memory::errc::open_failed);
+    EXPECT_EQ(missing.error().code().value(), ENOENT);
+
+    auto source = shm_type::create(unique_shm_name(), 4096);
+    ASSERT_TRUE(source.has_value());
+    const auto path = unique_file_path();
+    ASSERT_TRUE(source->checkpoint(path).has_value());
+
+    const std::string name = unique_shm_name();
+    auto existing = shm_type::create(name, 4096);
+    ASSERT_TRUE(existing.has_value());
+    auto clash = shm_type::restore(path, name);
+    ASSERT_FALSE(clash.has_value());
+    EXPECT_EQ(clash.error().code().value(), EEXIST);
+
+    shared_memory::restore_options options;
+    options.segment.mode = shared_memory::access_mode::READ;
+    auto read_only = shm_type::restore(path, unique_shm_name(), options);
+    ASSERT_FALSE(read_only.has_value());
+    EXPECT_EQ(read_only.error().code().value(), EINVAL);
+    std::filesystem::remove(path);
+}
+
+} // namespace
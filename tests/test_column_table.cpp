@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+
+#include "shared_memory/column_table.hpp"
+#include "shared_memory/shared_memory.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+using ticks = shared_memory::column_table<std::uint64_t, double, std::int32_t>;
+using shm_type = shared_memory::shared_memory;
+
+std::string unique_shm_name() {
+    static int counter = 0;
+    return "/shm_column_test_" + std::to_string(getpid()) + "_" + std::to_string(counter++);
+}
+
+TEST(ColumnTableTest, AppendPublishesRowsToAttachedReader) {
+    const std::string name = unique_shm_name();
+    auto owner = shm_type::create(name, ticks::required_size(100));
+    ASSERT_TRUE(owner.has_value());
+
+    auto writer = ticks::create(owner->get_memory(), 100);
+    ASSERT_TRUE(writer.has_value());
+
+    auto mapping = shm_type::open(name);
+    ASSERT_TRUE(mapping.has_value());
+    auto reader = ticks::attach(mapping->get_memory());
+    ASSERT_TRUE(reader.has_value());
+    EXPECT_EQ(reader->size(), 0u);
+
+    ASSERT_TRUE(writer->append(1, 10.5, -3));
+    ASSERT_TRUE(writer->append(2, 11.0, 7));
+
+    EXPECT_EQ(reader->size(), 2u);
+    EXPECT_EQ(reader->capacity(), 100u);
+    EXPECT_EQ(reader->column<0>()[1], 2u);
+    EXPECT_DOUBLE_EQ(reader->column<1>()[0], 10.5);
+    EXPECT_EQ(reader->column<2>()[0], -3);
+}
+
+TEST(ColumnTableTest, ColumnsAreCacheLineAligned) {
+    std::vector<std::byte> storage(ticks::required_size(10) + 64);
+    auto *aligned = reinterpret_cast<std::byte *>((reinterpret_cast<std::uintptr_t>(storage.data()) + 63) & ~std::uintptr_t{63});
+
+    auto table = ticks::create({aligned, ticks::required_size(10)}, 10);
+    ASSERT_TRUE(table.has_value());
+    ASSERT_TRUE(table->append(1, 1.0, 1));
+
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(table->column<0>().data()) % 64, 0u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(table->column<1>().data()) % 64, 0u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(table->column<2>().data()) % 64, 0u);
+}
+
+TEST(ColumnTableTest, AppendFailsWhenFull) {
+    auto owner = shm_type::create(unique_shm_name(), ticks::required_size(1));
+    ASSERT_TRUE(owner.has_value());
+
+    auto table = ticks::create(owner->get_memory(), 1);
+    ASSERT_TRUE(table.has_value());
+    EXPECT_TRUE(table->append(1, 1.0, 1));
+    EXPECT_FALSE(table->append(2, 2.0, 2));
+    EXPECT_EQ(table->size(), 1u);
+}
+
+TEST(ColumnTableTest, RejectsSmallOrForeignRegions) {
+    auto owner = shm_type::create(unique_shm_name(), 4096);
+    ASSERT_TRUE(owner.has_value());
+
+    auto too_small = ticks::create(owner->get_memory(), 1'000'000);
+    ASSERT_FALSE(too_small.has_value());
+    EXPECT_EQ(too_small.error().code().value(), ENOSPC);
+
+    auto unformatted = ticks::attach(owner->get_memory());
+    ASSERT_FALSE(unformatted.has_value());
+    EXPECT_EQ(unformatted.error().kind(), shared_memory::errc::layout_mismatch);
+
+    ASSERT_TRUE(ticks::create(owner->get_memory(), 10).has_value());
+    auto other = shared_memory::column_table<std::uint64_t>::attach(owner->get_memory());
+    EXPECT_FALSE(other.has_value());
+}
+
+TEST(ColumnTableTest, RejectsOverflowingCapacity) {
+    auto owner = shm_type::create(unique_shm_name(), 4096);
+    ASSERT_TRUE(owner.has_value());
+
+    const std::size_t huge = SIZE_MAX / 8;
+    EXPECT_EQ(ticks::required_size(huge), SIZE_MAX);
+    auto created = ticks::create(owner->get_memory(), huge);
+    ASSERT_FALSE(created.has_value());
+    EXPECT_EQ(created.error().code().value(), EINVAL);
+
+    /* A capacity rewritten in shared memory must not wrap the column offsets. */
+    ASSERT_TRUE(ticks::create(owner->get_memory(), 10).has_value());
+    const std::uint64_t corrupt = huge;
+    std::memcpy(owner->get_memory().data() + 2 * sizeof(std::uint64_t), &corrupt, sizeof(corrupt));
+    auto attached = ticks::attach(owner->get_memory());
+    ASSERT_FALSE(attached.has_value());
+    EXPECT_EQ(attached.error().code().value(), EPROTO);
+}
+
+TEST(ColumnKernelsTest, SumMinMaxCountAndFilter) {
+    std::vector<std::int32_t> values;
+    for (std::int32_t i = -10; i < 27; ++i) {
+        values.push_back(i);
+    }
+    const std::span<const std::int32_t> column(values);
+
+    EXPECT_EQ(shared_memory::sum(column), 296);
+
+    auto extremes = shared_memory::min_max(column);
+    ASSERT_TRUE(extremes.has_value());
+    EXPECT_EQ(extremes->min, -10);
+    EXPECT_EQ(extremes->max, 26);
+
+    EXPECT_EQ(shared_memory::count_if(column, [](std::int32_t v) { return v % 2 == 0; }), 19u);
+
+    std::vector<std::size_t> indices(4);
+    const auto written = shared_memory::filter(column, [](std::int32_t v) { return v > 20; }, std::span<std::size_t>(indices));
+    EXPECT_EQ(written, 4u);
+    EXPECT_EQ(indices[0], 31u);
+    EXPECT_EQ(indices[3], 34u);
+
+    EXPECT_FALSE(shared_memory::min_max(std::span<const double>{}).has_value());
+    EXPECT_DOUBLE_EQ(shared_memory::sum(std::span<const double>{}), 0.0);
+}
+
+} // namespace
@@ -46,6 +46,12 @@ TEST(ErrorTest, AllErrcValuesHaveDescriptions) {
     EXPECT_FALSE(shared_memory::error(shared_memory::errc::truncate_failed, code).message().empty());
     EXPECT_FALSE(shared_memory::error(shared_memory::errc::map_failed, code).message().empty());
     EXPECT_FALSE(shared_memory::error(shared_memory::errc::stat_failed, code).message().empty());
+    EXPECT_FALSE(shared_memory::error(shared_memory::errc::populate_failed, code).message().empty());
+    EXPECT_FALSE(shared_memory::error(shared_memory::errc::allocate_failed, code).message().empty());
+    EXPECT_FALSE(shared_memory::error(shared_memory::errc::wait_failed, code).message().empty());
+    EXPECT_FALSE(shared_memory::error(shared_memory::errc::layout_mismatch, code).message().empty());
+    EXPECT_FALSE(shared_memory::error(shared_memory::errc::write_failed, code).message().empty());
+    EXPECT_FALSE(shared_memory::error(shared_memory::errc::read_failed, code).message().empty());
 }
 
 } // namespace
@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+
+#include "shared_memory/incremental_checkpoint.hpp"
+#include "shared_memory/shared_memory.hpp"
+
+#include <filesystem>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+using shared_memory::dirty_tracking;
+using shared_memory::incremental_checkpoint;
+using shm_type = shared_memory::shared_memory;
+
+std::string unique_shm_name() {
+    static int counter = 0;
+    return "/shm_incremental_test_" + std::to_string(getpid()) + "_" + std::to_string(counter++);
+}
+
+std::filesystem::path unique_file_path() {
+    static int counter = 0;
+    return std::filesystem::temp_directory_path() / ("shm_incremental_test_" + std::to_string(getpid()) + "_" + std::to_string(counter++));
+}
+
+void round_trip(const dirty_tracking tracking) {
+    const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    auto segment = shm_type::create(unique_shm_name(), 64 * page + 100);
+    ASSERT_TRUE(segment.has_value());
+    auto memory = segment->get_memory();
+    std::ranges::fill(memory, std::byte{1});
+
+    const auto base = unique_file_path();
+    auto tracker = incremental_checkpoint::begin(*segment, base, tracking);
+    ASSERT_TRUE(tracker.has_value());
+    EXPECT_NE(tracker->tracking(), dirty_tracking::AUTO);
+
+    memory[3 * page + 5] = std::byte{2};
+    memory[4 * page] = std::byte{3};
+    memory[40 * page + 1] = std::byte{4};
+    memory[memory.size() - 1] = std::byte{5};
+
+    const auto first_delta = unique_file_path();
+    auto written = tracker->write_delta(first_delta);
+    ASSERT_TRUE(written.has_value());
+    EXPECT_EQ(*written, 4u);
+    EXPECT_EQ(tracker->sequence(), 1u);
+
+    memory[10 * page] = std::byte{6};
+    const auto second_delta = unique_file_path();
+    ASSERT_EQ(tracker->write_delta(second_delta).value(), 1u);
+
+    auto restored = shm_type::restore(base, unique_shm_name());
+    ASSERT_TRUE(restored.has_value());
+    EXPECT_EQ(incremental_checkpoint::apply_delta(*restored, first_delta).value(), 1u);
+    EXPECT_EQ(incremental_checkpoint::apply_delta(*restored, second_delta).value(), 2u);
+    EXPECT_TRUE(std::ranges::equal(restored->get_memory(), segment->get_memory()));
+
+    for (const auto& path : {base, first_delta, second_delta}) {
+        std::filesystem::remove(path);
+    }
+}
+
+TEST(IncrementalCheckpointTest, PageHashDeltasRestoreSegment) {
+    round_trip(dirty_tracking::PAGE_HASH);
+}
+
+TEST(IncrementalCheckpointTest, SoftDirtyDeltasRestoreSegment) {
+    if (!incremental_checkpoint::soft_dirty_supported()) {
+        auto segment = shm_type::create(unique_shm_name(), 4096);
+        ASSERT_TRUE(segment.has_value());
+        auto refused = incremental_checkpoint::begin(*segment, unique_file_path(), dirty_tracking::SOFT_DIRTY);
+        ASSERT_FALSE(refused.has_value());
+        EXPECT_EQ(refused.error().code().value(), ENOTSUP);
+        GTEST_SKIP() << "kernel does not track soft-dirty bits";
+    }
+    round_trip(dirty_tracking::SOFT_DIRTY);
+}
+
+TEST(IncrementalCheckpointTest, AutoTracksByPageHash) {
+    auto segment = shm_type::create(unique_shm_name(), 4096);
+    ASSERT_TRUE(segment.has_value());
+    const auto base = unique_file_path();
+    auto tracker = incremental_checkpoint::begin(*segment, base);
+    ASSERT_TRUE(tracker.has_value());
+    EXPECT_EQ(tracker->tracking(), dirty_tracking::PAGE_HASH);
+    std::filesystem::remove(base);
+}
+
+TEST(IncrementalCheckpointTest, SecondSoftDirtyTrackerIsRefused) {
+    if (!incremental_checkpoint::soft_dirty_supported()) {
+        GTEST_SKIP() << "kernel does not track soft-dirty bits";
+    }
+    auto segment = shm_type::create(unique_shm_name(), 4096);
+    ASSERT_TRUE(segment.has_value());
+    const auto first_base = unique_file_path();
+    const auto second_base = unique_file_path();
+    {
+        auto first = incremental_checkpoint::begin(*segment, first_base, dirty_tracking::SOFT_DIRTY);
+        ASSERT_TRUE(first.has_value());
+        auto second = incremental_checkpoint::begin(*segment, second_base, dirty_tracking::SOFT_DIRTY);
+        ASSERT_FALSE(second.has_value());
+        EXPECT_EQ(second.error().code().value(), EBUSY);
+
+        auto moved = std::move(*first);
+        EXPECT_FALSE(incremental_checkpoint::begin(*segment, second_base, dirty_tracking::SOFT_DIRTY).has_value());
+    }
+    EXPECT_TRUE(incremental_checkpoint::begin(*segment, second_base, dirty_tracking::SOFT_DIRTY).has_value());
+
+    std::filesystem::remove(first_base);
+    std::filesystem::remove(second_base);
+}
+
+void retry_after_failure(const dirty_tracking tracking) {
+    const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    auto segment = shm_type::create(unique_shm_name(), 16 * page);
+    ASSERT_TRUE(segment.has_value());
+    auto memory = segment->get_memory();
+
+    const auto base = unique_file_path();
+    auto tracker = incremental_checkpoint::begin(*segment, base, tracking);
+    ASSERT_TRUE(tracker.has_value());
+
+    memory[5 * page] = std::byte{7};
+    auto failed = tracker->write_delta("/nonexistent_dir/d1");
+    ASSERT_FALSE(failed.has_value());
+    EXPECT_EQ(failed.error().kind(), shared_memory::errc::open_failed);
+    EXPECT_EQ(tracker->sequence(), 0u);
+
+    const auto delta = unique_file_path();
+    ASSERT_EQ(tracker->write_delta(delta).value(), 1u);
+    EXPECT_EQ(tracker->sequence(), 1u);
+
+    auto restored = shm_type::restore(base, unique_shm_name());
+    ASSERT_TRUE(restored.has_value());
+    EXPECT_EQ(incremental_checkpoint::apply_delta(*restored, delta).value(), 1u);
+    EXPECT_EQ(restored->get_memory()[5 * page], std::byte{7});
+
+    const auto empty = unique_file_path();
+    EXPECT_EQ(tracker->write_delta(empty).value(), 0u);
+
+    for (const auto& path : {base, delta, empty}) {
+        std::filesystem::remove(path);
+    }
+}
+
+TEST(IncrementalCheckpointTest, FailedDeltaPagesCarryOverPageHash) {
+    retry_after_failure(dirty_tracking::PAGE_HASH);
+}
+
+TEST(IncrementalCheckpointTest, FailedDeltaPagesCarryOverSoftDirty) {
+    if (!incremental_checkpoint::soft_dirty_supported()) {
+        GTEST_SKIP() << "kernel does not track soft-dirty bits";
+    }
+    retry_after_failure(dirty_tracking::SOFT_DIRTY);
+}
+
+TEST(IncrementalCheckpointTest, EmptyDeltaWhenNothingChanged) {
+    auto segment = shm_type::create(unique_shm_name(), 16384);
+    ASSERT_TRUE(segment.has_value());
+
+    const auto base = unique_file_path();
+    auto tracker = incremental_checkpoint::begin(*segment, base, dirty_tracking::PAGE_HASH);
+    ASSERT_TRUE(tracker.has_value());
+
+    const auto delta = unique_file_path();
+    EXPECT_EQ(tracker->write_delta(delta).value(), 0u);
+    EXPECT_EQ(incremental_checkpoint::apply_delta(*segment, delta).value(), 1u);
+    std::filesystem::remove(base);
+    std::filesystem::remove(delta);
+}
+
+TEST(IncrementalCheckpointTest, ApplyRejectsForeignFiles) {
+    auto segment = shm_type::create(unique_shm_name(), 8192);
+    ASSERT_TRUE(segment.has_value());
+    auto other = shm_type::create(unique_shm_name(), 4096);
+    ASSERT_TRUE(other.has_value());
+
+    const auto base = unique_file_path();
+    auto tracker = incremental_checkpoint::begin(*segment, base, dirty_tracking::PAGE_HASH);
+    ASSERT_TRUE(tracker.has_value());
+    const auto delta = unique_file_path();
+    ASSERT_TRUE(tracker->write_delta(delta).has_value());
+
+    auto wrong_size = incremental_checkpoint::apply_delta(*other, delta);
+    ASSERT_FALSE(wrong_size.has_value());
+    EXPECT_EQ(wrong_size.error().kind(), shared_memory::errc::layout_mismatch);
+
+    auto not_a_delta = incremental_checkpoint::apply_delta(*segment, base);
+    ASSERT_FALSE(not_a_delta.has_value());
+    EXPECT_EQ(not_a_delta.error().kind(), shared_memory::errc::layout_mismatch);
+    std::filesystem::remove(base);
+    std::filesystem::remove(delta);
+}
+
+} // namespace
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include "shared_memory/intern_table.hpp"
+#include "shared_memory/shared_memory.hpp"
+
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+using shared_memory::intern_table;
+using shm_type = shared_memory::shared_memory;
+
+std::string unique_shm_name() {
+    static int counter = 0;
+    return "/shm_intern_test_" + std::to_string(getpid()) + "_" + std::to_string(counter++);
+}
+
+TEST(InternTableTest, InternAssignsStableIds) {
+    auto owner = shm_type::create(unique_shm_name(), intern_table::required_size(16, 1024));
+    ASSERT_TRUE(owner.has_value());
+
+    auto table = intern_table::create(owner->get_memory(), 16, 1024);
+    ASSERT_TRUE(table.has_value());
+
+    auto aapl = table->intern("AAPL");
+    auto msft = table->intern("MSFT");
+    ASSERT_TRUE(aapl.has_value());
+    ASSERT_TRUE(msft.has_value());
+    EXPECT_NE(*aapl, *msft);
+    EXPECT_EQ(table->intern("AAPL").value(), *aapl);
+
+    EXPECT_EQ(table->resolve(*aapl), "AAPL");
+    EXPECT_EQ(table->resolve(*msft), "MSFT");
+    EXPECT_EQ(table->find("MSFT"), *msft);
+    EXPECT_FALSE(table->find("GOOG").has_value());
+    EXPECT_EQ(table->size(), 2u);
+}
+
+TEST(InternTableTest, AttachedTableSeesSameIds) {
+    const std::string name = unique_shm_name();
+    auto owner = shm_type::create(name, intern_table::required_size(16, 1024));
+    ASSERT_TRUE(owner.has_value());
+    auto writer = intern_table::create(owner->get_memory(), 16, 1024);
+    ASSERT_TRUE(writer.has_value());
+    const auto id = writer->intern("ACCOUNT-42").value();
+
+    auto mapping = shm_type::open(name);
+    ASSERT_TRUE(mapping.has_value());
+    auto reader = intern_table::attach(mapping->get_memory());
+    ASSERT_TRUE(reader.has_value());
+
+    EXPECT_EQ(reader->find("ACCOUNT-42"), id);
+    EXPECT_EQ(reader->resolve(id), "ACCOUNT-42");
+    EXPECT_EQ(reader->intern("ACCOUNT-43").value(), id + 1);
+    EXPECT_EQ(writer->find("ACCOUNT-43"), id + 1);
+}
+
+TEST(InternTableTest, ReportsExhaustion) {
+    auto owner = shm_type::create(unique_shm_name(), intern_table::required_size(2, 8));
+    ASSERT_TRUE(owner.has_value());
+    auto table = intern_table::create(owner->get_memory(), 2, 8);
+    ASSERT_TRUE(table.has_value());
+
+    ASSERT_TRUE(table->intern("abcd").has_value());
+    auto too_long = table->intern("efghijk");
+    ASSERT_FALSE(too_long.has_value());
+    EXPECT_EQ(too_long.error().kind(), shared_memory::errc::allocate_failed);
+
+    auto out_of_ids = table->intern("x");
+    ASSERT_FALSE(out_of_ids.has_value());
+    EXPECT_EQ(out_of_ids.error().code().value(), ENOSPC);
+}
+
+TEST(InternTableTest, AttachRejectsUnformattedRegion) {
+    auto owner = shm_type::create(unique_shm_name(), 4096);
+    ASSERT_TRUE(owner.has_value());
+
+    auto table = intern_table::attach(owner->get_memory());
+    ASSERT_FALSE(table.has_value());
+    EXPECT_EQ(table.error().kind(), shared_memory::errc::layout_mismatch);
+}
+
+TEST(InternTableTest, ConcurrentInternersAgreeOnIds) {
+    constexpr int strings = 500;
+    auto owner = shm_type::create(unique_shm_name(), intern_table::required_size(4 * strings, 64 * strings));
+    ASSERT_TRUE(owner.has_value());
+    auto table = intern_table::create(owner->get_memory(), 4 * strings, 64 * strings);
+    ASSERT_TRUE(table.has_value());
+
+    std::vector<std::vector<std::uint32_t>> ids(4, std::vector<std::uint32_t>(strings));
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&, t] {
+            for (int i = 0; i < strings; ++i) {
+                ids[t][i] = table->intern("SYM" + std::to_string(i)).value();
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    std::set<std::uint32_t> distinct;
+    for (int i = 0; i < strings; ++i) {
+        for (int t = 1; t < 4; ++t) {
+            EXPECT_EQ(ids[t][i], ids[0][i]);
+        }
+        distinct.insert(ids[0][i]);
+        EXPECT_EQ(table->resolve(ids[0][i]), "SYM" + std::to_string(i));
+    }
+    EXPECT_EQ(distinct.size(), static_cast<std::size_t>(strings));
+}
+
+} // namespace
@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+
+#include "shared_memory/lazy_restore.hpp"
+#include "shared_memory/shared_memory.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+using shared_memory::errc;
+using shared_memory::lazy_restore;
+using shm_type = shared_memory::shared_memory;
+
+std::string unique_shm_name() {
+    static int counter = 0;
+    return "/shm_lazy_restore_test_" + std::to_string(getpid()) + "_" + std::to_string(counter++);
+}
+
+std::filesystem::path unique_file_path() {
+    static int counter = 0;
+    return std::filesystem::temp_directory_path() / ("shm_lazy_restore_test_" + std::to_string(getpid()) + "_" + std::to_string(counter++));
+}
+
+std::filesystem::path write_checkpoint(const std::size_t size) {
+    auto source = shm_type::create(unique_shm_name(), size);
+    EXPECT_TRUE(source.has_value());
+    auto memory = source->get_memory();
+    for (std::size_t i = 0; i < memory.size(); ++i) {
+        memory[i] = static_cast<std::byte>((i * 31 + i / 4096) & 0xff);
+    }
+
+    const auto path = unique_file_path();
+    EXPECT_TRUE(source->checkpoint(path).has_value());
+    return path;
+}
+
+bool matches_pattern(std::span<const std::byte> memory) {
+    for (std::size_t i = 0; i < memory.size(); ++i) {
+        if (memory[i] != static_cast<std::byte>((i * 31 + i / 4096) & 0xff)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+TEST(LazyRestoreTest, RestoresEveryPage) {
+    const auto path = write_checkpoint((8u << 20) + 123);
+
+    auto restore = lazy_restore::start(path, unique_shm_name());
+    ASSERT_TRUE(restore.has_value()) ;
+    ASSERT_EQ(restore->segment().size(), (8u << 20) + 123);
+    ASSERT_TRUE(restore->wait().has_value());
+    EXPECT_TRUE(restore->complete());
+    EXPECT_TRUE(matches_pattern(restore->segment().get_memory()));
+
+    std::filesystem::remove(path);
+}
+
+TEST(LazyRestoreTest, ConcurrentReadersSeeCheckpointBeforeCompletion) {
+    const auto path = write_checkpoint(32u << 20);
+
+    auto restore = lazy_restore::start(path, unique_shm_name());
+    ASSERT_TRUE(restore.has_value()) ;
+    const auto memory = restore->segment().get_memory();
+
+    /* Readers start at the tail, ahead of the streaming thread. */
+    std::vector<std::thread> readers;
+    std::vector<int> ok(4, 0);
+    for (std::size_t t = 0; t < ok.size(); ++t) {
+        readers.emplace_back([&, t] {
+            const auto slice = memory.size() / ok.size();
+            const auto begin = memory.size() - (t + 1) * slice;
+            bool good = true;
+            for (std::size_t i = begin + slice; i > begin; i -= 4096) {
+                const auto at = i - 1;
+                good = good && memory[at] == static_cast<std::byte>((at * 31 + at / 4096) & 0xff);
+            }
+            ok[t] = good ? 1 : 0;
+        });
+    }
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_TRUE(std::ranges::all_of(ok, [](const int v) { return v == 1; }));
+    ASSERT_TRUE(restore->wait().has_value());
+    EXPECT_TRUE(matches_pattern(memory));
+
+    std::filesystem::remove(path);
+}
+
+TEST(LazyRestoreTest, WritesBeforeCompletionAreKept) {
+    const auto path = write_checkpoint(16u << 20);
+
+    auto restore = lazy_restore::start(path, unique_shm_name());
+    ASSERT_TRUE(restore.has_value()) ;
+    auto memory = restore->segment().get_memory();
+    memory[memory.size() - 1] = std::byte{0x5a};
+
+    ASSERT_TRUE(restore->wait().has_value());
+    EXPECT_EQ(memory[memory.size() - 1], std::byte{0x5a});
+    EXPECT_TRUE(matches_pattern(memory.first(memory.size() - 1)));
+
+    std::filesystem::remove(path);
+}
+
+TEST(LazyRestoreTest, SegmentIsVisibleToOtherHandlesAfterWait) {
+    const auto path = write_checkpoint(1u << 20);
+    const auto name = unique_shm_name();
+
+    auto restore = lazy_restore::start(path, name);
+    ASSERT_TRUE(restore.has_value()) ;
+    ASSERT_TRUE(restore->wait().has_value());
+
+    auto attached = shm_type::open(name);
+    ASSERT_TRUE(attached.has_value());
+    EXPECT_TRUE(matches_pattern(attached->get_memory()));
+
+    std::filesystem::remove(path);
+}
+
+TEST(LazyRestoreTest, DestructionWaitsForStreaming) {
+    const auto path = write_checkpoint(16u << 20);
+    const auto name = unique_shm_name();
+
+    {
+        shared_memory::restore_options options;
+        options.segment.should_unlink = false;
+        auto restore = lazy_restore::start(path, name, options);
+        ASSERT_TRUE(restore.has_value()) ;
+    }
+
+    auto attached = shm_type::open(name);
+    ASSERT_TRUE(attached.has_value());
+    EXPECT_TRUE(matches_pattern(attached->get_memory()));
+    shm_unlink(name.c_str());
+
+    std::filesystem::remove(path);
+}
+
+TEST(LazyRestoreTest, HolesInCheckpointStayUnpopulated) {
+    const auto source_name = unique_shm_name();
+    auto source = shm_type::create(source_name, 64u << 20);
+    ASSERT_TRUE(source.has_value());
+    source->get_memory()[4096 * 3] = std::byte{9};
+    source->get_memory()[(40u << 20) + 1] = std::byte{8};
+    const auto path = unique_file_path();
+    ASSERT_TRUE(source->checkpoint(path).has_value());
+
+    const auto name = unique_shm_name();
+    auto restore = lazy_restore::start(path, name);
+    ASSERT_TRUE(restore.has_value());
+    ASSERT_TRUE(restore->wait().has_value());
+
+    struct stat st{};
+    ASSERT_EQ(::stat(("/dev/shm" + name).c_str(), &st), 0);
+    EXPECT_LT(static_cast<std::size_t>(st.st_blocks) * 512, std::size_t{1} << 20);
+    EXPECT_TRUE(std::ranges::equal(restore->segment().get_memory(), source->get_memory()));
+
+    std::filesystem::remove(path);
+}
+
+TEST(LazyRestoreTest, RejectsReadOnlySegment) {
+    const auto path = write_checkpoint(4096);
+
+    shared_memory::restore_options options;
+    options.segment.mode = shared_memory::access_mode::READ;
+    auto restore = lazy_restore::start(path, unique_shm_name(), options);
+    ASSERT_FALSE(restore.has_value());
+    EXPECT_EQ(restore.error().kind(), errc::open_failed);
+    EXPECT_EQ(restore.error().code().value(), EINVAL);
+
+    std::filesystem::remove(path);
+}
+
+TEST(LazyRestoreTest, MissingFileFails) {
+    auto restore = lazy_restore::start(unique_file_path(), unique_shm_name());
+    ASSERT_FALSE(restore.has_value());
+}
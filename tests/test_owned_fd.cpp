@@ -1,6 +1,6 @@
 #include <gtest/gtest.h>
 
-#include "owned_fd.hpp"
+#include "shared_memory/owned_fd.hpp"
 
 #include <fcntl.h>
 #include <unistd.h>
@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+
+#include "shared_memory/persistent_segment.hpp"
+#include "shared_memory/shared_memory.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+using namespace std::chrono_literals;
+using shared_memory::persistent_segment;
+using shared_memory::sync_policy;
+using shm_type = shared_memory::shared_memory;
+
+std::filesystem::path unique_file_path() {
+    static int counter = 0;
+    return std::filesystem::temp_directory_path() / ("shm_persistent_test_" + std::to_string(getpid()) + "_" + std::to_string(counter++));
+}
+
+bool eventually(const auto& predicate) {
+    for (int i = 0; i < 500; ++i) {
+        if (predicate()) {
+            return true;
+        }
+        std::this_thread::sleep_for(10ms);
+    }
+    return predicate();
+}
+
+} // namespace
+
+TEST(MapFileTest, CreatesExtendsAndPersistsFile) {
+    const auto path = unique_file_path();
+    {
+        auto mapped = shm_type::map_file(path, 10'000);
+        ASSERT_TRUE(mapped.has_value());
+        EXPECT_EQ(mapped->size(), 10'000u);
+        mapped->get_memory()[9'999] = std::byte{0x42};
+    }
+    EXPECT_EQ(std::filesystem::file_size(path), 10'000u);
+
+    /* Size 0 maps what is there; a larger size extends the file. */
+    auto whole = shm_type::map_file(path);
+    ASSERT_TRUE(whole.has_value());
+    EXPECT_EQ(whole->size(), 10'000u);
+    EXPECT_EQ(whole->get_memory()[9'999], std::byte{0x42});
+
+    auto grown = shm_type::map_file(path, 20'000);
+    ASSERT_TRUE(grown.has_value());
+    EXPECT_EQ(std::filesystem::file_size(path), 20'000u);
+    EXPECT_EQ(grown->get_memory()[9'999], std::byte{0x42});
+
+    std::filesystem::remove(path);
+}
+
+TEST(MapFileTest, ReportsFailures) {
+    shared_memory::file_options options;
+    options.create = false;
+    auto missing = shm_type::map_file(unique_file_path(), 4096, options);
+    ASSERT_FALSE(missing.has_value());
+    EXPECT_EQ(missing.error().kind(), shared_memory::errc::open_failed);
+    EXPECT_EQ(missing.error().code().value(), ENOENT);
+
+    const auto path = unique_file_path();
+    auto empty = shm_type::map_file(path);
+    ASSERT_FALSE(empty.has_value());
+    EXPECT_EQ(empty.error().kind(), shared_memory::errc::map_failed);
+    std::filesystem::remove(path);
+}
+
+TEST(PersistentSegmentTest, BarrierFlushesMarkedRanges) {
+    const auto path = unique_file_path();
+    const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    auto segment = persistent_segment::open(path, 256 * page, {}, sync_policy{0ms, 0});
+    ASSERT_TRUE(segment.has_value());
+
+    const std::vector<std::byte> data(3 * page, std::byte{7});
+    ASSERT_TRUE(segment->write(page / 2, data));
+    segment->mark_dirty(200 * page, 1);
+    EXPECT_EQ(segment->dirty_bytes(), 5 * page);
+
+    /* Re-marking pages already dirty adds nothing. */
+    segment->mark_dirty(page, page);
+    EXPECT_EQ(segment->dirty_bytes(), 5 * page);
+
+    ASSERT_TRUE(segment->barrier().has_value());
+    EXPECT_EQ(segment->dirty_bytes(), 0u);
+
+    EXPECT_FALSE(segment->write(256 * page - 1, data));
+    segment->mark_dirty(1000 * page, page);
+    EXPECT_EQ(segment->dirty_bytes(), 0u);
+
+    std::filesystem::remove(path);
+}
+
+TEST(PersistentSegmentTest, ThresholdTriggersBackgroundFlush) {
+    const auto path = unique_file_path();
+    const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    auto segment = persistent_segment::open(path, 64 * page, {}, sync_policy{0ms, 8 * page});
+    ASSERT_TRUE(segment.has_value());
+
+    segment->mark_dirty(0, 4 * page);
+    std::this_thread::sleep_for(50ms);
+    EXPECT_EQ(segment->dirty_bytes(), 4 * page);
+
+    segment->mark_dirty(16 * page, 4 * page);
+    EXPECT_TRUE(eventually([&] { return segment->dirty_bytes() == 0; }));
+
+    std::filesystem::remove(path);
+}
+
+TEST(PersistentSegmentTest, IntervalFlushesPeriodically) {
+    const auto path = unique_file_path();
+    auto segment = persistent_segment::open(path, 1 << 20, {}, sync_policy{5ms, 0});
+    ASSERT_TRUE(segment.has_value());
+
+    segment->mark_dirty(12'345, 100);
+    EXPECT_TRUE(eventually([&] { return segment->dirty_bytes() == 0; }));
+
+    std::filesystem::remove(path);
+}
+
+TEST(PersistentSegmentTest, ConcurrentWritersAreAllFlushed) {
+    const auto path = unique_file_path();
+    const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    {
+        auto segment = persistent_segment::open(path, 1024 * page, {}, sync_policy{1ms, 16 * page});
+        ASSERT_TRUE(segment.has_value());
+
+        std::vector<std::thread> writers;
+        for (std::size_t t = 0; t < 4; ++t) {
+            writers.emplace_back([&, t] {
+                for (std::size_t i = t; i < 1024; i += 4) {
+                    const std::byte value{static_cast<unsigned char>(i)};
+                    ASSERT_TRUE(segment->write(i * page, std::span(&value, 1)));
+                }
+            });
+        }
+        for (auto& writer : writers) {
+            writer.join();
+        }
+        ASSERT_TRUE(segment->barrier().has_value());
+        EXPECT_EQ(segment->dirty_bytes(), 0u);
+    }
+
+    auto reopened = shm_type::map_file(path);
+    ASSERT_TRUE(reopened.has_value());
+    for (std::size_t i = 0; i < 1024; ++i) {
+        EXPECT_EQ(reopened->get_memory()[i * page], std::byte{static_cast<unsigned char>(i)});
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST(PersistentSegmentTest, RejectsReadOnlyMode) {
+    shared_memory::file_options options;
+    options.mode = shared_memory::access_mode::READ;
+    auto segment = persistent_segment::open(unique_file_path(), 4096, options);
+    ASSERT_FALSE(segment.has_value());
+    EXPECT_EQ(segment.error().kind(), shared_memory::errc::open_failed);
+}
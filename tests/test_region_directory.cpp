@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include "shared_memory/region_directory.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+using namespace std::chrono_literals;
+using shared_memory::region_directory;
+using shared_memory::region_layout;
+using shared_memory::segment_name;
+
+segment_name unique_shm_name() {
+    static int counter = 0;
+    return *segment_name::make("/shm_region_test_" + std::to_string(getpid()) + "_" + std::to_string(counter++));
+}
+
+TEST(RegionLayoutTest, AssignsAlignedOffsets) {
+    region_layout layout;
+    ASSERT_TRUE(layout.add("counters", 10).has_value());
+    ASSERT_TRUE(layout.add("ring", 4096, 4096).has_value());
+    ASSERT_TRUE(layout.add("map", 100).has_value());
+
+    const auto entries = layout.entries();
+    ASSERT_EQ(entries.size(), 3u);
+    EXPECT_EQ(entries[0].offset % 64, 0u);
+    EXPECT_EQ(entries[1].offset % 4096, 0u);
+    EXPECT_GE(entries[1].offset, entries[0].offset + entries[0].size);
+    EXPECT_EQ(entries[2].offset % 64, 0u);
+    EXPECT_EQ(layout.segment_size(), entries[2].offset + entries[2].size);
+}
+
+TEST(RegionLayoutTest, RejectsInvalidRegions) {
+    region_layout layout;
+    ASSERT_TRUE(layout.add("a", 8).has_value());
+
+    EXPECT_EQ(layout.add("a", 8).error().code().value(), EEXIST);
+    EXPECT_EQ(layout.add("", 8).error().code().value(), EINVAL);
+    EXPECT_EQ(layout.add(std::string_view("b\0c", 3), 8).error().code().value(), EINVAL);
+    EXPECT_EQ(layout.add(std::string(48, 'x'), 8).error().code().value(), ENAMETOOLONG);
+    EXPECT_EQ(layout.add("b", 8, 48).error().code().value(), EINVAL);
+    EXPECT_EQ(layout.count(), 1u);
+}
+
+TEST(RegionDirectoryTest, CreateAndOpenShareRegions) {
+    region_layout layout;
+    ASSERT_TRUE(layout.add("counters", 64).has_value());
+    ASSERT_TRUE(layout.add("ring", 8192, 4096).has_value());
+
+    const auto name = unique_shm_name();
+    auto creator = region_directory::create(name, layout, [](region_directory& directory) {
+        std::memcpy(directory.find("ring").data(), "ring", 4);
+    });
+    ASSERT_TRUE(creator.has_value());
+    EXPECT_EQ(creator->count(), 2u);
+
+    auto reader = region_directory::open(name, 100ms);
+    ASSERT_TRUE(reader.has_value());
+    EXPECT_EQ(reader->count(), 2u);
+
+    auto ring = reader->find("ring");
+    ASSERT_EQ(ring.size(), 8192u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(ring.data()) % 4096, 0u);
+    EXPECT_EQ(0, std::memcmp(ring.data(), "ring", 4));
+
+    reader->find("counters")[0] = std::byte{9};
+    EXPECT_EQ(creator->find("counters")[0], std::byte{9});
+}
+
+TEST(RegionDirectoryTest, FindMissingRegionReturnsEmpty) {
+    region_layout layout;
+    ASSERT_TRUE(layout.add("only", 16).has_value());
+
+    shared_memory::create_options options{};
+    auto directory = region_directory::create(unique_shm_name(), layout, options);
+    ASSERT_TRUE(directory.has_value());
+    EXPECT_TRUE(directory->find("missing").empty());
+}
+
+TEST(RegionDirectoryTest, OpenRejectsForeignSegment) {
+    const auto name = unique_shm_name();
+    auto other = shared_memory::create_published(name, 64, 1, [](std::span<std::byte>) {});
+    ASSERT_TRUE(other.has_value());
+
+    auto directory = region_directory::open(name, 10ms);
+    ASSERT_FALSE(directory.has_value());
+    EXPECT_EQ(directory.error().kind(), shared_memory::errc::layout_mismatch);
+}
+
+} // namespace
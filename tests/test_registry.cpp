@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include "shared_memory/registry.hpp"
+#include "shared_memory/shared_memory.hpp"
+
+#include <string>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+
+using shm_type = shared_memory::shared_memory;
+using shared_memory::registry;
+
+std::string unique_shm_name() {
+    static int counter = 0;
+    return "/shm_registry_test_" + std::to_string(getpid()) + "_" + std::to_string(counter++);
+}
+
+TEST(RegistryTest, RepeatedOpenSharesMapping) {
+    const std::string name = unique_shm_name();
+    auto owner = shm_type::create(name, 4096);
+    ASSERT_TRUE(owner.has_value());
+
+    auto first = registry::instance().open(name);
+    auto second = registry::instance().open(name);
+    ASSERT_TRUE(first.has_value());
+    ASSERT_TRUE(second.has_value());
+
+    EXPECT_EQ(first->get(), second->get());
+    EXPECT_EQ((*first)->get_memory().data(), (*second)->get_memory().data());
+    EXPECT_EQ((*first)->size(), 4096u);
+}
+
+TEST(RegistryTest, NamesWithAndWithoutSlashShareMapping) {
+    const std::string name = unique_shm_name();
+    auto owner = shm_type::create(name, 4096);
+    ASSERT_TRUE(owner.has_value());
+
+    auto slashed = registry::instance().open(name);
+    auto bare = registry::instance().open(name.substr(1));
+    ASSERT_TRUE(slashed.has_value());
+    ASSERT_TRUE(bare.has_value());
+    EXPECT_EQ(slashed->get(), bare->get());
+
+    registry::instance().evict(name.substr(1));
+    auto fresh = registry::instance().open(name);
+    ASSERT_TRUE(fresh.has_value());
+    EXPECT_NE(fresh->get(), slashed->get());
+}
+
+TEST(RegistryTest, LastHandleReleasesMapping) {
+    const std::string name = unique_shm_name();
+    auto owner = shm_type::create(name, 4096);
+    ASSERT_TRUE(owner.has_value());
+
+    const auto live_before = registry::instance().size();
+    {
+        auto handle = registry::instance().open(name);
+        ASSERT_TRUE(handle.has_value());
+        EXPECT_EQ(registry::instance().size(), live_before + 1);
+    }
+    EXPECT_EQ(registry::instance().size(), live_before);
+
+    auto reopened = registry::instance().open(name);
+    ASSERT_TRUE(reopened.has_value());
+    EXPECT_EQ((*reopened)->size(), 4096u);
+}
+
+TEST(RegistryTest, EvictForcesFreshAttach) {
+    const std::string name = unique_shm_name();
+    auto owner = shm_type::create(name, 4096);
+    ASSERT_TRUE(owner.has_value());
+
+    auto first = registry::instance().open(name);
+    ASSERT_TRUE(first.has_value());
+
+    registry::instance().evict(name);
+
+    auto second = registry::instance().open(name);
+    ASSERT_TRUE(second.has_value());
+    EXPECT_NE(first->get(), second->get());
+}
+
+TEST(RegistryTest, OpenNonExistentFails) {
+    auto result = registry::instance().open("/nonexistent_shm_registry_segment_12345");
+    EXPECT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().kind(), shared_memory::errc::open_failed);
+}
+
+} // namespace
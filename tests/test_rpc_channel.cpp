@@ -0,0 +1,311 @@
+#include <gtest/gtest.h>
+
+#include "shared_memory/rpc_channel.hpp"
+#include "shared_memory/shared_memory.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+using namespace std::chrono_literals;
+using shared_memory::errc;
+using shared_memory::rpc_channel;
+using shared_memory::rpc_client;
+using shm_type = shared_memory::shared_memory;
+
+std::string unique_shm_name() {
+    static int counter = 0;
+    return "/shm_rpc_test_" + std::to_string(getpid()) + "_" + std::to_string(counter++);
+}
+
+/* Replies with the request bytes reversed. */
+std::size_t reverse_handler(std::span<const std::byte> request, std::span<std::byte> response) {
+    std::ranges::reverse_copy(request, response.begin());
+    return request.size();
+}
+
+std::span<const std::byte> as_bytes(const std::string& text) {
+    return std::as_bytes(std::span(text));
+}
+
+} // namespace
+
+TEST(RpcChannelTest, CallRoundTripsThroughServer) {
+    auto owner = shm_type::create(unique_shm_name(), rpc_channel::required_size(4, 256));
+    ASSERT_TRUE(owner.has_value());
+    auto channel = rpc_channel::create(owner->get_memory(), 4, 256);
+    ASSERT_TRUE(channel.has_value());
+
+    std::atomic<bool> stop{false};
+    std::thread server([&] {
+        auto attached = rpc_channel::attach(owner->get_memory());
+        ASSERT_TRUE(attached.has_value());
+        while (!stop.load()) {
+            if (attached->serve(reverse_handler) == 0) {
+                (void)attached->wait_for_requests(10ms);
+            }
+        }
+    });
+
+    auto client = channel->connect();
+    ASSERT_TRUE(client.has_value());
+    std::array<std::byte, 256> response{};
+    const std::string request = "hello";
+    auto length = client->call(as_bytes(request), response);
+    ASSERT_TRUE(length.has_value());
+    EXPECT_EQ(std::string(reinterpret_cast<const char *>(response.data()), *length), "olleh");
+
+    stop.store(true);
+    server.join();
+}
+
+TEST(RpcChannelTest, ManyClientsWithSleepingServer) {
+    constexpr std::size_t clients = 8;
+    constexpr int calls = 2000;
+    auto owner = shm_type::create(unique_shm_name(), rpc_channel::required_size(clients, 64));
+    ASSERT_TRUE(owner.has_value());
+    auto channel = rpc_channel::create(owner->get_memory(), clients, 64);
+    ASSERT_TRUE(channel.has_value());
+
+    std::atomic<bool> stop{false};
+    std::atomic<std::size_t> served{0};
+    std::vector<std::thread> servers;
+    for (int s = 0; s < 2; ++s) {
+        servers.emplace_back([&] {
+            while (!stop.load()) {
+                if (channel->wait_for_requests(5ms)) {
+                    served += channel->serve([](std::span<const std::byte> request, std::span<std::byte> response) {
+                        std::uint64_t value = 0;
+                        std::memcpy(&value, request.data(), sizeof(value));
+                        value = value * 2 + 1;
+                        std::memcpy(response.data(), &value, sizeof(value));
+                        return sizeof(value);
+                    });
+                }
+            }
+        });
+    }
+
+    std::vector<std::thread> callers;
+    for (std::size_t c = 0; c < clients; ++c) {
+        callers.emplace_back([&, c] {
+            auto client = channel->connect();
+            ASSERT_TRUE(client.has_value());
+            for (int i = 0; i < calls; ++i) {
+                const std::uint64_t value = c * 1'000'000 + static_cast<std::uint64_t>(i);
+                std::uint64_t result = 0;
+                auto length = client->call(std::as_bytes(std::span(&value, 1)), std::as_writable_bytes(std::span(&result, 1)), 5s);
+                ASSERT_TRUE(length.has_value());
+                ASSERT_EQ(*length, sizeof(result));
+                ASSERT_EQ(result, value * 2 + 1);
+            }
+        });
+    }
+    for (auto& caller : callers) {
+        caller.join();
+    }
+    stop.store(true);
+    for (auto& server : servers) {
+        server.join();
+    }
+    EXPECT_EQ(served.load(), clients * calls);
+}
+
+TEST(RpcChannelTest, SlotsAreClaimedAndReleased) {
+    auto owner = shm_type::create(unique_shm_name(), rpc_channel::required_size(2, 64));
+    ASSERT_TRUE(owner.has_value());
+    auto channel = rpc_channel::create(owner->get_memory(), 2, 64);
+    ASSERT_TRUE(channel.has_value());
+
+    auto first = channel->connect();
+    auto second = channel->connect();
+    ASSERT_TRUE(first.has_value() && second.has_value());
+    EXPECT_NE(first->slot(), second->slot());
+
+    auto third = channel->connect();
+    ASSERT_FALSE(third.has_value());
+    EXPECT_EQ(third.error().kind(), errc::allocate_failed);
+    EXPECT_EQ(third.error().code().value(), ENOSPC);
+
+    *first = rpc_client{};
+    auto reused = channel->connect();
+    ASSERT_TRUE(reused.has_value());
+}
+
+TEST(RpcChannelTest, TimeoutLeavesCallInFlightUntilAnswered) {
+    auto owner = shm_type::create(unique_shm_name(), rpc_channel::required_size(1, 64));
+    ASSERT_TRUE(owner.has_value());
+    auto channel = rpc_channel::create(owner->get_memory(), 1, 64);
+    ASSERT_TRUE(channel.has_value());
+    auto client = channel->connect();
+    ASSERT_TRUE(client.has_value());
+
+    std::array<std::byte, 64> response{};
+    const std::string first = "first";
+    auto timed_out = client->call(as_bytes(first), response, 1ms);
+    ASSERT_FALSE(timed_out.has_value());
+    EXPECT_EQ(timed_out.error().kind(), errc::wait_failed);
+    EXPECT_EQ(timed_out.error().code().value(), ETIMEDOUT);
+
+    /* The stale request is answered first and discarded by the next call. */
+    EXPECT_EQ(channel->serve(reverse_handler), 1u);
+    std::thread server([&] {
+        while (channel->serve(reverse_handler) == 0) {
+            (void)channel->wait_for_requests(1ms);
+        }
+    });
+    const std::string second = "ab";
+    auto length = client->call(as_bytes(second), response, 5s);
+    server.join();
+    ASSERT_TRUE(length.has_value());
+    EXPECT_EQ(std::string(reinterpret_cast<const char *>(response.data()), *length), "ba");
+}
+
+TEST(RpcChannelTest, ThrowingHandlerFailsTheCall) {
+    auto owner = shm_type::create(unique_shm_name(), rpc_channel::required_size(1, 64));
+    ASSERT_TRUE(owner.has_value());
+    auto channel = rpc_channel::create(owner->get_memory(), 1, 64);
+    ASSERT_TRUE(channel.has_value());
+    auto client = channel->connect();
+    ASSERT_TRUE(client.has_value());
+
+    std::thread server([&] {
+        while (!channel->wait_for_requests(1ms)) {
+        }
+        EXPECT_THROW(channel->serve([](std::span<const std::byte>, std::span<std::byte>) -> std::size_t {
+            throw std::runtime_error("handler failed");
+        }), std::runtime_error);
+    });
+
+    std::array<std::byte, 64> response{};
+    const std::string request = "boom";
+    auto failed = client->call(as_bytes(request), response, 5s);
+    server.join();
+    ASSERT_FALSE(failed.has_value());
+    EXPECT_EQ(failed.error().kind(), errc::read_failed);
+    EXPECT_EQ(failed.error().code().value(), EREMOTEIO);
+
+    /* The slot is usable again. */
+    std::thread retry([&] {
+        while (channel->serve(reverse_handler) == 0) {
+            (void)channel->wait_for_requests(1ms);
+        }
+    });
+    auto length = client->call(as_bytes(request), response, 5s);
+    retry.join();
+    ASSERT_TRUE(length.has_value());
+    EXPECT_EQ(std::string(reinterpret_cast<const char *>(response.data()), *length), "moob");
+}
+
+TEST(RpcChannelTest, AbandonedCallFreesSlotAfterServerFinishes) {
+    auto owner = shm_type::create(unique_shm_name(), rpc_channel::required_size(1, 64));
+    ASSERT_TRUE(owner.has_value());
+    auto channel = rpc_channel::create(owner->get_memory(), 1, 64);
+    ASSERT_TRUE(channel.has_value());
+
+    {
+        auto client = channel->connect();
+        ASSERT_TRUE(client.has_value());
+        std::array<std::byte, 64> response{};
+        const std::string request = "late";
+        ASSERT_FALSE(client->call(as_bytes(request), response, 0ns).has_value());
+
+        /* The server picks the request up while the client goes away. */
+        EXPECT_EQ(channel->serve([&](std::span<const std::byte> in, std::span<std::byte> out) {
+            *client = rpc_client{};
+            return reverse_handler(in, out);
+        }), 1u);
+    }
+
+    EXPECT_TRUE(channel->connect().has_value());
+}
+
+TEST(RpcChannelTest, RejectsOversizedMessages) {
+    auto owner = shm_type::create(unique_shm_name(), rpc_channel::required_size(1, 8));
+    ASSERT_TRUE(owner.has_value());
+    auto channel = rpc_channel::create(owner->get_memory(), 1, 8);
+    ASSERT_TRUE(channel.has_value());
+    auto client = channel->connect();
+    ASSERT_TRUE(client.has_value());
+
+    std::array<std::byte, 4> small{};
+    const std::string too_long = "0123456789";
+    auto oversized = client->call(as_bytes(too_long), small);
+    ASSERT_FALSE(oversized.has_value());
+    EXPECT_EQ(oversized.error().kind(), errc::allocate_failed);
+    EXPECT_EQ(oversized.error().code().value(), EMSGSIZE);
+
+    std::thread server([&] {
+        while (channel->serve(reverse_handler) == 0) {
+            (void)channel->wait_for_requests(1ms);
+        }
+    });
+    const std::string request = "012345";
+    auto truncated = client->call(as_bytes(request), small, 5s);
+    server.join();
+    ASSERT_FALSE(truncated.has_value());
+    EXPECT_EQ(truncated.error().kind(), errc::read_failed);
+}
+
+TEST(RpcChannelTest, CreateAndAttachValidateRegion) {
+    auto owner = shm_type::create(unique_shm_name(), rpc_channel::required_size(2, 64));
+    ASSERT_TRUE(owner.has_value());
+
+    EXPECT_EQ(rpc_channel::create(owner->get_memory(), 0, 64).error().code().value(), EINVAL);
+    EXPECT_EQ(rpc_channel::create(owner->get_memory(), 4, 64).error().code().value(), ENOSPC);
+    EXPECT_EQ(rpc_channel::attach(owner->get_memory()).error().code().value(), EPROTO);
+
+    ASSERT_TRUE(rpc_channel::create(owner->get_memory(), 2, 64).has_value());
+    auto attached = rpc_channel::attach(owner->get_memory());
+    ASSERT_TRUE(attached.has_value());
+    EXPECT_EQ(attached->clients(), 2u);
+    EXPECT_EQ(attached->slot_capacity(), 64u);
+}
+
+TEST(RpcChannelTest, RejectsOverflowingLayouts) {
+    auto owner = shm_type::create(unique_shm_name(), rpc_channel::required_size(2, 64));
+    ASSERT_TRUE(owner.has_value());
+
+    const std::size_t huge = SIZE_MAX / 64;
+    EXPECT_EQ(rpc_channel::required_size(huge, 64), SIZE_MAX);
+    EXPECT_EQ(rpc_channel::create(owner->get_memory(), huge, 64).error().code().value(), EINVAL);
+
+    /* A client count rewritten in shared memory must not wrap the size check. */
+    ASSERT_TRUE(rpc_channel::create(owner->get_memory(), 2, 64).has_value());
+    const std::uint64_t corrupt = huge;
+    std::memcpy(owner->get_memory().data() + sizeof(std::uint64_t), &corrupt, sizeof(corrupt));
+    EXPECT_EQ(rpc_channel::attach(owner->get_memory()).error().code().value(), EPROTO);
+}
+
+TEST(RpcChannelTest, ServerClampsClientRequestLength) {
+    auto owner = shm_type::create(unique_shm_name(), rpc_channel::required_size(1, 64));
+    ASSERT_TRUE(owner.has_value());
+    auto channel = rpc_channel::create(owner->get_memory(), 1, 64);
+    ASSERT_TRUE(channel.has_value());
+    auto client = channel->connect();
+    ASSERT_TRUE(client.has_value());
+
+    std::array<std::byte, 64> response{};
+    const std::string request = "abc";
+    ASSERT_FALSE(client->call(as_bytes(request), response, 0ns).has_value());
+
+    /* A misbehaving client claims a request longer than its buffer; the slot follows the channel header. */
+    const std::uint32_t forged = UINT32_MAX - 1;
+    const auto request_length = rpc_channel::required_size(0, 64) + 2 * sizeof(std::uint32_t);
+    std::memcpy(owner->get_memory().data() + request_length, &forged, sizeof(forged));
+
+    std::size_t seen = 0;
+    EXPECT_EQ(channel->serve([&](std::span<const std::byte> in, std::span<std::byte>) {
+        seen = in.size();
+        return std::size_t{0};
+    }), 1u);
+    EXPECT_EQ(seen, 64u);
+}
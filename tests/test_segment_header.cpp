@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+
+#include "shared_memory/segment_header.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+using namespace std::chrono_literals;
+using shared_memory::segment_name;
+
+segment_name unique_shm_name() {
+    static int counter = 0;
+    return *segment_name::make("/shm_header_test_" + std::to_string(getpid()) + "_" + std::to_string(counter++));
+}
+
+TEST(SegmentHeaderTest, CreatePublishedFillsHeader) {
+    auto shm = shared_memory::create_published(unique_shm_name(), 100, 7, [](std::span<std::byte> payload) {
+        std::memcpy(payload.data(), "ready", 5);
+    });
+    ASSERT_TRUE(shm.has_value());
+
+    const auto& header = shared_memory::header_of(*shm);
+    EXPECT_EQ(header.magic, shared_memory::segment_header::MAGIC);
+    EXPECT_EQ(header.layout, 7u);
+    EXPECT_EQ(header.size, shared_memory::HEADER_SIZE + 100);
+    EXPECT_EQ(header.creator_pid, getpid());
+    EXPECT_EQ(header.state.load(), std::to_underlying(shared_memory::segment_state::READY));
+    EXPECT_EQ(shared_memory::payload(*shm).size(), 100u);
+}
+
+TEST(SegmentHeaderTest, OpenPublishedSeesPayload) {
+    const auto name = unique_shm_name();
+    auto creator = shared_memory::create_published(name, 64, 1, [](std::span<std::byte> payload) {
+        std::memcpy(payload.data(), "hello", 5);
+    });
+    ASSERT_TRUE(creator.has_value());
+
+    auto reader = shared_memory::open_published(name, 1, 100ms);
+    ASSERT_TRUE(reader.has_value());
+    EXPECT_EQ(0, std::memcmp(shared_memory::payload(*reader).data(), "hello", 5));
+}
+
+TEST(SegmentHeaderTest, OpenPublishedRejectsLayoutMismatch) {
+    const auto name = unique_shm_name();
+    auto creator = shared_memory::create_published(name, 64, 1, [](std::span<std::byte>) {});
+    ASSERT_TRUE(creator.has_value());
+
+    auto reader = shared_memory::open_published(name, 2, 100ms);
+    ASSERT_FALSE(reader.has_value());
+    EXPECT_EQ(reader.error().kind(), shared_memory::errc::layout_mismatch);
+}
+
+TEST(SegmentHeaderTest, OpenPublishedWaitsForPublication) {
+    const auto name = unique_shm_name();
+    auto creator = shared_memory::create_unpublished(name, 64, 3);
+    ASSERT_TRUE(creator.has_value());
+
+    std::thread publisher([&] {
+        std::this_thread::sleep_for(20ms);
+        shared_memory::payload(*creator)[0] = std::byte{0x77};
+        shared_memory::publish(*creator);
+    });
+
+    auto reader = shared_memory::open_published(name, 3, 5s);
+    publisher.join();
+
+    ASSERT_TRUE(reader.has_value());
+    EXPECT_EQ(shared_memory::payload(*reader)[0], std::byte{0x77});
+}
+
+TEST(SegmentHeaderTest, OpenPublishedWaitsForCreation) {
+    const auto name = unique_shm_name();
+    std::expected<shared_memory::shared_memory, shared_memory::error> creator;
+
+    std::thread publisher([&] {
+        std::this_thread::sleep_for(20ms);
+        creator = shared_memory::create_published(name, 64, 4, [](std::span<std::byte>) {});
+    });
+
+    auto reader = shared_memory::open_published(name, 4, 5s);
+    publisher.join();
+
+    ASSERT_TRUE(creator.has_value());
+    EXPECT_TRUE(reader.has_value());
+}
+
+TEST(SegmentHeaderTest, OpenPublishedTimesOut) {
+    const auto name = unique_shm_name();
+    auto creator = shared_memory::create_unpublished(name, 64, 5);
+    ASSERT_TRUE(creator.has_value());
+
+    auto reader = shared_memory::open_published(name, 5, 20ms);
+    ASSERT_FALSE(reader.has_value());
+    EXPECT_EQ(reader.error().kind(), shared_memory::errc::wait_failed);
+
+    auto missing = shared_memory::open_published(unique_shm_name(), 5, 5ms);
+    ASSERT_FALSE(missing.has_value());
+    EXPECT_EQ(missing.error().kind(), shared_memory::errc::wait_failed);
+}
+
+} // namespace
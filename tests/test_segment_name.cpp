@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include "shared_memory/segment_name.hpp"
+#include "shared_memory/shared_memory.hpp"
+
+#include <cerrno>
+#include <string>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+
+using shared_memory::segment_name;
+using shm_type = shared_memory::shared_memory;
+
+TEST(SegmentNameTest, DefaultIsEmpty) {
+    constexpr segment_name name;
+    EXPECT_TRUE(name.empty());
+    EXPECT_EQ(name.size(), 0u);
+    EXPECT_STREQ(name.c_str(), "");
+}
+
+TEST(SegmentNameTest, LiteralIsValidatedAtCompileTime) {
+    constexpr segment_name name{"/orders"};
+    static_assert(name.size() == 7);
+    EXPECT_EQ(name.view(), "/orders");
+    EXPECT_STREQ(name.c_str(), "/orders");
+}
+
+TEST(SegmentNameTest, Validation) {
+    EXPECT_TRUE(segment_name::is_valid("/a"));
+    EXPECT_TRUE(segment_name::is_valid("a"));
+    EXPECT_FALSE(segment_name::is_valid(""));
+    EXPECT_FALSE(segment_name::is_valid("/"));
+    EXPECT_FALSE(segment_name::is_valid("/a/b"));
+    EXPECT_FALSE(segment_name::is_valid(std::string_view("/a\0b", 4)));
+    EXPECT_TRUE(segment_name::is_valid(std::string(segment_name::CAPACITY, 'x')));
+    EXPECT_FALSE(segment_name::is_valid(std::string(segment_name::CAPACITY + 1, 'x')));
+}
+
+TEST(SegmentNameTest, MakeReportsErrors) {
+    auto too_long = segment_name::make(std::string(segment_name::CAPACITY + 1, 'x'));
+    ASSERT_FALSE(too_long.has_value());
+    EXPECT_EQ(too_long.error().kind(), shared_memory::errc::open_failed);
+    EXPECT_EQ(too_long.error().code().value(), ENAMETOOLONG);
+
+    auto invalid = segment_name::make("/a/b");
+    ASSERT_FALSE(invalid.has_value());
+    EXPECT_EQ(invalid.error().code().value(), EINVAL);
+
+    auto ok = segment_name::make("/ticks");
+    ASSERT_TRUE(ok.has_value());
+    EXPECT_EQ(*ok, segment_name{"/ticks"});
+}
+
+TEST(SegmentNameTest, CreateAndOpenWithSegmentName) {
+    const std::string runtime = "/shm_name_test_" + std::to_string(getpid());
+    auto name = segment_name::make(runtime);
+    ASSERT_TRUE(name.has_value());
+
+    auto owner = shm_type::create(*name, 256);
+    ASSERT_TRUE(owner.has_value());
+
+    auto reader = shm_type::open(*name);
+    ASSERT_TRUE(reader.has_value());
+    EXPECT_EQ(reader->size(), 256u);
+}
+
+TEST(SegmentNameTest, OwnerUnlinksLongestName) {
+    const std::string prefix = "/shm_name_test_" + std::to_string(getpid()) + "_";
+    const auto name = segment_name::make(prefix + std::string(segment_name::CAPACITY - prefix.size(), 'n'));
+    ASSERT_TRUE(name.has_value());
+    {
+        auto owner = shm_type::create(*name, 64);
+        ASSERT_TRUE(owner.has_value());
+        EXPECT_EQ(owner->fd(), shared_memory::owned_fd::INVALID_FD);
+    }
+    EXPECT_FALSE(shm_type::open(*name).has_value());
+}
+
+TEST(SegmentNameTest, OwnerLeavesReplacedNameAlone) {
+    const auto name = segment_name::make("/shm_name_test_replaced_" + std::to_string(getpid()));
+    ASSERT_TRUE(name.has_value());
+
+    auto owner = shm_type::create(*name, 64);
+    ASSERT_TRUE(owner.has_value());
+    ASSERT_EQ(shm_unlink(name->c_str()), 0);
+    auto successor = shm_type::create(*name, 128);
+    ASSERT_TRUE(successor.has_value());
+
+    owner = shm_type{};
+    auto reader = shm_type::open(*name);
+    ASSERT_TRUE(reader.has_value());
+    EXPECT_EQ(reader->size(), 128u);
+}
+
+TEST(SegmentNameTest, CreateWithInvalidRuntimeNameFails) {
+    auto result = shm_type::create("/invalid/name", 64);
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().kind(), shared_memory::errc::open_failed);
+    EXPECT_EQ(result.error().code().value(), EINVAL);
+}
+
+} // namespace
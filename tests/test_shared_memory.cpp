@@ -3,7 +3,10 @@
 #include "shared_memory/shared_memory.hpp"
 
 #include <array>
+#include <cerrno>
+#include <cstdint>
 #include <cstring>
+#include <utility>
 #include <sys/mman.h>
 #include <unistd.h>
 
@@ -146,4 +149,165 @@ TEST(SharedMemoryTest, CreateDuplicateNameFails) {
     EXPECT_EQ(second.error().kind(), shared_memory::errc::open_failed);
 }
 
+TEST(SharedMemoryTest, DeferredUnmapReleasesOnReaper) {
+    const std::string name = unique_shm_name();
+    void *addr = nullptr;
+    {
+        shared_memory::create_options options{};
+        options.deferred_unmap = true;
+
+        auto result = shm_type::create(*shared_memory::segment_name::make(name), 1 << 20, options);
+        ASSERT_TRUE(result.has_value());
+        EXPECT_TRUE(result->deferred_unmap());
+        addr = result->get_memory().data();
+    }
+
+    // The name is unlinked inline, so it can be reused right away.
+    auto again = shm_type::create(name, 64);
+    EXPECT_TRUE(again.has_value());
+
+    shm_type::drain_deferred_unmaps();
+
+    unsigned char residency = 0;
+    EXPECT_EQ(mincore(addr, 1, &residency), -1);
+    EXPECT_EQ(errno, ENOMEM);
+}
+
+TEST(SharedMemoryTest, DeferredUnmapCanBeEnabledOnOpenedHandle) {
+    const std::string name = unique_shm_name();
+    auto owner = shm_type::create(name, 4096);
+    ASSERT_TRUE(owner.has_value());
+
+    auto reader = shm_type::open(name);
+    ASSERT_TRUE(reader.has_value());
+    EXPECT_FALSE(reader->deferred_unmap());
+
+    reader->set_deferred_unmap(true);
+    shm_type moved(std::move(*reader));
+    EXPECT_TRUE(moved.deferred_unmap());
+    EXPECT_FALSE(reader->deferred_unmap());
+}
+
+TEST(SharedMemoryTest, FdIsClosedByDefault) {
+    auto result = shm_type::create(unique_shm_name(), 64);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->fd(), shared_memory::owned_fd::INVALID_FD);
+    EXPECT_FALSE(result->stat().has_value());
+    EXPECT_FALSE(result->resize(128).has_value());
+}
+
+TEST(SharedMemoryTest, RetainedFdSupportsStatAndResize) {
+    shared_memory::create_options options{};
+    options.retain_fd = true;
+
+    auto result = shm_type::create(*shared_memory::segment_name::make(unique_shm_name()), 4096, options);
+    ASSERT_TRUE(result.has_value());
+    ASSERT_GE(result->fd(), 0);
+
+    auto st = result->stat();
+    ASSERT_TRUE(st.has_value());
+    EXPECT_EQ(st->st_size, 4096);
+
+    result->get_memory()[100] = std::byte{0x5A};
+    ASSERT_TRUE(result->resize(3 * 4096).has_value());
+    EXPECT_EQ(result->size(), 3u * 4096);
+    EXPECT_EQ(result->get_memory()[100], std::byte{0x5A});
+    EXPECT_EQ(result->get_memory()[3 * 4096 - 1], std::byte{0});
+    EXPECT_EQ(result->stat()->st_size, 3 * 4096);
+}
+
+TEST(SharedMemoryTest, DuplicatedFdCanBeAdopted) {
+    const std::string name = unique_shm_name();
+    shared_memory::create_options options{};
+    options.retain_fd = true;
+
+    auto owner = shm_type::create(*shared_memory::segment_name::make(name), 256, options);
+    ASSERT_TRUE(owner.has_value());
+    owner->get_memory()[7] = std::byte{0x42};
+
+    auto copy = owner->duplicate_fd();
+    ASSERT_TRUE(copy.has_value());
+    EXPECT_NE(copy->get(), owner->fd());
+
+    auto adopted = shm_type::adopt(std::move(*copy));
+    ASSERT_TRUE(adopted.has_value());
+    EXPECT_EQ(adopted->size(), 256u);
+    EXPECT_EQ(adopted->get_memory()[7], std::byte{0x42});
+    EXPECT_GE(adopted->fd(), 0);
+}
+
+TEST(SharedMemoryTest, OpenWithRetainedFdAndPrivateMapping) {
+    const std::string name = unique_shm_name();
+    auto owner = shm_type::create(name, 256);
+    ASSERT_TRUE(owner.has_value());
+    owner->get_memory()[0] = std::byte{1};
+
+    shared_memory::open_options options{};
+    options.retain_fd = true;
+    auto reader = shm_type::open(*shared_memory::segment_name::make(name), options);
+    ASSERT_TRUE(reader.has_value());
+    ASSERT_GE(reader->fd(), 0);
+
+    auto snapshot = reader->map_private();
+    ASSERT_TRUE(snapshot.has_value());
+    EXPECT_EQ(snapshot->get_memory()[0], std::byte{1});
+
+    snapshot->get_memory()[0] = std::byte{2};
+    EXPECT_EQ(owner->get_memory()[0], std::byte{1});
+}
+
+TEST(SharedMemoryTest, PreallocateReservesBlocks) {
+    shared_memory::create_options options{};
+    options.preallocate = true;
+    options.retain_fd = true;
+
+    auto result = shm_type::create(*shared_memory::segment_name::make(unique_shm_name()), 1 << 20, options);
+    ASSERT_TRUE(result.has_value());
+
+    auto st = result->stat();
+    ASSERT_TRUE(st.has_value());
+    EXPECT_GE(static_cast<std::size_t>(st->st_blocks) * 512, 1u << 20);
+}
+
+TEST(SharedMemoryTest, AllocateAfterResize) {
+    shared_memory::create_options options{};
+    options.retain_fd = true;
+
+    auto result = shm_type::create(*shared_memory::segment_name::make(unique_shm_name()), 4096, options);
+    ASSERT_TRUE(result.has_value());
+    ASSERT_TRUE(result->resize(8 * 4096).has_value());
+    ASSERT_TRUE(result->allocate(4096, 7 * 4096).has_value());
+
+    EXPECT_GE(static_cast<std::size_t>(result->stat()->st_blocks) * 512, 7u * 4096);
+}
+
+TEST(SharedMemoryTest, AllocateRejectsEmptyAndOutOfRange) {
+    shared_memory::create_options options{};
+    options.retain_fd = true;
+
+    auto result = shm_type::create(*shared_memory::segment_name::make(unique_shm_name()), 2 * 4096, options);
+    ASSERT_TRUE(result.has_value());
+
+    for (const auto& [offset, length] : {std::pair<std::size_t, std::size_t>{0, 0},
+                                         {4096, 2 * 4096},
+                                         {3 * 4096, 4096},
+                                         {4096, SIZE_MAX}}) {
+        auto allocated = result->allocate(offset, length);
+        ASSERT_FALSE(allocated.has_value());
+        EXPECT_EQ(allocated.error().kind(), shared_memory::errc::allocate_failed);
+        EXPECT_EQ(allocated.error().code().value(), EINVAL);
+    }
+    EXPECT_EQ(static_cast<std::size_t>(result->stat()->st_size), 2u * 4096);
+    EXPECT_TRUE(result->allocate(4096, 4096).has_value());
+}
+
+TEST(SharedMemoryTest, AllocateWithoutFdFails) {
+    auto result = shm_type::create(unique_shm_name(), 4096);
+    ASSERT_TRUE(result.has_value());
+
+    auto allocated = result->allocate(0, 4096);
+    ASSERT_FALSE(allocated.has_value());
+    EXPECT_EQ(allocated.error().kind(), shared_memory::errc::allocate_failed);
+}
+
 } // namespace
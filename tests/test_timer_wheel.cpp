@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+
+#include "shared_memory/shared_memory.hpp"
+#include "shared_memory/timer_wheel.hpp"
+
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+using shared_memory::expired_timer;
+using shared_memory::timer_wheel;
+using shm_type = shared_memory::shared_memory;
+
+std::string unique_shm_name() {
+    static int counter = 0;
+    return "/shm_timer_test_" + std::to_string(getpid()) + "_" + std::to_string(counter++);
+}
+
+TEST(TimerWheelTest, FiresAtDeadlineInOrder) {
+    auto owner = shm_type::create(unique_shm_name(), timer_wheel::required_size(16));
+    ASSERT_TRUE(owner.has_value());
+    auto wheel = timer_wheel::create(owner->get_memory(), 16, 1000);
+    ASSERT_TRUE(wheel.has_value());
+
+    ASSERT_TRUE(wheel->schedule(1010, 2).has_value());
+    ASSERT_TRUE(wheel->schedule(1005, 1).has_value());
+    ASSERT_TRUE(wheel->schedule(1500, 3).has_value());
+    EXPECT_EQ(wheel->size(), 3u);
+
+    std::vector<std::uint64_t> fired;
+    const auto collect = [&](const expired_timer& timer) { fired.push_back(timer.payload); };
+
+    EXPECT_EQ(wheel->advance(1004, collect), 0u);
+    EXPECT_EQ(wheel->advance(1010, collect), 2u);
+    EXPECT_EQ(fired, (std::vector<std::uint64_t>{1, 2}));
+    EXPECT_EQ(wheel->advance(2000, collect), 1u);
+    EXPECT_EQ(fired.back(), 3u);
+    EXPECT_EQ(wheel->now(), 2000u);
+    EXPECT_EQ(wheel->size(), 0u);
+}
+
+TEST(TimerWheelTest, CancelRemovesTimerAndStaleHandlesFail) {
+    auto owner = shm_type::create(unique_shm_name(), timer_wheel::required_size(4));
+    ASSERT_TRUE(owner.has_value());
+    auto wheel = timer_wheel::create(owner->get_memory(), 4, 0);
+    ASSERT_TRUE(wheel.has_value());
+
+    const auto handle = wheel->schedule(100, 7).value();
+    EXPECT_TRUE(wheel->cancel(handle));
+    EXPECT_FALSE(wheel->cancel(handle));
+
+    const auto reused = wheel->schedule(50, 8).value();
+    EXPECT_EQ(reused.index, handle.index);
+    EXPECT_NE(reused, handle);
+    EXPECT_FALSE(wheel->cancel(handle));
+
+    std::vector<expired_timer> fired(4);
+    ASSERT_EQ(wheel->advance(200, std::span(fired)), 1u);
+    EXPECT_EQ(fired[0].payload, 8u);
+    EXPECT_FALSE(wheel->cancel(reused));
+}
+
+TEST(TimerWheelTest, ReportsExhaustionAndPastDeadlines) {
+    auto owner = shm_type::create(unique_shm_name(), timer_wheel::required_size(2));
+    ASSERT_TRUE(owner.has_value());
+    auto wheel = timer_wheel::create(owner->get_memory(), 2, 500);
+    ASSERT_TRUE(wheel.has_value());
+
+    ASSERT_TRUE(wheel->schedule(10, 1).has_value());
+    ASSERT_TRUE(wheel->schedule(20, 2).has_value());
+    auto full = wheel->schedule(30, 3);
+    ASSERT_FALSE(full.has_value());
+    EXPECT_EQ(full.error().kind(), shared_memory::errc::allocate_failed);
+    EXPECT_EQ(full.error().code().value(), ENOSPC);
+
+    std::vector<expired_timer> fired(1);
+    ASSERT_EQ(wheel->advance(500, std::span(fired)), 1u);
+    EXPECT_EQ(fired[0].payload, 1u);
+    ASSERT_EQ(wheel->advance(500, std::span(fired)), 1u);
+    EXPECT_EQ(fired[0].payload, 2u);
+}
+
+TEST(TimerWheelTest, MatchesReferenceAcrossLevelsAndParkedDeadlines) {
+    constexpr std::size_t capacity = 4096;
+    auto owner = shm_type::create(unique_shm_name(), timer_wheel::required_size(capacity));
+    ASSERT_TRUE(owner.has_value());
+    auto wheel = timer_wheel::create(owner->get_memory(), capacity, 0);
+    ASSERT_TRUE(wheel.has_value());
+
+    std::mt19937_64 random(11);
+    std::multiset<std::uint64_t> pending;
+    for (std::size_t i = 0; i < capacity; ++i) {
+        const auto deadline = i % 64 == 0 ? timer_wheel::RANGE + random() % (timer_wheel::RANGE * 2) : random() % 300000;
+        ASSERT_TRUE(wheel->schedule(deadline, deadline).has_value());
+        pending.insert(deadline);
+    }
+
+    std::uint64_t now = 0;
+    while (!pending.empty()) {
+        const auto previous = now;
+        now += 1 + random() % 50000;
+        wheel->advance(now, [&](const expired_timer& timer) {
+            EXPECT_EQ(timer.payload, timer.deadline);
+            EXPECT_LE(timer.deadline, now);
+            EXPECT_GT(timer.deadline, previous);
+            pending.erase(pending.find(timer.deadline));
+        });
+        ASSERT_TRUE(pending.empty() || *pending.begin() > now);
+    }
+    EXPECT_EQ(wheel->size(), 0u);
+}
+
+TEST(TimerWheelTest, LongAdvanceSkipsEmptyTicks) {
+    auto owner = shm_type::create(unique_shm_name(), timer_wheel::required_size(4));
+    ASSERT_TRUE(owner.has_value());
+    auto wheel = timer_wheel::create(owner->get_memory(), 4, 0);
+    ASSERT_TRUE(wheel.has_value());
+
+    /* Ticking one at a time would take 2^40 steps; skipping visits only the few slots holding timers. */
+    constexpr std::uint64_t far = std::uint64_t{1} << 40;
+    ASSERT_TRUE(wheel->schedule(far, 3).has_value());
+    ASSERT_TRUE(wheel->schedule(far / 2 + 12345, 2).has_value());
+    ASSERT_TRUE(wheel->schedule(70, 1).has_value());
+
+    std::vector<expired_timer> fired;
+    const auto collect = [&](const expired_timer& timer) { fired.push_back(timer); };
+    EXPECT_EQ(wheel->advance(far - 1, collect), 2u);
+    EXPECT_EQ(wheel->advance(far, collect), 1u);
+    ASSERT_EQ(fired.size(), 3u);
+    EXPECT_EQ(fired[0].deadline, 70u);
+    EXPECT_EQ(fired[1].deadline, far / 2 + 12345);
+    EXPECT_EQ(fired[2].deadline, far);
+    EXPECT_EQ(wheel->now(), far);
+}
+
+TEST(TimerWheelTest, AttachedWheelSharesTimers) {
+    const std::string name = unique_shm_name();
+    auto owner = shm_type::create(name, timer_wheel::required_size(8));
+    ASSERT_TRUE(owner.has_value());
+    auto driver = timer_wheel::create(owner->get_memory(), 8, 0);
+    ASSERT_TRUE(driver.has_value());
+
+    auto mapping = shm_type::open(name);
+    ASSERT_TRUE(mapping.has_value());
+    auto client = timer_wheel::attach(mapping->get_memory());
+    ASSERT_TRUE(client.has_value());
+
+    const auto kept = client->schedule(10, 1).value();
+    const auto dropped = client->schedule(10, 2).value();
+    EXPECT_TRUE(driver->cancel(dropped));
+
+    std::vector<expired_timer> fired(8);
+    ASSERT_EQ(driver->advance(10, std::span(fired)), 1u);
+    EXPECT_EQ(fired[0].handle, kept);
+
+    auto unformatted = shm_type::create(unique_shm_name(), 4096);
+    ASSERT_TRUE(unformatted.has_value());
+    auto rejected = timer_wheel::attach(unformatted->get_memory());
+    ASSERT_FALSE(rejected.has_value());
+    EXPECT_EQ(rejected.error().code().value(), EPROTO);
+}
+
+} // namespace
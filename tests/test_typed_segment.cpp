@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+
+#include "shared_memory/typed_segment.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <unistd.h>
+
+namespace {
+
+using namespace std::chrono_literals;
+using shared_memory::segment_name;
+using shared_memory::typed_segment;
+
+struct counters {
+    std::atomic<std::uint64_t> sequence{0};
+    std::uint32_t producer_id{0};
+    std::uint32_t flags{0};
+
+    static constexpr std::tuple ATOMIC_MEMBERS{&counters::sequence};
+    static constexpr std::tuple LAYOUT_MEMBERS{&counters::sequence, &counters::producer_id, &counters::flags};
+
+    counters() = default;
+    explicit counters(std::uint32_t id) : producer_id(id) {}
+};
+
+struct other_counters {
+    std::atomic<std::uint64_t> sequence{0};
+    std::uint64_t padding{0};
+
+    static constexpr std::tuple LAYOUT_MEMBERS{&other_counters::sequence, &other_counters::padding};
+};
+
+struct versioned {
+    static constexpr std::uint64_t LAYOUT_VERSION{2};
+    std::uint64_t value{0};
+};
+
+struct unversioned {
+    std::uint64_t value{0};
+    static constexpr std::tuple LAYOUT_MEMBERS{&unversioned::value};
+};
+
+struct with_vtable {
+    virtual ~with_vtable() = default;
+};
+
+struct lock_based {
+    std::uint64_t words[8];
+};
+
+static_assert(shared_memory::segment_storable<counters>);
+static_assert(!shared_memory::segment_storable<with_vtable>);
+static_assert(!shared_memory::segment_storable<int *>);
+static_assert(!shared_memory::segment_storable<std::atomic<lock_based>>);
+
+/* Member atomics are only checked when listed. */
+struct listed_lock_based_member {
+    std::atomic<lock_based> state;
+    static constexpr std::tuple ATOMIC_MEMBERS{&listed_lock_based_member::state};
+};
+
+struct unlisted_lock_based_member {
+    std::atomic<lock_based> state;
+};
+
+static_assert(!shared_memory::segment_storable<listed_lock_based_member>);
+static_assert(shared_memory::segment_storable<unlisted_lock_based_member>);
+static_assert(shared_memory::layout_hash<counters>() != shared_memory::layout_hash<other_counters>());
+
+/* Class types are only hashed when their layout is described. */
+struct nested {
+    counters inner[2];
+    std::atomic<std::uint32_t> state;
+    static constexpr std::tuple LAYOUT_MEMBERS{&nested::inner, &nested::state};
+};
+
+struct nested_undescribed {
+    other_counters inner;
+    unlisted_lock_based_member state;
+    static constexpr std::tuple LAYOUT_MEMBERS{&nested_undescribed::inner, &nested_undescribed::state};
+};
+
+static_assert(shared_memory::layout_described<std::uint64_t[4]>());
+static_assert(shared_memory::layout_described<nested>());
+static_assert(shared_memory::layout_described<versioned>());
+static_assert(!shared_memory::layout_described<lock_based>());
+static_assert(!shared_memory::layout_described<std::atomic<lock_based>>());
+static_assert(!shared_memory::layout_described<nested_undescribed>());
+
+segment_name unique_shm_name() {
+    static int counter = 0;
+    return *segment_name::make("/shm_typed_test_" + std::to_string(getpid()) + "_" + std::to_string(counter++));
+}
+
+TEST(TypedSegmentTest, CreateConstructsInPlace) {
+    auto segment = typed_segment<counters>::create(unique_shm_name(), {}, 42u);
+    ASSERT_TRUE(segment.has_value());
+    EXPECT_EQ((*segment)->producer_id, 42u);
+    EXPECT_EQ(segment->get().sequence.load(), 0u);
+}
+
+TEST(TypedSegmentTest, OpenSharesObject) {
+    const auto name = unique_shm_name();
+    auto creator = typed_segment<counters>::create(name);
+    ASSERT_TRUE(creator.has_value());
+
+    auto reader = typed_segment<counters>::open(name, 100ms);
+    ASSERT_TRUE(reader.has_value());
+
+    (*creator)->sequence.fetch_add(5);
+    EXPECT_EQ((*reader)->sequence.load(), 5u);
+}
+
+TEST(TypedSegmentTest, OpenRejectsDifferentType) {
+    const auto name = unique_shm_name();
+    auto creator = typed_segment<counters>::create(name);
+    ASSERT_TRUE(creator.has_value());
+
+    auto reader = typed_segment<other_counters>::open(name, 10ms);
+    ASSERT_FALSE(reader.has_value());
+    EXPECT_EQ(reader.error().kind(), shared_memory::errc::layout_mismatch);
+}
+
+TEST(TypedSegmentTest, LayoutVersionChangesHash) {
+    EXPECT_NE(shared_memory::layout_hash<versioned>(), shared_memory::layout_hash<unversioned>());
+
+    auto segment = typed_segment<versioned>::create(unique_shm_name());
+    ASSERT_TRUE(segment.has_value());
+    EXPECT_EQ(shared_memory::header_of(segment->segment()).layout, typed_segment<versioned>::LAYOUT);
+}
+
+TEST(TypedSegmentTest, MovePreservesObjectAddress) {
+    auto segment = typed_segment<counters>::create(unique_shm_name());
+    ASSERT_TRUE(segment.has_value());
+
+    counters *address = &segment->get();
+    typed_segment<counters> moved(std::move(*segment));
+    EXPECT_EQ(&moved.get(), address);
+    EXPECT_TRUE(segment->empty());
+}
+
+} // namespace
@@ -0,0 +1,418 @@
+#include <gtest/gtest.h>
+
+#include "shared_memory/shared_memory.hpp"
+#include "shared_memory/wal.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+using namespace std::chrono_literals;
+using shared_memory::errc;
+using shared_memory::wal_flusher;
+using shared_memory::write_ahead_log;
+using shm_type = shared_memory::shared_memory;
+
+std::string unique_shm_name() {
+    static int counter = 0;
+    return "/shm_wal_test_" + std::to_string(getpid()) + "_" + std::to_string(counter++);
+}
+
+std::filesystem::path unique_file_path() {
+    static int counter = 0;
+    return std::filesystem::temp_directory_path() / ("shm_wal_test_" + std::to_string(getpid()) + "_" + std::to_string(counter++));
+}
+
+std::vector<std::byte> bytes_of(const std::string& text) {
+    std::vector<std::byte> result(text.size());
+    std::memcpy(result.data(), text.data(), text.size());
+    return result;
+}
+
+std::string text_of(std::span<const std::byte> payload) {
+    return std::string(reinterpret_cast<const char *>(payload.data()), payload.size());
+}
+
+std::map<std::uint64_t, std::string> replay_all(const std::filesystem::path& path) {
+    std::map<std::uint64_t, std::string> records;
+    auto end = write_ahead_log::replay(path, [&](const std::uint64_t lsn, std::span<const std::byte> payload) {
+        records.emplace(lsn, text_of(payload));
+    });
+    EXPECT_TRUE(end.has_value());
+    return records;
+}
+
+} // namespace
+
+TEST(WriteAheadLogTest, AppendFlushAndReplay) {
+    auto owner = shm_type::create(unique_shm_name(), write_ahead_log::required_size(4096));
+    ASSERT_TRUE(owner.has_value());
+    auto log = write_ahead_log::create(owner->get_memory(), 4096);
+    ASSERT_TRUE(log.has_value());
+
+    const auto path = unique_file_path();
+    auto flusher = wal_flusher::open(*log, path);
+    ASSERT_TRUE(flusher.has_value());
+
+    const auto first = log->append(bytes_of("alpha"));
+    const auto second = log->append(bytes_of("bravo charlie"));
+    ASSERT_TRUE(first.has_value() && second.has_value());
+    EXPECT_EQ(*first, 0u);
+    EXPECT_EQ(*second, write_ahead_log::record_size(5));
+    EXPECT_EQ(log->durable_lsn(), 0u);
+
+    const auto durable = flusher->flush();
+    ASSERT_TRUE(durable.has_value());
+    EXPECT_EQ(*durable, write_ahead_log::record_size(5) + write_ahead_log::record_size(13));
+    EXPECT_EQ(log->durable_lsn(), *durable);
+    EXPECT_TRUE(log->wait_durable(*second, 0ns).has_value());
+
+    const auto records = replay_all(path);
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_EQ(records.at(*first), "alpha");
+    EXPECT_EQ(records.at(*second), "bravo charlie");
+
+    std::filesystem::remove(path);
+}
+
+TEST(WriteAheadLogTest, UncommittedRecordStopsFlush) {
+    auto owner = shm_type::create(unique_shm_name(), write_ahead_log::required_size(4096));
+    ASSERT_TRUE(owner.has_value());
+    auto log = write_ahead_log::create(owner->get_memory(), 4096);
+    ASSERT_TRUE(log.has_value());
+    const auto path = unique_file_path();
+    auto flusher = wal_flusher::open(*log, path);
+    ASSERT_TRUE(flusher.has_value());
+
+    ASSERT_TRUE(log->append(bytes_of("one")).has_value());
+    auto pending = log->reserve(3);
+    ASSERT_TRUE(pending.has_value());
+    const auto third = log->append(bytes_of("three"));
+    ASSERT_TRUE(third.has_value());
+
+    EXPECT_EQ(flusher->flush().value(), pending->lsn);
+    EXPECT_FALSE(log->wait_durable(*third, 1ms).has_value());
+
+    std::ranges::copy(bytes_of("two"), pending->payload.begin());
+    log->commit(*pending);
+    EXPECT_EQ(flusher->flush().value(), *third + write_ahead_log::record_size(5));
+
+    const auto records = replay_all(path);
+    ASSERT_EQ(records.size(), 3u);
+    EXPECT_EQ(records.at(pending->lsn), "two");
+
+    std::filesystem::remove(path);
+}
+
+TEST(WriteAheadLogTest, FullRingReportsNoSpaceUntilFlushed) {
+    auto owner = shm_type::create(unique_shm_name(), write_ahead_log::required_size(4096));
+    ASSERT_TRUE(owner.has_value());
+    auto log = write_ahead_log::create(owner->get_memory(), 4096);
+    ASSERT_TRUE(log.has_value());
+    const auto path = unique_file_path();
+    auto flusher = wal_flusher::open(*log, path);
+    ASSERT_TRUE(flusher.has_value());
+
+    const std::vector<std::byte> payload(1000, std::byte{1});
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(log->append(payload).has_value());
+    }
+    auto full = log->append(payload);
+    ASSERT_FALSE(full.has_value());
+    EXPECT_EQ(full.error().kind(), errc::allocate_failed);
+    EXPECT_EQ(full.error().code().value(), ENOSPC);
+
+    auto oversized = log->reserve(4096);
+    ASSERT_FALSE(oversized.has_value());
+    EXPECT_EQ(oversized.error().code().value(), EMSGSIZE);
+
+    ASSERT_TRUE(flusher->flush().has_value());
+    EXPECT_TRUE(log->append(payload).has_value());
+
+    std::filesystem::remove(path);
+}
+
+TEST(WriteAheadLogTest, WrapsAroundRingWithPadding) {
+    auto owner = shm_type::create(unique_shm_name(), write_ahead_log::required_size(4096));
+    ASSERT_TRUE(owner.has_value());
+    auto log = write_ahead_log::create(owner->get_memory(), 4096);
+    ASSERT_TRUE(log.has_value());
+    const auto path = unique_file_path();
+    shared_memory::wal_flusher_options options;
+    options.max_batch = 1500;
+    auto flusher = wal_flusher::open(*log, path, options);
+    ASSERT_TRUE(flusher.has_value());
+
+    std::map<std::uint64_t, std::string> expected;
+    for (int i = 0; i < 200; ++i) {
+        const auto text = "record-" + std::to_string(i) + std::string(static_cast<std::size_t>(i * 7 % 300), 'x');
+        auto lsn = log->append(bytes_of(text));
+        while (!lsn) {
+            ASSERT_EQ(lsn.error().code().value(), ENOSPC);
+            ASSERT_TRUE(flusher->flush().has_value());
+            lsn = log->append(bytes_of(text));
+        }
+        expected.emplace(*lsn, text);
+    }
+    while (log->durable_lsn() < expected.rbegin()->first + 1) {
+        ASSERT_TRUE(flusher->flush().has_value());
+    }
+
+    EXPECT_GT(log->durable_lsn(), 4 * log->capacity());
+    EXPECT_EQ(replay_all(path), expected);
+
+    std::filesystem::remove(path);
+}
+
+TEST(WriteAheadLogTest, ConcurrentAppendersWithFlusherThread) {
+    constexpr std::size_t capacity = 64 * 1024;
+    auto owner = shm_type::create(unique_shm_name(), write_ahead_log::required_size(capacity));
+    ASSERT_TRUE(owner.has_value());
+    auto log = write_ahead_log::create(owner->get_memory(), capacity);
+    ASSERT_TRUE(log.has_value());
+    const auto path = unique_file_path();
+
+    std::atomic<bool> stop{false};
+    std::thread flusher_thread([&] {
+        auto flusher = wal_flusher::open(*log, path);
+        ASSERT_TRUE(flusher.has_value());
+        while (!stop.load()) {
+            if (flusher->wait_for_commits(10ms)) {
+                ASSERT_TRUE(flusher->flush().has_value());
+            }
+        }
+        while (flusher->wait_for_commits(0ns)) {
+            ASSERT_TRUE(flusher->flush().has_value());
+        }
+    });
+
+    constexpr int threads = 4;
+    constexpr int per_thread = 2000;
+    std::vector<std::thread> appenders;
+    for (int t = 0; t < threads; ++t) {
+        appenders.emplace_back([&, t] {
+            auto attached = write_ahead_log::attach(owner->get_memory());
+            ASSERT_TRUE(attached.has_value());
+            for (int i = 0; i < per_thread; ++i) {
+                const auto text = std::to_string(t) + ":" + std::to_string(i);
+                auto lsn = attached->append(bytes_of(text));
+                while (!lsn) {
+                    std::this_thread::yield();
+                    lsn = attached->append(bytes_of(text));
+                }
+                /* Every hundredth record waits for durability, as a synchronous commit would. */
+                if (i % 100 == 0) {
+                    ASSERT_TRUE(attached->wait_durable(*lsn, 5s).has_value());
+                }
+            }
+        });
+    }
+    for (auto& appender : appenders) {
+        appender.join();
+    }
+    stop.store(true);
+    flusher_thread.join();
+
+    const auto records = replay_all(path);
+    ASSERT_EQ(records.size(), static_cast<std::size_t>(threads * per_thread));
+    std::vector<int> next(threads, 0);
+    for (const auto& [lsn, text] : records) {
+        const auto colon = text.find(':');
+        const auto t = std::stoi(text.substr(0, colon));
+        EXPECT_EQ(std::stoi(text.substr(colon + 1)), next[static_cast<std::size_t>(t)]++);
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST(WriteAheadLogTest, RestartedFlusherContinuesFile) {
+    auto owner = shm_type::create(unique_shm_name(), write_ahead_log::required_size(4096));
+    ASSERT_TRUE(owner.has_value());
+    auto log = write_ahead_log::create(owner->get_memory(), 4096);
+    ASSERT_TRUE(log.has_value());
+    const auto path = unique_file_path();
+
+    {
+        shared_memory::wal_flusher_options options;
+        options.use_io_uring = false;
+        auto flusher = wal_flusher::open(*log, path, options);
+        ASSERT_TRUE(flusher.has_value());
+        ASSERT_TRUE(log->append(bytes_of("before")).has_value());
+        ASSERT_TRUE(flusher->flush().has_value());
+    }
+
+    ASSERT_TRUE(log->append(bytes_of("after")).has_value());
+    auto flusher = wal_flusher::open(*log, path);
+    ASSERT_TRUE(flusher.has_value());
+    ASSERT_TRUE(flusher->flush().has_value());
+
+    const auto records = replay_all(path);
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_EQ(records.begin()->second, "before");
+    EXPECT_EQ(records.rbegin()->second, "after");
+
+    std::filesystem::remove(path);
+}
+
+TEST(WriteAheadLogTest, FlusherDyingBeforeZeroingLeavesLogUsable) {
+    const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    auto owner = shm_type::create(unique_shm_name(), write_ahead_log::required_size(8192));
+    ASSERT_TRUE(owner.has_value());
+    auto log = write_ahead_log::create(owner->get_memory(), 8192);
+    ASSERT_TRUE(log.has_value());
+    const auto path = unique_file_path();
+    shared_memory::wal_flusher_options options;
+    options.use_io_uring = false;
+
+    /* Move the log past the first page, which also holds the header. */
+    {
+        auto flusher = wal_flusher::open(*log, path, options);
+        ASSERT_TRUE(flusher.has_value());
+        ASSERT_TRUE(log->append(std::vector<std::byte>(3000, std::byte{'a'})).has_value());
+        ASSERT_TRUE(log->append(std::vector<std::byte>(2000, std::byte{'b'})).has_value());
+        ASSERT_TRUE(flusher->flush().has_value());
+    }
+    const auto victim = log->append(bytes_of("victim"));
+    ASSERT_TRUE(victim.has_value());
+    const auto ring_offset = write_ahead_log::required_size(8192) - 8192;
+    ASSERT_GE(ring_offset + (*victim & 8191), page);
+
+    /* The child's flusher publishes durable, then faults on the read-only ring while zeroing it. */
+    const pid_t child = fork();
+    ASSERT_NE(child, -1);
+    if (child == 0) {
+        if (mprotect(owner->get_memory().data() + page, owner->size() - page, PROT_READ) != 0) {
+            _exit(1);
+        }
+        auto flusher = wal_flusher::open(*log, path, options);
+        if (flusher.has_value()) {
+            (void)flusher->flush();
+        }
+        _exit(0);
+    }
+    int status = 0;
+    ASSERT_EQ(waitpid(child, &status, 0), child);
+    ASSERT_TRUE(WIFSIGNALED(status));
+    EXPECT_EQ(WTERMSIG(status), SIGSEGV);
+    EXPECT_EQ(log->durable_lsn(), *victim + write_ahead_log::record_size(6));
+
+    /* A restarted flusher finishes the zeroing; wrapping the ring several times must still work. */
+    auto flusher = wal_flusher::open(*log, path);
+    ASSERT_TRUE(flusher.has_value());
+    std::vector<std::uint64_t> lsns;
+    for (int i = 0; i < 64; ++i) {
+        const auto lsn = log->append(bytes_of("record " + std::to_string(i) + std::string(500, '.')));
+        ASSERT_TRUE(lsn.has_value());
+        lsns.push_back(*lsn);
+        ASSERT_TRUE(flusher->flush().has_value());
+    }
+
+    const auto records = replay_all(path);
+    ASSERT_EQ(records.size(), 3u + lsns.size());
+    EXPECT_EQ(records.at(*victim), "victim");
+    for (int i = 0; i < 64; ++i) {
+        EXPECT_EQ(records.at(lsns[i]), "record " + std::to_string(i) + std::string(500, '.'));
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST(WriteAheadLogTest, NewLogRefusesExistingJournal) {
+    const auto path = unique_file_path();
+    {
+        auto owner = shm_type::create(unique_shm_name(), write_ahead_log::required_size(4096));
+        ASSERT_TRUE(owner.has_value());
+        auto log = write_ahead_log::create(owner->get_memory(), 4096);
+        ASSERT_TRUE(log.has_value());
+        auto flusher = wal_flusher::open(*log, path);
+        ASSERT_TRUE(flusher.has_value());
+        ASSERT_TRUE(log->append(bytes_of("persisted")).has_value());
+        ASSERT_TRUE(flusher->flush().has_value());
+    }
+    const auto journal_size = std::filesystem::file_size(path);
+
+    auto owner = shm_type::create(unique_shm_name(), write_ahead_log::required_size(4096));
+    ASSERT_TRUE(owner.has_value());
+    auto fresh = write_ahead_log::create(owner->get_memory(), 4096);
+    ASSERT_TRUE(fresh.has_value());
+    auto refused = wal_flusher::open(*fresh, path);
+    ASSERT_FALSE(refused.has_value());
+    EXPECT_EQ(refused.error().kind(), errc::layout_mismatch);
+    EXPECT_EQ(refused.error().code().value(), EEXIST);
+    EXPECT_EQ(std::filesystem::file_size(path), journal_size);
+
+    std::filesystem::remove(path);
+}
+
+TEST(WriteAheadLogTest, NewLogContinuesFromReplayEnd) {
+    const auto path = unique_file_path();
+    {
+        auto owner = shm_type::create(unique_shm_name(), write_ahead_log::required_size(4096));
+        ASSERT_TRUE(owner.has_value());
+        auto log = write_ahead_log::create(owner->get_memory(), 4096);
+        ASSERT_TRUE(log.has_value());
+        auto flusher = wal_flusher::open(*log, path);
+        ASSERT_TRUE(flusher.has_value());
+        ASSERT_TRUE(log->append(bytes_of("first run")).has_value());
+        ASSERT_TRUE(flusher->flush().has_value());
+    }
+
+    const auto end = write_ahead_log::replay(path, [](std::uint64_t, std::span<const std::byte>) {});
+    ASSERT_TRUE(end.has_value());
+
+    auto owner = shm_type::create(unique_shm_name(), write_ahead_log::required_size(4096));
+    ASSERT_TRUE(owner.has_value());
+    auto misaligned = write_ahead_log::create(owner->get_memory(), 4096, *end + 1);
+    ASSERT_FALSE(misaligned.has_value());
+    EXPECT_EQ(misaligned.error().code().value(), EINVAL);
+
+    auto log = write_ahead_log::create(owner->get_memory(), 4096, *end);
+    ASSERT_TRUE(log.has_value());
+    EXPECT_EQ(log->durable_lsn(), *end);
+    auto flusher = wal_flusher::open(*log, path);
+    ASSERT_TRUE(flusher.has_value());
+    const auto lsn = log->append(bytes_of("second run"));
+    ASSERT_TRUE(lsn.has_value());
+    EXPECT_EQ(*lsn, *end);
+    ASSERT_TRUE(flusher->flush().has_value());
+
+    const auto records = replay_all(path);
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_EQ(records.begin()->second, "first run");
+    EXPECT_EQ(records.at(*end), "second run");
+
+    std::filesystem::remove(path);
+}
+
+TEST(WriteAheadLogTest, CreateAndAttachValidateRegion) {
+    auto owner = shm_type::create(unique_shm_name(), write_ahead_log::required_size(8192));
+    ASSERT_TRUE(owner.has_value());
+
+    auto bad_capacity = write_ahead_log::create(owner->get_memory(), 5000);
+    ASSERT_FALSE(bad_capacity.has_value());
+    EXPECT_EQ(bad_capacity.error().code().value(), EINVAL);
+
+    auto too_small = write_ahead_log::create(owner->get_memory().first(4096), 8192);
+    ASSERT_FALSE(too_small.has_value());
+    EXPECT_EQ(too_small.error().code().value(), ENOSPC);
+
+    auto unformatted = write_ahead_log::attach(owner->get_memory());
+    ASSERT_FALSE(unformatted.has_value());
+    EXPECT_EQ(unformatted.error().code().value(), EPROTO);
+
+    ASSERT_TRUE(write_ahead_log::create(owner->get_memory(), 8192).has_value());
+    auto attached = write_ahead_log::attach(owner->get_memory());
+    ASSERT_TRUE(attached.has_value());
+    EXPECT_EQ(attached->capacity(), 8192u);
+}
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+
+#include "shared_memory/shared_memory.hpp"
+#include "shared_memory/window.hpp"
+
+#include <cstring>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+using shm_type = shared_memory::shared_memory;
+
+std::string unique_shm_name() {
+    static int counter = 0;
+    return "/shm_window_test_" + std::to_string(getpid()) + "_" + std::to_string(counter++);
+}
+
+const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+
+void fill_pattern(shm_type& shm) {
+    auto mem = shm.get_memory();
+    for (std::size_t i = 0; i < mem.size(); ++i) {
+        mem[i] = static_cast<std::byte>(i % 251);
+    }
+}
+
+TEST(OpenRangeTest, UnalignedRangeStartsAtOffset) {
+    const std::string name = unique_shm_name();
+    auto owner = shm_type::create(name, 4 * page);
+    ASSERT_TRUE(owner.has_value());
+    fill_pattern(*owner);
+
+    const std::size_t offset = page + 17;
+    auto range = shm_type::open_range(name, offset, 100);
+    ASSERT_TRUE(range.has_value());
+    EXPECT_EQ(range->size(), 100u);
+    EXPECT_EQ(range->get_memory()[0], static_cast<std::byte>(offset % 251));
+    EXPECT_EQ(range->get_memory()[99], static_cast<std::byte>((offset + 99) % 251));
+}
+
+TEST(OpenRangeTest, RangeWritesAreVisibleInFullMapping) {
+    const std::string name = unique_shm_name();
+    auto owner = shm_type::create(name, 2 * page);
+    ASSERT_TRUE(owner.has_value());
+
+    {
+        auto range = shm_type::open_range(name, page + 3, 5);
+        ASSERT_TRUE(range.has_value());
+        ASSERT_TRUE(range->write(0, std::span<const std::byte>(reinterpret_cast<const std::byte*>("hello"), 5)));
+    }
+
+    EXPECT_EQ(0, std::memcmp(owner->get_memory().data() + page + 3, "hello", 5));
+}
+
+TEST(OpenRangeTest, OutOfBoundsRangeFails) {
+    const std::string name = unique_shm_name();
+    auto owner = shm_type::create(name, page);
+    ASSERT_TRUE(owner.has_value());
+
+    auto past_end = shm_type::open_range(name, page - 10, 11);
+    ASSERT_FALSE(past_end.has_value());
+    EXPECT_EQ(past_end.error().kind(), shared_memory::errc::map_failed);
+
+    EXPECT_FALSE(shm_type::open_range(name, 0, 0).has_value());
+}
+
+TEST(WindowTest, SeekRemapsAndExposesSegmentBytes) {
+    const std::string name = unique_shm_name();
+    auto owner = shm_type::create(name, 8 * page);
+    ASSERT_TRUE(owner.has_value());
+    fill_pattern(*owner);
+
+    auto win = shared_memory::window::open(name, page);
+    ASSERT_TRUE(win.has_value());
+    EXPECT_EQ(win->segment_size(), 8 * page);
+    EXPECT_EQ(win->get_memory().size(), page);
+
+    const std::size_t offset = 5 * page + 123;
+    auto view = win->seek(offset);
+    ASSERT_TRUE(view.has_value());
+    EXPECT_EQ(view->size(), page);
+    EXPECT_EQ(win->offset(), offset);
+    EXPECT_EQ((*view)[0], static_cast<std::byte>(offset % 251));
+    EXPECT_EQ((*view)[page - 1], static_cast<std::byte>((offset + page - 1) % 251));
+}
+
+TEST(WindowTest, SmallForwardSeeksReuseMapping) {
+    const std::string name = unique_shm_name();
+    auto owner = shm_type::create(name, 4 * page);
+    ASSERT_TRUE(owner.has_value());
+    fill_pattern(*owner);
+
+    auto win = shared_memory::window::open(name, page);
+    ASSERT_TRUE(win.has_value());
+
+    /* The mapping only moves when a seek remaps, so count changes of (view - offset). */
+    const std::byte *mapping = win->get_memory().data();
+    int remaps = 0;
+    for (std::size_t i = 1; i <= 500; ++i) {
+        const std::size_t offset = i * 8;
+        auto view = win->seek(offset);
+        ASSERT_TRUE(view.has_value());
+        ASSERT_EQ((*view)[0], static_cast<std::byte>(offset % 251));
+        if (view->data() - offset != mapping) {
+            mapping = view->data() - offset;
+            ++remaps;
+        }
+    }
+    EXPECT_LE(remaps, 1);
+}
+
+TEST(WindowTest, ViewIsClippedAtSegmentEnd) {
+    const std::string name = unique_shm_name();
+    auto owner = shm_type::create(name, 2 * page);
+    ASSERT_TRUE(owner.has_value());
+
+    auto win = shared_memory::window::open(name, page);
+    ASSERT_TRUE(win.has_value());
+
+    auto tail = win->seek(2 * page - 10);
+    ASSERT_TRUE(tail.has_value());
+    EXPECT_EQ(tail->size(), 10u);
+
+    auto end = win->seek(2 * page);
+    ASSERT_TRUE(end.has_value());
+    EXPECT_TRUE(end->empty());
+
+    EXPECT_FALSE(win->seek(2 * page + 1).has_value());
+}
+
+TEST(WindowTest, OpenNonExistentFails) {
+    auto result = shared_memory::window::open("/nonexistent_shm_window_segment_12345", 4096);
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().kind(), shared_memory::errc::open_failed);
+}
+
+} // namespace